@@ -127,6 +127,32 @@ typedef enum roc_resampler_profile {
     ROC_RESAMPLER_LOW = 3
 } roc_resampler_profile;
 
+/** Memory allocator. */
+typedef enum roc_allocator {
+    /** Default allocator.
+     * Current default is @c ROC_ALLOCATOR_HEAP.
+     */
+    ROC_ALLOCATOR_DEFAULT = 0,
+
+    /** Heap allocator.
+     * Every pool chunk and pipeline object is allocated separately from the heap.
+     */
+    ROC_ALLOCATOR_HEAP = 1,
+
+    /** Arena allocator.
+     * Memory is allocated from a few large regions mapped directly from the system.
+     * A region is returned to the system when all memory allocated from it is freed.
+     */
+    ROC_ALLOCATOR_ARENA = 2,
+
+    /** Arena allocator backed by huge pages.
+     * Same as @c ROC_ALLOCATOR_ARENA, but tries to back regions with huge pages,
+     * either preallocated or transparent, to reduce TLB pressure. Falls back to
+     * normal pages if huge pages are not available.
+     */
+    ROC_ALLOCATOR_ARENA_HUGE_PAGES = 3
+} roc_allocator;
+
 /** Context configuration.
  * @see roc_context
  */
@@ -144,6 +170,50 @@ typedef struct roc_context_config {
      * If zero, default value is used.
      */
     unsigned int max_frame_size;
+
+    /** Memory allocator to use.
+     * Defines where packets, frames, and pipeline objects are allocated from.
+     * If zero, default value is used.
+     */
+    roc_allocator allocator;
+
+    /** Size in bytes of a memory region allocated by arena allocator.
+     * Used if some arena allocator is selected. Memory blocks larger than this
+     * are allocated in dedicated regions.
+     * If zero, default value is used.
+     */
+    unsigned int arena_region_size;
+
+    /** Number of network threads.
+     * Every network thread runs its own event loop. Sender and receiver ports
+     * are distributed between network threads.
+     * If zero, default value is used.
+     */
+    unsigned int num_network_threads;
+
+    /** Number of sockets per receiver port.
+     * If greater than one, every receiver port is bound by this number of sockets
+     * using SO_REUSEPORT, handled by different network threads. Packets of the
+     * same sender are always received by the same socket. Should not exceed
+     * num_network_threads. Ignored if SO_REUSEPORT is not supported.
+     * If zero, default value is used.
+     */
+    unsigned int num_receiver_shards;
+
+    /** Enable direct sending.
+     * If non-zero, senders write packets to the network from the thread that
+     * calls the sender write operation, and pass packets to the network thread
+     * only if the socket buffer is full. This removes a thread switch from every
+     * packet, but moves the cost of sending to the writing thread.
+     */
+    unsigned int direct_send;
+
+    /** Enable kernel receive timestamps.
+     * If non-zero, receivers request the arrival time of every packet from the
+     * kernel and use it to measure interarrival jitter of sessions. This adds a
+     * small per-packet cost. If zero, session jitter is not measured.
+     */
+    unsigned int receive_timestamps;
 } roc_context_config;
 
 /** Sender configuration.
@@ -313,6 +383,35 @@ typedef struct roc_receiver_config {
      * @see broken_playback_timeout.
      */
     unsigned long long breakage_detection_window;
+
+    /** Route packets in network threads.
+     * If non-zero, received packets are parsed and routed to sessions in the
+     * network threads, and the thread calling the receiver read operation only
+     * passes already routed packets to session pipelines. If zero, packets are
+     * parsed and routed in the reading thread.
+     */
+    unsigned int route_on_write;
+
+    /** Maximum number of received packets not yet fetched by the receiver.
+     * When the limit is reached, new packets are dropped. When more than half of
+     * the limit is reached, repair packets are dropped before they are routed to
+     * sessions, so that source packets are handled first.
+     * If zero, default value is used.
+     */
+    unsigned int max_queued_packets;
+
+    /** Session jitter queue size, number of packets.
+     * Should be a power of two. Packets that are further than this number of
+     * seqnums from the oldest queued packet cause the oldest packets to be dropped.
+     * If zero, default value is used.
+     */
+    unsigned int jitter_queue_size;
+
+    /** Session repair queue size, number of packets.
+     * When the queue is full, the oldest repair packet is dropped.
+     * If zero, default value is used.
+     */
+    unsigned int repair_queue_size;
 } roc_receiver_config;
 
 #ifdef __cplusplus
@@ -11,6 +11,7 @@
 #include "roc_audio/resampler_profile.h"
 #include "roc_core/log.h"
 #include "roc_core/stddefs.h"
+#include "roc_packet/jitter_queue.h"
 
 using namespace roc;
 
@@ -27,6 +28,48 @@ bool make_context_config(roc_context_config& out, const roc_context_config& in)
         out.max_frame_size = 4096;
     }
 
+    switch ((int)in.allocator) {
+    case ROC_ALLOCATOR_DEFAULT:
+    case ROC_ALLOCATOR_HEAP:
+        out.allocator = ROC_ALLOCATOR_HEAP;
+        break;
+    case ROC_ALLOCATOR_ARENA:
+    case ROC_ALLOCATOR_ARENA_HUGE_PAGES:
+        out.allocator = in.allocator;
+        break;
+    default:
+        roc_log(LogError, "roc_config: invalid allocator");
+        return false;
+    }
+
+    if (in.arena_region_size != 0) {
+        out.arena_region_size = in.arena_region_size;
+    } else {
+        out.arena_region_size = 2 * 1024 * 1024;
+    }
+
+    if (in.num_network_threads != 0) {
+        out.num_network_threads = in.num_network_threads;
+    } else {
+        out.num_network_threads = 1;
+    }
+
+    if (in.num_receiver_shards != 0) {
+        out.num_receiver_shards = in.num_receiver_shards;
+    } else {
+        out.num_receiver_shards = 1;
+    }
+
+    if (out.num_receiver_shards > out.num_network_threads) {
+        roc_log(LogError,
+                "roc_config: invalid num_receiver_shards: should not exceed"
+                " num_network_threads");
+        return false;
+    }
+
+    out.direct_send = in.direct_send;
+    out.receive_timestamps = in.receive_timestamps;
+
     return true;
 }
 
@@ -210,6 +253,26 @@ bool make_receiver_config(pipeline::ReceiverConfig& out, const roc_receiver_conf
             (core::nanoseconds_t)in.breakage_detection_window;
     }
 
+    out.common.route_on_write = (in.route_on_write != 0);
+
+    if (in.max_queued_packets != 0) {
+        out.common.max_queued_packets = in.max_queued_packets;
+    }
+
+    if (in.jitter_queue_size != 0) {
+        if (!packet::JitterQueue::valid_capacity(in.jitter_queue_size)) {
+            roc_log(LogError, "roc_config: invalid jitter_queue_size:"
+                              " should be a power of two not greater than %lu",
+                    (unsigned long)packet::JitterQueue::MaxCapacity);
+            return false;
+        }
+        out.default_session.jitter_queue_size = in.jitter_queue_size;
+    }
+
+    if (in.repair_queue_size != 0) {
+        out.default_session.repair_queue_size = in.repair_queue_size;
+    }
+
     return true;
 }
 
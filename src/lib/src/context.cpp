@@ -8,15 +8,38 @@
 
 #include "private.h"
 
+#include "roc_core/atomic_ops.h"
 #include "roc_core/log.h"
 
 using namespace roc;
 
+namespace {
+
+netio::TransceiverConfig make_transceiver_config(const roc_context_config& cfg) {
+    netio::TransceiverConfig trx_config;
+
+    trx_config.num_loops = cfg.num_network_threads;
+    trx_config.num_receiver_shards = cfg.num_receiver_shards;
+    trx_config.direct_send = (cfg.direct_send != 0);
+    trx_config.receive_timestamps = (cfg.receive_timestamps != 0);
+
+    return trx_config;
+}
+
+} // namespace
+
 roc_context::roc_context(const roc_context_config& cfg)
-    : packet_pool(allocator, false)
-    , byte_buffer_pool(allocator, cfg.max_packet_size, false)
+    : arena_allocator(cfg.arena_region_size,
+                      cfg.allocator == ROC_ALLOCATOR_ARENA_HUGE_PAGES)
+    , allocator(cfg.allocator == ROC_ALLOCATOR_HEAP
+                    ? (core::IAllocator&)heap_allocator
+                    : (core::IAllocator&)arena_allocator)
+    , packet_pool(allocator, false)
+    , byte_buffer_pool(
+          allocator, cfg.max_packet_size + netio::Transceiver::buffer_overhead(), false)
     , sample_buffer_pool(allocator, cfg.max_frame_size / sizeof(audio::sample_t), false)
-    , trx(packet_pool, byte_buffer_pool, allocator)
+    , trx(make_transceiver_config(cfg), packet_pool, byte_buffer_pool, allocator,
+          &sample_buffer_pool)
     , counter(0) {
 }
 
@@ -56,9 +79,10 @@ int roc_context_close(roc_context* context) {
         return -1;
     }
 
-    if (context->counter != 0) {
+    const long counter = core::AtomicOps::load_acquire(context->counter);
+    if (counter != 0) {
         roc_log(LogError, "roc_context_close: context is still in use: counter=%lu",
-                (unsigned long)context->counter);
+                (unsigned long)counter);
         return -1;
     }
 
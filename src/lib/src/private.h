@@ -15,7 +15,7 @@
 #include "roc/sender.h"
 
 #include "roc_audio/units.h"
-#include "roc_core/atomic.h"
+#include "roc_core/arena_allocator.h"
 #include "roc_core/buffer_pool.h"
 #include "roc_core/heap_allocator.h"
 #include "roc_core/mutex.h"
@@ -45,7 +45,10 @@ bool make_port_config(roc::pipeline::PortConfig& out,
 struct roc_context {
     roc_context(const roc_context_config& cfg);
 
-    roc::core::HeapAllocator allocator;
+    roc::core::HeapAllocator heap_allocator;
+    roc::core::ArenaAllocator arena_allocator;
+
+    roc::core::IAllocator& allocator;
 
     roc::packet::PacketPool packet_pool;
     roc::core::BufferPool<uint8_t> byte_buffer_pool;
@@ -53,7 +56,7 @@ struct roc_context {
 
     roc::netio::Transceiver trx;
 
-    roc::core::Atomic counter;
+    long counter;
 };
 
 struct roc_sender {
@@ -8,6 +8,7 @@
 
 #include "private.h"
 
+#include "roc_core/atomic_ops.h"
 #include "roc_core/log.h"
 #include "roc_pipeline/port_to_str.h"
 
@@ -69,7 +70,7 @@ roc_receiver* roc_receiver_open(roc_context* context, const roc_receiver_config*
         return NULL;
     }
 
-    ++context->counter;
+    core::AtomicOps::fetch_add_relaxed(context->counter, 1);
 
     return receiver.release();
 }
@@ -162,7 +163,7 @@ int roc_receiver_close(roc_receiver* receiver) {
 
     receiver->receiver.iterate_ports(receiver_close_port, receiver);
     receiver->context.allocator.destroy(*receiver);
-    --context.counter;
+    core::AtomicOps::fetch_sub_release(context.counter, 1);
 
     roc_log(LogInfo, "roc_receiver: closed receiver");
 
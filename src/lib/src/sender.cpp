@@ -8,6 +8,7 @@
 
 #include "private.h"
 
+#include "roc_core/atomic_ops.h"
 #include "roc_core/log.h"
 #include "roc_packet/address_to_str.h"
 #include "roc_pipeline/port_to_str.h"
@@ -149,7 +150,7 @@ roc_sender* roc_sender_open(roc_context* context, const roc_sender_config* confi
         return NULL;
     }
 
-    ++context->counter;
+    core::AtomicOps::fetch_add_relaxed(context->counter, 1);
 
     return sender;
 }
@@ -310,7 +311,7 @@ int roc_sender_close(roc_sender* sender) {
     roc_context& context = sender->context;
 
     sender->context.allocator.destroy(*sender);
-    --context.counter;
+    core::AtomicOps::fetch_sub_release(context.counter, 1);
 
     roc_log(LogInfo, "roc_sender: closed sender");
 
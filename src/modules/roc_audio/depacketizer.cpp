@@ -61,6 +61,22 @@ packet::timestamp_t Depacketizer::timestamp() const {
     return timestamp_;
 }
 
+void Depacketizer::reset() {
+    if (packet_) {
+        payload_decoder_.end();
+        packet_ = NULL;
+    }
+
+    timestamp_ = 0;
+
+    zero_samples_ = 0;
+    missing_samples_ = 0;
+    packet_samples_ = 0;
+
+    first_packet_ = true;
+    dropped_packets_ = 0;
+}
+
 void Depacketizer::read(Frame& frame) {
     const size_t prev_dropped_packets = dropped_packets_;
     const packet::timestamp_t prev_packet_samples = packet_samples_;
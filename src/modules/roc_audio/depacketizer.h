@@ -51,6 +51,11 @@ public:
     //!  started() should return true
     packet::timestamp_t timestamp() const;
 
+    //! Reset to initial state.
+    //! @remarks
+    //!  Releases the current packet and waits for the first packet again.
+    void reset();
+
 private:
     void read_frame_(Frame& frame);
 
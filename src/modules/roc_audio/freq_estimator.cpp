@@ -50,14 +50,26 @@ FreqEstimator::FreqEstimator(packet::timestamp_t target_latency)
     if (fe_decim_len % 2 != 0) {
         roc_panic("freq estimator: decim_len should be power of two");
     }
+    reset();
+}
+
+float FreqEstimator::freq_coeff() const {
+    return coeff_;
+}
+
+void FreqEstimator::reset() {
     for (size_t i = 0; i < fe_decim_len; i++) {
         dec1_casc_buff_[i] = target_;
         dec2_casc_buff_[i] = target_;
     }
-}
 
-float FreqEstimator::freq_coeff() const {
-    return coeff_;
+    dec1_ind_ = 0;
+    dec2_ind_ = 0;
+
+    samples_counter_ = 0;
+    accum_ = 0;
+
+    coeff_ = 1;
 }
 
 void FreqEstimator::update(packet::timestamp_t current) {
@@ -35,6 +35,9 @@ public:
     //! Compute new value of frequency coefficient.
     void update(packet::timestamp_t current_latency);
 
+    //! Reset to initial state.
+    void reset();
+
 private:
     bool run_decimators_(packet::timestamp_t current, float& filtered);
     float run_controller_(float current);
@@ -19,7 +19,7 @@ const core::nanoseconds_t LogInterval = 5 * core::Second;
 
 } // namespace
 
-LatencyMonitor::LatencyMonitor(const packet::SortedQueue& queue,
+LatencyMonitor::LatencyMonitor(const packet::JitterQueue& queue,
                                const Depacketizer& depacketizer,
                                ResamplerReader* resampler,
                                const LatencyMonitorConfig& config,
@@ -158,6 +158,22 @@ float LatencyMonitor::trim_scaling_(float freq_coeff) const {
     return freq_coeff;
 }
 
+void LatencyMonitor::reset() {
+    roc_panic_if_not(valid());
+
+    fe_.reset();
+
+    update_pos_ = 0;
+    has_update_pos_ = false;
+
+    if (resampler_) {
+        if (!resampler_->set_scaling(sample_rate_coeff_)) {
+            roc_panic("latency monitor: scaling factor out of bounds: scaling=%.5f",
+                      (double)sample_rate_coeff_);
+        }
+    }
+}
+
 bool LatencyMonitor::init_resampler_(size_t input_sample_rate,
                                      size_t output_sample_rate) {
     if (input_sample_rate == 0 || output_sample_rate == 0) {
@@ -18,7 +18,7 @@
 #include "roc_core/noncopyable.h"
 #include "roc_core/rate_limiter.h"
 #include "roc_core/time.h"
-#include "roc_packet/sorted_queue.h"
+#include "roc_packet/jitter_queue.h"
 #include "roc_packet/units.h"
 
 namespace roc {
@@ -68,7 +68,7 @@ public:
     //!  - @p target_latency defines FreqEstimator target latency, in samples
     //!  - @p input_sample_rate is the sample rate of the input packets
     //!  - @p output_sample_rate is the sample rate of the output frames
-    LatencyMonitor(const packet::SortedQueue& queue,
+    LatencyMonitor(const packet::JitterQueue& queue,
                    const Depacketizer& depacketizer,
                    ResamplerReader* resampler,
                    const LatencyMonitorConfig& config,
@@ -84,6 +84,12 @@ public:
     //!  false if the session should be terminated.
     bool update(packet::timestamp_t time);
 
+    //! Reset to initial state.
+    //! @remarks
+    //!  Should be called after resetting the resampler, since it sets the
+    //!  initial resampler scaling again.
+    void reset();
+
 private:
     bool get_latency_(packet::timestamp_diff_t& latency) const;
     bool check_latency_(packet::timestamp_diff_t latency) const;
@@ -95,7 +101,7 @@ private:
 
     void report_latency_(packet::timestamp_t latency);
 
-    const packet::SortedQueue& queue_;
+    const packet::JitterQueue& queue_;
     const Depacketizer& depacketizer_;
     ResamplerReader* resampler_;
     FreqEstimator fe_;
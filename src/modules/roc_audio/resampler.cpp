@@ -228,6 +228,20 @@ bool Resampler::check_config_() const {
     return true;
 }
 
+void Resampler::reset() {
+    prev_frame_ = NULL;
+    curr_frame_ = NULL;
+    next_frame_ = NULL;
+
+    out_frame_pos_ = 0;
+
+    scaling_ = 1.0;
+    qt_half_window_size_ = float_to_fixedpoint((float)window_size_ / scaling_);
+
+    qt_sample_ = float_to_fixedpoint(0);
+    qt_dt_ = 0;
+}
+
 void Resampler::renew_buffers(core::Slice<sample_t>& prev,
                               core::Slice<sample_t>& cur,
                               core::Slice<sample_t>& next) {
@@ -73,6 +73,12 @@ public:
                        core::Slice<sample_t>& cur,
                        core::Slice<sample_t>& next);
 
+    //! Reset to initial state.
+    //! @remarks
+    //!  Forgets the current buffers and position and resets scaling to 1.
+    //!  Keeps the sinc table.
+    void reset();
+
 private:
     typedef uint32_t fixedpoint_t;
     typedef uint64_t long_fixedpoint_t;
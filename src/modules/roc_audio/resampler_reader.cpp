@@ -57,6 +57,13 @@ void ResamplerReader::read(Frame& frame) {
     }
 }
 
+void ResamplerReader::reset() {
+    roc_panic_if_not(valid());
+
+    resampler_.reset();
+    frames_empty_ = true;
+}
+
 bool ResamplerReader::init_frames_(core::BufferPool<sample_t>& buffer_pool) {
     for (size_t n = 0; n < ROC_ARRAY_SIZE(frames_); n++) {
         frames_[n] = new (buffer_pool) core::Buffer<sample_t>(buffer_pool);
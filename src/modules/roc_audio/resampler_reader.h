@@ -61,6 +61,11 @@ public:
     //!  function returns false.
     bool set_scaling(float);
 
+    //! Reset to initial state.
+    //! @remarks
+    //!  Keeps allocated buffers and the resampler sinc table.
+    void reset();
+
 private:
     bool init_frames_(core::BufferPool<sample_t>&);
     void renew_frames_();
@@ -114,6 +114,19 @@ bool Watchdog::update() {
     return true;
 }
 
+void Watchdog::reset() {
+    curr_read_pos_ = 0;
+    last_pos_before_blank_ = 0;
+    last_pos_before_drops_ = 0;
+
+    curr_window_flags_ = 0;
+
+    status_pos_ = 0;
+    status_show_ = false;
+
+    alive_ = true;
+}
+
 void Watchdog::update_blank_timeout_(const Frame& frame,
                                      packet::timestamp_t next_read_pos) {
     if (max_blank_duration_ == 0) {
@@ -86,6 +86,11 @@ public:
     //!  filled and contain dropped packets was exceeded.
     bool update();
 
+    //! Reset to initial state.
+    //! @remarks
+    //!  Restarts timeouts and makes the stream alive again.
+    void reset();
+
 private:
     void update_blank_timeout_(const Frame& frame, packet::timestamp_t next_read_pos);
     bool check_blank_timeout_() const;
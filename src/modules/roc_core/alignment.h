@@ -44,6 +44,17 @@ inline size_t padding(size_t size, size_t alignment) {
     return (new_size - size);
 }
 
+//! Cache line size.
+//! @remarks
+//!  Data modified by different threads should be placed on different cache
+//!  lines to avoid false sharing.
+enum { CacheLineSize = 64 };
+
+//! Adjust the given size to be cache line aligned.
+inline size_t cache_line_align(size_t sz) {
+    return sz + padding(sz, CacheLineSize);
+}
+
 } // namespace core
 } // namespace roc
 
@@ -12,6 +12,8 @@
 #ifndef ROC_CORE_BUFFER_H_
 #define ROC_CORE_BUFFER_H_
 
+#include "roc_core/alignment.h"
+#include "roc_core/attributes.h"
 #include "roc_core/buffer_pool.h"
 #include "roc_core/refcnt.h"
 #include "roc_core/stddefs.h"
@@ -20,7 +22,12 @@ namespace roc {
 namespace core {
 
 //! Buffer.
-template <class T> class Buffer : public RefCnt<Buffer<T> > {
+//! @remarks
+//!  The buffer header is cache line aligned, so that the reference counter,
+//!  which is modified by every thread holding the buffer, and the data never
+//!  share a cache line.
+template <class T>
+class ROC_ATTR_ALIGNED(CacheLineSize) Buffer : public RefCnt<Buffer<T> > {
 public:
     //! Initialize empty buffer.
     explicit Buffer(BufferPool<T>& pool)
@@ -23,8 +23,13 @@ template <class T> class Buffer;
 template <class T> class BufferPool : public Pool<Buffer<T> > {
 public:
     //! Initialization.
+    //! @remarks
+    //!  Buffers are cache line aligned.
     BufferPool(IAllocator& allocator, size_t buff_size, bool poison)
-        : Pool<Buffer<T> >(allocator, sizeof(Buffer<T>) + sizeof(T) * buff_size, poison)
+        : Pool<Buffer<T> >(allocator,
+                           sizeof(Buffer<T>) + sizeof(T) * buff_size,
+                           poison,
+                           CacheLineSize)
         , buff_size_(buff_size) {
     }
 
@@ -0,0 +1,260 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_core/hashmap.h
+//! @brief Intrusive hash table.
+
+#ifndef ROC_CORE_HASHMAP_H_
+#define ROC_CORE_HASHMAP_H_
+
+#include "roc_core/hashmap_node.h"
+#include "roc_core/hashsum.h"
+#include "roc_core/iallocator.h"
+#include "roc_core/log.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/ownership.h"
+#include "roc_core/panic.h"
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace core {
+
+//! Intrusive hash table.
+//!
+//! Elements are linked into buckets using the HashmapNode data, so inserting
+//! and removing an element doesn't allocate memory, except when the bucket
+//! array grows. Finding, inserting and removing take constant time on average.
+//!
+//! An element may be a member of a List and a Hashmap at the same time, but
+//! can be a member of only one Hashmap.
+//!
+//! @tparam T defines object type, it should inherit HashmapNode and provide
+//! the following methods:
+//!  - key() const, which returns the element key
+//!  - static key_hash(key), which returns hashsum_t for a key
+//!  - static key_equal(key1, key2), which returns true if keys are equal
+//!
+//! @tparam Ownership defines ownership policy which is used to acquire an
+//! element ownership when it's added to the hashmap and release ownership when
+//! it's removed from the hashmap.
+template <class T, template <class TT> class Ownership = RefCntOwnership>
+class Hashmap : public NonCopyable<> {
+public:
+    //! Pointer type.
+    //! @remarks
+    //!  either raw or smart pointer depending on the ownership policy.
+    typedef typename Ownership<T>::Pointer Pointer;
+
+    //! Initialize empty hashmap.
+    //! @remarks
+    //!  The bucket array is allocated when the first element is inserted.
+    explicit Hashmap(IAllocator& allocator)
+        : allocator_(allocator)
+        , buckets_(NULL)
+        , n_buckets_(0)
+        , size_(0) {
+    }
+
+    //! Release ownership of containing objects.
+    ~Hashmap() {
+        for (size_t n = 0; n < n_buckets_; n++) {
+            HashmapNode::HashmapData* next_data;
+
+            for (HashmapNode::HashmapData* data = buckets_[n]; data; data = next_data) {
+                check_is_member_(data);
+
+                next_data = data->next;
+                data->next = NULL;
+                data->map = NULL;
+
+                Ownership<T>::release(*container_of_(data));
+            }
+        }
+
+        if (buckets_) {
+            allocator_.deallocate(buckets_);
+        }
+    }
+
+    //! Get number of elements in hashmap.
+    size_t size() const {
+        return size_;
+    }
+
+    //! Check if element is a member of hashmap.
+    bool contains(const T& element) const {
+        return element.hashmap_data()->map == this;
+    }
+
+    //! Find element by key.
+    //! @returns
+    //!  element with given key or NULL if there is no such element.
+    template <class Key> Pointer find(const Key& key) const {
+        return find_borrowed(key);
+    }
+
+    //! Find element by key without acquiring ownership.
+    //! @returns
+    //!  element with given key or NULL if there is no such element.
+    //! @remarks
+    //!  Same as find(), but returns a raw pointer. The pointer remains valid
+    //!  only while the element is a member of the hashmap.
+    template <class Key> T* find_borrowed(const Key& key) const {
+        if (size_ == 0) {
+            return NULL;
+        }
+
+        const hashsum_t hash = T::key_hash(key);
+
+        for (HashmapNode::HashmapData* data = buckets_[bucket_(hash, n_buckets_)]; data;
+             data = data->next) {
+            if (data->hash != hash) {
+                continue;
+            }
+
+            T* element = container_of_(data);
+            if (T::key_equal(element->key(), key)) {
+                return element;
+            }
+        }
+
+        return NULL;
+    }
+
+    //! Insert element into hashmap.
+    //! @returns
+    //!  false if the bucket array should grow but memory can't be allocated.
+    //! @remarks
+    //!  Acquires ownership of @p element.
+    //! @pre
+    //!  @p element should not be member of any hashmap, and there should be
+    //!  no element with the same key.
+    bool insert(T& element) {
+        HashmapNode::HashmapData* data = element.hashmap_data();
+
+        if (data->map != NULL) {
+            roc_panic("hashmap: element is already member of a hashmap");
+        }
+
+        if (find_borrowed(element.key())) {
+            roc_panic("hashmap: element with the same key is already in hashmap");
+        }
+
+        if (size_ >= n_buckets_ && !grow_()) {
+            return false;
+        }
+
+        data->hash = T::key_hash(element.key());
+        data->map = this;
+
+        HashmapNode::HashmapData*& bucket = buckets_[bucket_(data->hash, n_buckets_)];
+        data->next = bucket;
+        bucket = data;
+
+        size_++;
+
+        Ownership<T>::acquire(element);
+
+        return true;
+    }
+
+    //! Remove element from hashmap.
+    //! @remarks
+    //!  Releases ownership of @p element.
+    //! @pre
+    //!  @p element should be member of this hashmap.
+    void remove(T& element) {
+        HashmapNode::HashmapData* data = element.hashmap_data();
+        check_is_member_(data);
+
+        HashmapNode::HashmapData** link = &buckets_[bucket_(data->hash, n_buckets_)];
+        while (*link != data) {
+            roc_panic_if(*link == NULL);
+            link = &(*link)->next;
+        }
+        *link = data->next;
+
+        data->next = NULL;
+        data->map = NULL;
+
+        size_--;
+
+        Ownership<T>::release(element);
+    }
+
+private:
+    enum { MinBuckets = 16 };
+
+    static size_t bucket_(hashsum_t hash, size_t n_buckets) {
+        return hash & (n_buckets - 1);
+    }
+
+    static T* container_of_(HashmapNode::HashmapData* data) {
+        return static_cast<T*>(data->container_of());
+    }
+
+    void check_is_member_(const HashmapNode::HashmapData* data) const {
+        if (data->map != this) {
+            roc_panic("hashmap: element is member of another hashmap:"
+                      " expected=%p actual=%p",
+                      (const void*)this, (const void*)data->map);
+        }
+    }
+
+    bool grow_() {
+        const size_t new_n_buckets =
+            n_buckets_ == 0 ? (size_t)MinBuckets : n_buckets_ * 2;
+
+        HashmapNode::HashmapData** new_buckets = (HashmapNode::HashmapData**)
+            allocator_.allocate(new_n_buckets * sizeof(HashmapNode::HashmapData*));
+
+        if (!new_buckets) {
+            roc_log(LogError, "hashmap: can't allocate buckets: n_buckets=%lu",
+                    (unsigned long)new_n_buckets);
+            return false;
+        }
+
+        for (size_t n = 0; n < new_n_buckets; n++) {
+            new_buckets[n] = NULL;
+        }
+
+        for (size_t n = 0; n < n_buckets_; n++) {
+            HashmapNode::HashmapData* next_data;
+
+            for (HashmapNode::HashmapData* data = buckets_[n]; data; data = next_data) {
+                next_data = data->next;
+
+                HashmapNode::HashmapData*& bucket =
+                    new_buckets[bucket_(data->hash, new_n_buckets)];
+                data->next = bucket;
+                bucket = data;
+            }
+        }
+
+        if (buckets_) {
+            allocator_.deallocate(buckets_);
+        }
+
+        buckets_ = new_buckets;
+        n_buckets_ = new_n_buckets;
+
+        return true;
+    }
+
+    IAllocator& allocator_;
+
+    HashmapNode::HashmapData** buckets_;
+    size_t n_buckets_;
+
+    size_t size_;
+};
+
+} // namespace core
+} // namespace roc
+
+#endif // ROC_CORE_HASHMAP_H_
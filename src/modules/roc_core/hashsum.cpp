@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_core/hashsum.h"
+
+namespace roc {
+namespace core {
+
+namespace {
+
+// FNV-1a parameters for 32-bit and 64-bit hashes
+const hashsum_t OffsetBasis =
+    sizeof(hashsum_t) == 8 ? (hashsum_t)0xcbf29ce484222325ull : (hashsum_t)0x811c9dc5ul;
+
+const hashsum_t Prime =
+    sizeof(hashsum_t) == 8 ? (hashsum_t)0x100000001b3ull : (hashsum_t)0x01000193ul;
+
+} // namespace
+
+hashsum_t hashsum_mem(const void* data, size_t size) {
+    hashsum_t hash = OffsetBasis;
+    hashsum_add(hash, data, size);
+    return hash;
+}
+
+void hashsum_add(hashsum_t& hash, const void* data, size_t size) {
+    const uint8_t* bytes = (const uint8_t*)data;
+
+    for (size_t n = 0; n < size; n++) {
+        hash ^= bytes[n];
+        hash *= Prime;
+    }
+}
+
+} // namespace core
+} // namespace roc
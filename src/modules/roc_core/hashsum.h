@@ -0,0 +1,35 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_core/hashsum.h
+//! @brief Hash sum.
+
+#ifndef ROC_CORE_HASHSUM_H_
+#define ROC_CORE_HASHSUM_H_
+
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace core {
+
+//! Hash type.
+typedef size_t hashsum_t;
+
+//! Compute hash of a memory block.
+hashsum_t hashsum_mem(const void* data, size_t size);
+
+//! Add memory block to hash.
+//! @remarks
+//!  Can be used to compute hash of several separate blocks. The result is
+//!  the same as if the blocks were concatenated and passed to hashsum_mem().
+void hashsum_add(hashsum_t& hash, const void* data, size_t size);
+
+} // namespace core
+} // namespace roc
+
+#endif // ROC_CORE_HASHSUM_H_
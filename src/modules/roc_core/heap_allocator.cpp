@@ -7,32 +7,37 @@
  */
 
 #include "roc_core/heap_allocator.h"
+#include "roc_core/atomic_ops.h"
 
 namespace roc {
 namespace core {
 
+HeapAllocator::HeapAllocator()
+    : num_allocations_(0) {
+}
+
 HeapAllocator::~HeapAllocator() {
-    if (num_allocations_ != 0) {
+    const long num_allocations = AtomicOps::load_acquire(num_allocations_);
+    if (num_allocations != 0) {
         roc_panic("heap allocator: detected leak, num_allocations=%d",
-                  (int)num_allocations_);
+                  (int)num_allocations);
     }
 }
 
 void* HeapAllocator::allocate(size_t size) {
-    ++num_allocations_;
+    AtomicOps::fetch_add_relaxed(num_allocations_, 1);
     return new char[size];
 }
 
 void HeapAllocator::deallocate(void* ptr) {
-    if (num_allocations_ <= 0) {
+    if (AtomicOps::fetch_sub_release(num_allocations_, 1) <= 0) {
         roc_panic("heap allocator: unpaired deallocate");
     }
-    --num_allocations_;
     delete[](char*) ptr;
 }
 
 size_t HeapAllocator::num_allocations() const {
-    return (size_t)num_allocations_;
+    return (size_t)AtomicOps::load_acquire(num_allocations_);
 }
 
 } // namespace core
@@ -12,7 +12,6 @@
 #ifndef ROC_CORE_HEAP_ALLOCATOR_H_
 #define ROC_CORE_HEAP_ALLOCATOR_H_
 
-#include "roc_core/atomic.h"
 #include "roc_core/iallocator.h"
 #include "roc_core/noncopyable.h"
 
@@ -26,6 +25,7 @@ namespace core {
 //! The memory is always maximum aligned. Thread-safe.
 class HeapAllocator : public IAllocator, public NonCopyable<> {
 public:
+    HeapAllocator();
     ~HeapAllocator();
 
     //! Allocate memory.
@@ -38,7 +38,7 @@ public:
     size_t num_allocations() const;
 
 private:
-    Atomic num_allocations_;
+    long num_allocations_;
 };
 
 } // namespace core
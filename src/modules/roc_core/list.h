@@ -104,6 +104,61 @@ public:
         return container_of_(data->next);
     }
 
+    //! Get first list element without acquiring ownership.
+    //!
+    //! @returns
+    //!  first element or NULL if list is empty.
+    //!
+    //! @remarks
+    //!  Unlike front(), returns a raw pointer even if the list owns its
+    //!  elements, so no reference counting is involved. The pointer remains
+    //!  valid only while the element is a member of the list, so the caller
+    //!  should not remove it and keep using it, and should serialize this
+    //!  call with list modifications.
+    T* front_borrowed() const {
+        if (size_ == 0) {
+            return NULL;
+        }
+        return container_of_(head_.next);
+    }
+
+    //! Get last list element without acquiring ownership.
+    //!
+    //! @returns
+    //!  last element or NULL if list is empty.
+    //!
+    //! @remarks
+    //!  Same as back(), but returns a raw pointer.
+    //!  See front_borrowed() for the pointer lifetime.
+    T* back_borrowed() const {
+        if (size_ == 0) {
+            return NULL;
+        }
+        return container_of_(head_.prev);
+    }
+
+    //! Get list element next to given one without acquiring ownership.
+    //!
+    //! @returns
+    //!  list element following @p element if @p element is not
+    //!  last, or NULL otherwise.
+    //!
+    //! @remarks
+    //!  Same as nextof(), but returns a raw pointer.
+    //!  See front_borrowed() for the pointer lifetime.
+    //!
+    //! @pre
+    //!  @p element should be member of this list.
+    T* nextof_borrowed(T& element) const {
+        ListNode::ListNodeData* data = element.list_node_data();
+        check_is_member_(data, this);
+
+        if (data->next == &head_) {
+            return NULL;
+        }
+        return container_of_(data->next);
+    }
+
     //! Prepend element to list.
     //!
     //! @remarks
@@ -0,0 +1,176 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_core/mpsc_queue.h
+//! @brief Lock-free MPSC queue.
+
+#ifndef ROC_CORE_MPSC_QUEUE_H_
+#define ROC_CORE_MPSC_QUEUE_H_
+
+#include "roc_core/alignment.h"
+#include "roc_core/atomic_ops.h"
+#include "roc_core/attributes.h"
+#include "roc_core/mpsc_queue_node.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/ownership.h"
+#include "roc_core/panic.h"
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace core {
+
+//! Lock-free multi-producer single-consumer intrusive queue.
+//!
+//! Any number of threads may call push_back() concurrently, and only one
+//! thread may call pop_front() and empty(). Pushing is wait-free and costs one
+//! atomic exchange. Popping is lock-free; it never blocks producers, but may
+//! return null if the next element is being pushed concurrently.
+//!
+//! Does not use dynamic memory. Elements are linked using the MpscQueueNode
+//! data, so an element may be a member of a List and an MpscQueue at the
+//! same time, but can be a member of only one MpscQueue.
+//!
+//! @tparam T defines object type, it should inherit MpscQueueNode.
+//!
+//! @tparam Ownership defines ownership policy which is used to acquire an
+//! element ownership when it's added to the queue and release ownership when
+//! it's removed from the queue.
+template <class T, template <class TT> class Ownership = RefCntOwnership>
+class MpscQueue : public NonCopyable<> {
+public:
+    //! Pointer type.
+    //! @remarks
+    //!  either raw or smart pointer depending on the ownership policy.
+    typedef typename Ownership<T>::Pointer Pointer;
+
+    //! Initialize empty queue.
+    MpscQueue()
+        : head_(&stub_)
+        , tail_(&stub_) {
+    }
+
+    //! Release ownership of containing objects.
+    //! @pre
+    //!  Should not be called concurrently with push_back().
+    ~MpscQueue() {
+        while (pop_front()) {
+        }
+    }
+
+    //! Append element to the end of the queue.
+    //! @remarks
+    //!  Acquires ownership of @p element. May be called from any thread.
+    //! @pre
+    //!  @p element should not be member of any MpscQueue.
+    void push_back(T& element) {
+        MpscQueueNode::MpscQueueData* data = element.mpsc_queue_data();
+
+        if (data->queue != NULL) {
+            roc_panic("mpsc queue: element is already member of a queue");
+        }
+        data->queue = this;
+
+        Ownership<T>::acquire(element);
+
+        push_(data);
+    }
+
+    //! Remove first element from the queue.
+    //! @returns
+    //!  the removed element or NULL if the queue is empty or the next element
+    //!  is not completely pushed yet.
+    //! @remarks
+    //!  Releases ownership of the returned element. Should be called only
+    //!  from the consumer thread.
+    Pointer pop_front() {
+        MpscQueueNode::MpscQueueData* tail = tail_;
+        MpscQueueNode::MpscQueueData* next = AtomicOps::load_acquire(tail->next);
+
+        if (tail == &stub_) {
+            if (!next) {
+                return NULL;
+            }
+            tail_ = next;
+            tail = next;
+            next = AtomicOps::load_acquire(next->next);
+        }
+
+        if (next) {
+            tail_ = next;
+            return release_(tail);
+        }
+
+        // a producer has exchanged head but hasn't linked the element yet
+        if (tail != AtomicOps::load_acquire(head_)) {
+            return NULL;
+        }
+
+        // the last element can't be removed until something follows it
+        push_(&stub_);
+
+        next = AtomicOps::load_acquire(tail->next);
+        if (next) {
+            tail_ = next;
+            return release_(tail);
+        }
+
+        return NULL;
+    }
+
+    //! Check if the queue is empty.
+    //! @remarks
+    //!  Returns false if a concurrent push_back() has already started, even if
+    //!  pop_front() can't return the element yet. Should be called only from
+    //!  the consumer thread.
+    bool empty() const {
+        return tail_ == &stub_ && AtomicOps::load_seq_cst(head_) == &stub_;
+    }
+
+private:
+    void push_(MpscQueueNode::MpscQueueData* data) {
+        AtomicOps::store_relaxed(data->next, (MpscQueueNode::MpscQueueData*)NULL);
+
+        MpscQueueNode::MpscQueueData* prev = AtomicOps::exchange_acq_rel(head_, data);
+
+        AtomicOps::store_release(prev->next, data);
+    }
+
+    Pointer release_(MpscQueueNode::MpscQueueData* data) {
+        if (data->queue != this) {
+            roc_panic("mpsc queue: element is member of another queue");
+        }
+        data->queue = NULL;
+
+        T* element = static_cast<T*>(data->container_of());
+
+        Pointer pointer = element;
+        Ownership<T>::release(*element);
+
+        return pointer;
+    }
+
+    // The queue may be allocated without cache line alignment, so the fields
+    // are separated by explicit padding instead of aligned members.
+    char pad1_[CacheLineSize] ROC_ATTR_UNUSED;
+
+    // modified by producers
+    MpscQueueNode::MpscQueueData* head_;
+
+    char pad2_[CacheLineSize] ROC_ATTR_UNUSED;
+
+    // modified by consumer
+    MpscQueueNode::MpscQueueData* tail_;
+    MpscQueueNode::MpscQueueData stub_;
+
+    char pad3_[CacheLineSize] ROC_ATTR_UNUSED;
+};
+
+} // namespace core
+} // namespace roc
+
+#endif // ROC_CORE_MPSC_QUEUE_H_
@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_core/mpsc_queue_node.h
+//! @brief MPSC queue node.
+
+#ifndef ROC_CORE_MPSC_QUEUE_NODE_H_
+#define ROC_CORE_MPSC_QUEUE_NODE_H_
+
+#include "roc_core/helpers.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/panic.h"
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace core {
+
+//! Base class for MPSC queue element.
+//! @remarks
+//!  Object should inherit this class to be able to be a member of MpscQueue.
+class MpscQueueNode : public NonCopyable<MpscQueueNode> {
+public:
+    //! MPSC queue node data.
+    struct MpscQueueData {
+        //! Next queue element.
+        MpscQueueData* next;
+
+        //! The queue this node is member of.
+        //! @remarks
+        //!  NULL if node is not member of any queue.
+        void* queue;
+
+        MpscQueueData()
+            : next(NULL)
+            , queue(NULL) {
+        }
+
+        //! Get MpscQueueNode object that contains this MpscQueueData object.
+        MpscQueueNode* container_of() {
+            return ROC_CONTAINER_OF(this, MpscQueueNode, mpsc_queue_data_);
+        }
+    };
+
+    ~MpscQueueNode() {
+        if (mpsc_queue_data_.queue != NULL) {
+            roc_panic("mpsc queue node: can't call destructor for an element"
+                      " that is still in queue");
+        }
+    }
+
+    //! Get MPSC queue node data.
+    MpscQueueData* mpsc_queue_data() const {
+        return &mpsc_queue_data_;
+    }
+
+private:
+    mutable MpscQueueData mpsc_queue_data_;
+};
+
+} // namespace core
+} // namespace roc
+
+#endif // ROC_CORE_MPSC_QUEUE_NODE_H_
@@ -29,9 +29,12 @@ namespace core {
 //! @tparam T defines object type.
 //!
 //! Allocates chunks from given allocator containing a fixed number of fixed
-//! sized objects. Maintains a list of free objects.
+//! sized objects. Maintains a list of free objects. Every chunk counts its
+//! used objects, so that fully free chunks may be released using trim().
 //!
-//! The memory is always maximum aligned. Thread-safe.
+//! The memory is always maximum aligned. A larger alignment, e.g. CacheLineSize,
+//! may be requested, so that objects used by different threads never share
+//! a cache line. Thread-safe.
 template <class T> class Pool : public NonCopyable<> {
 public:
     //! Initialization.
@@ -40,15 +43,25 @@ public:
     //!  - @p allocator is used to allocate chunks
     //!  - @p object_size defines object size in bytes
     //!  - @p poison enables memory poisoning for debugging
-    Pool(IAllocator& allocator, size_t object_size, bool poison)
+    //!  - @p alignment defines object alignment in bytes; should be a power
+    //!    of two; zero means maximum alignment
+    Pool(IAllocator& allocator, size_t object_size, bool poison, size_t alignment = 0)
         : allocator_(allocator)
         , used_elems_(0)
-        , elem_size_(max_align(std::max(sizeof(Elem), object_size)))
+        , min_free_elems_(0)
+        , alignment_(std::max(alignment, sizeof(MaxAlign)))
+        , elem_size_(align_(std::max(sizeof(Elem), object_size)))
+        , elem_hdr_size_(max_align(sizeof(Chunk*)))
+        , slot_size_(align_(elem_hdr_size_ + elem_size_))
         , chunk_hdr_size_(max_align(sizeof(Chunk)))
         , chunk_n_elems_(1)
         , poison_(poison) {
-        roc_log(LogDebug, "pool: initializing: object_size=%lu poison=%d",
-                (unsigned long)elem_size_, (int)poison);
+        if ((alignment_ & (alignment_ - 1)) != 0) {
+            roc_panic("pool: alignment should be a power of two: alignment=%lu",
+                      (unsigned long)alignment_);
+        }
+        roc_log(LogDebug, "pool: initializing: object_size=%lu alignment=%lu poison=%d",
+                (unsigned long)elem_size_, (unsigned long)alignment_, (int)poison);
     }
 
     ~Pool() {
@@ -57,7 +70,7 @@ public:
 
     //! Allocate new object.
     //! @returns
-    //!  pointer to a maximum aligned uninitialized memory for a new object
+    //!  pointer to an aligned uninitialized memory for a new object
     //!  or NULL if memory can't be allocated.
     void* allocate() {
         Elem* elem = get_elem_();
@@ -98,10 +111,51 @@ public:
         deallocate(&object);
     }
 
+    //! Release fully free chunks to the allocator.
+    //! @remarks
+    //!  Should be called periodically to return memory to the allocator after
+    //!  a peak load. Only objects that stayed free since the previous call are
+    //!  released, i.e. the number of released objects never exceeds the lowest
+    //!  number of free objects seen since then, so that a pool which is
+    //!  repeatedly drained and refilled keeps its chunks. At least one chunk
+    //!  is always kept.
+    //! @returns
+    //!  number of objects in released chunks.
+    size_t trim() {
+        Mutex::Lock lock(mutex_);
+
+        size_t n_released = 0;
+
+        Chunk* chunk = chunks_.front();
+        while (chunk && chunks_.size() > 1) {
+            Chunk* next_chunk = chunks_.nextof(*chunk);
+
+            if (chunk->n_used == 0 && n_released + chunk->n_elems <= min_free_elems_) {
+                n_released += chunk->n_elems;
+                deallocate_chunk_(chunk);
+            }
+
+            chunk = next_chunk;
+        }
+
+        min_free_elems_ = free_elems_.size();
+
+        if (n_released != 0) {
+            roc_log(LogDebug, "pool: trimmed %lu free objects, %lu chunks remaining",
+                    (unsigned long)n_released, (unsigned long)chunks_.size());
+        }
+
+        return n_released;
+    }
+
 private:
     enum { PoisonAllocated = 0x7a, PoisonDeallocated = 0x7d };
 
-    struct Chunk : ListNode {};
+    struct Chunk : ListNode {
+        size_t n_elems;
+        size_t n_used;
+    };
+
     struct Elem : ListNode {};
 
     Elem* get_elem_() {
@@ -114,7 +168,12 @@ private:
         Elem* elem = free_elems_.front();
         if (elem != NULL) {
             free_elems_.remove(*elem);
+            chunk_of_(elem)->n_used++;
             used_elems_++;
+
+            if (free_elems_.size() < min_free_elems_) {
+                min_free_elems_ = free_elems_.size();
+            }
         }
 
         return elem;
@@ -128,26 +187,49 @@ private:
         }
 
         used_elems_--;
+        chunk_of_(elem)->n_used--;
         free_elems_.push_front(*elem);
     }
 
     void allocate_chunk_() {
-        void* memory = allocator_.allocate(chunk_offset_(chunk_n_elems_));
+        // allocator memory is only maximum aligned, reserve space for padding
+        const size_t chunk_size = chunk_hdr_size_ + (alignment_ - sizeof(MaxAlign))
+            + chunk_n_elems_ * slot_size_;
+
+        void* memory = allocator_.allocate(chunk_size);
         if (memory == NULL) {
             return;
         }
 
         Chunk* chunk = new (memory) Chunk;
+        chunk->n_elems = chunk_n_elems_;
+        chunk->n_used = 0;
         chunks_.push_back(*chunk);
 
         for (size_t n = 0; n < chunk_n_elems_; n++) {
-            Elem* elem = new ((char*)chunk + chunk_offset_(n)) Elem;
+            Elem* elem = new (elem_memory_(chunk, n)) Elem;
+            *(Chunk**)((char*)elem - elem_hdr_size_) = chunk;
+
             free_elems_.push_back(*elem);
         }
 
         chunk_n_elems_ *= 2;
     }
 
+    void deallocate_chunk_(Chunk* chunk) {
+        for (size_t n = 0; n < chunk->n_elems; n++) {
+            Elem* elem = (Elem*)elem_memory_(chunk, n);
+            free_elems_.remove(*elem);
+        }
+
+        chunks_.remove(*chunk);
+        allocator_.deallocate(chunk);
+    }
+
+    Chunk* chunk_of_(Elem* elem) const {
+        return *(Chunk**)((char*)elem - elem_hdr_size_);
+    }
+
     void deallocate_all_() {
         if (used_elems_ != 0) {
             roc_panic("pool: detected leak: used=%lu free=%lu",
@@ -164,8 +246,17 @@ private:
         }
     }
 
-    size_t chunk_offset_(size_t n) const {
-        return chunk_hdr_size_ + n * elem_size_;
+    // Every slot is [padding][Chunk*][element], where the element is aligned
+    // and the header pointing to the chunk immediately precedes it.
+    void* elem_memory_(Chunk* chunk, size_t n) const {
+        char* slots = (char*)chunk + chunk_hdr_size_;
+        slots += padding((size_t)slots, alignment_);
+
+        return slots + n * slot_size_ + (slot_size_ - elem_size_);
+    }
+
+    size_t align_(size_t size) const {
+        return size + padding(size, alignment_);
     }
 
     Mutex mutex_;
@@ -175,8 +266,12 @@ private:
     List<Chunk, NoOwnership> chunks_;
     List<Elem, NoOwnership> free_elems_;
     size_t used_elems_;
+    size_t min_free_elems_;
 
+    const size_t alignment_;
     const size_t elem_size_;
+    const size_t elem_hdr_size_;
+    const size_t slot_size_;
     const size_t chunk_hdr_size_;
     size_t chunk_n_elems_;
 
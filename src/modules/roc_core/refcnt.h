@@ -12,7 +12,7 @@
 #ifndef ROC_CORE_REFCNT_H_
 #define ROC_CORE_REFCNT_H_
 
-#include "roc_core/atomic.h"
+#include "roc_core/atomic_ops.h"
 #include "roc_core/noncopyable.h"
 #include "roc_core/panic.h"
 
@@ -29,39 +29,47 @@ public:
     }
 
     ~RefCnt() {
-        if (counter_ != 0) {
+        const long counter = AtomicOps::load_relaxed(counter_);
+        if (counter != 0) {
             roc_panic("refcnt: reference counter is non-zero in destructor, counter=%d",
-                      (int)counter_);
+                      (int)counter);
         }
     }
 
     //! Get reference counter.
     long getref() const {
-        return counter_;
+        return AtomicOps::load_seq_cst(counter_);
     }
 
     //! Increment reference counter.
+    //! @remarks
+    //!  A new reference is always made from an existing one, so no ordering
+    //!  is needed here.
     void incref() const {
-        if (counter_ < 0) {
+        const long previous = AtomicOps::fetch_add_relaxed(counter_, 1);
+        if (previous < 0) {
             roc_panic("refcnt: attempting to call incref() on freed object");
         }
-        ++counter_;
     }
 
     //! Decrement reference counter.
     //! @remarks
-    //!  Calls free() if reference counter becomes zero.
+    //!  Calls free() if reference counter becomes zero. Releasing a reference
+    //!  has release semantics, and destroying the object has acquire semantics,
+    //!  so that all accesses made via other references happen before free().
     void decref() const {
-        if (counter_ <= 0) {
+        const long previous = AtomicOps::fetch_sub_release(counter_, 1);
+        if (previous <= 0) {
             roc_panic("refcnt: attempting to call decref() on destroyed object");
         }
-        if (--counter_ == 0) {
+        if (previous == 1) {
+            AtomicOps::fence_acquire();
             static_cast<T*>(const_cast<RefCnt*>(this))->destroy();
         }
     }
 
 private:
-    mutable Atomic counter_;
+    mutable long counter_;
 };
 
 } // namespace core
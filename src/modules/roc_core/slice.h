@@ -13,31 +13,31 @@
 #define ROC_CORE_SLICE_H_
 
 #include "roc_core/buffer.h"
-#include "roc_core/print.h"
+#include "roc_core/panic.h"
 #include "roc_core/shared_ptr.h"
+#include "roc_core/slice_view.h"
+#include "roc_core/stddefs.h"
 
 namespace roc {
 namespace core {
 
 //! Slice.
-template <class T> class Slice {
+//!
+//! Holds a reference to the buffer. A non-owning SliceView to the same memory
+//! may be obtained by copying the slice to a view.
+template <class T> class Slice : public SliceView<T> {
 public:
     //! Construct empty slice.
-    Slice()
-        : buffer_()
-        , data_(NULL)
-        , size_(0) {
+    Slice() {
     }
 
     //! Construct slice pointing to a buffer.
-    Slice(Buffer<T>* buffer) {
-        buffer_ = buffer;
-        if (buffer_) {
-            data_ = buffer->data();
-            size_ = buffer->size();
-        } else {
-            data_ = NULL;
-            size_ = 0;
+    Slice(Buffer<T>* buffer)
+        : owner_(buffer) {
+        if (buffer) {
+            this->buffer_ = buffer;
+            this->data_ = buffer->data();
+            this->size_ = buffer->size();
         }
     }
 
@@ -52,81 +52,34 @@ public:
                       (unsigned long)0, (unsigned long)buffer.size(), (unsigned long)from,
                       (unsigned long)to);
         }
-        buffer_ = &buffer;
-        data_ = buffer.data() + from;
-        size_ = to - from;
+        owner_ = &buffer;
+        this->buffer_ = &buffer;
+        this->data_ = buffer.data() + from;
+        this->size_ = to - from;
     }
 
-    //! Get slice data.
-    T* data() const {
-        if (data_ == NULL) {
-            roc_panic("slice: null slice");
-        }
-        return data_;
-    }
-
-    //! Get number of elements in slice.
-    size_t size() const {
-        return size_;
-    }
-
-    //! Get maximum possible number of elements in slice.
-    size_t capacity() const {
-        if (data_ == NULL) {
-            return 0;
-        } else {
-            return buffer_->size() - size_t(data_ - buffer_->data());
-        }
-    }
-
-    //! Change slice size, up to the available capacity.
-    void resize(size_t new_size) {
-        const size_t cap = capacity();
-        if (new_size > cap) {
-            roc_panic("slice: out of bounds: available=%lu, requested=%lu",
-                      (unsigned long)cap, (unsigned long)new_size);
-        }
-        size_ = new_size;
+    //! Construct slice pointing to the same memory as a view.
+    //! @remarks
+    //!  Acquires a reference to the buffer.
+    explicit Slice(const SliceView<T>& view)
+        : SliceView<T>(view)
+        , owner_(this->buffer_) {
     }
 
     //! Construct a slice pointing to a part of this slice.
     Slice range(size_t from, size_t to) const {
-        if (from > to) {
-            roc_panic("slice: invalid range: [%lu,%lu)", (unsigned long)from,
-                      (unsigned long)to);
-        }
-        if (to > size_) {
-            roc_panic("slice: out of bounds: available=[%lu,%lu), requested=[%lu,%lu)",
-                      (unsigned long)0, (unsigned long)size_, (unsigned long)from,
-                      (unsigned long)to);
-        }
+        this->check_range_(from, to);
+
         Slice ret;
-        ret.buffer_ = buffer_;
-        ret.data_ = data_ + from;
+        ret.owner_ = owner_;
+        ret.buffer_ = this->buffer_;
+        ret.data_ = this->data_ + from;
         ret.size_ = to - from;
         return ret;
     }
 
-    //! Print slice to stderr.
-    void print() const {
-        if (buffer_) {
-            core::print_slice(data_, size_, buffer_->data(), buffer_->size());
-        } else {
-            core::print_slice(data_, size_, NULL, 0);
-        }
-    }
-
-    //! Convert to bool.
-    //! @returns
-    //!  true if the slice is attached to buffer, even if it has zero length.
-    operator const struct unspecified_bool*() const {
-        return (const unspecified_bool*)data_;
-    }
-
 private:
-    SharedPtr<Buffer<T> > buffer_;
-    T* data_;
-    size_t size_;
+    SharedPtr<Buffer<T> > owner_;
 };
 
 } // namespace core
@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_core/slice_view.h
+//! @brief Slice view.
+
+#ifndef ROC_CORE_SLICE_VIEW_H_
+#define ROC_CORE_SLICE_VIEW_H_
+
+#include "roc_core/buffer.h"
+#include "roc_core/panic.h"
+#include "roc_core/print.h"
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace core {
+
+//! Slice view.
+//!
+//! Same as Slice, but doesn't own the buffer, so constructing, copying, and
+//! destroying a view doesn't touch the buffer reference counter.
+//!
+//! A view may be used only while the buffer is owned by someone else, e.g.
+//! for fields of an object that holds a Slice to the same buffer. Slice is
+//! derived from SliceView, so a slice may be passed where a view is expected.
+template <class T> class SliceView {
+public:
+    //! Construct empty view.
+    SliceView()
+        : buffer_(NULL)
+        , data_(NULL)
+        , size_(0) {
+    }
+
+    //! Get view data.
+    T* data() const {
+        if (data_ == NULL) {
+            roc_panic("slice: null slice");
+        }
+        return data_;
+    }
+
+    //! Get number of elements in view.
+    size_t size() const {
+        return size_;
+    }
+
+    //! Get maximum possible number of elements in view.
+    size_t capacity() const {
+        if (data_ == NULL) {
+            return 0;
+        } else {
+            return buffer_->size() - size_t(data_ - buffer_->data());
+        }
+    }
+
+    //! Change view size, up to the available capacity.
+    void resize(size_t new_size) {
+        const size_t cap = capacity();
+        if (new_size > cap) {
+            roc_panic("slice: out of bounds: available=%lu, requested=%lu",
+                      (unsigned long)cap, (unsigned long)new_size);
+        }
+        size_ = new_size;
+    }
+
+    //! Construct a view pointing to a part of this view.
+    SliceView range(size_t from, size_t to) const {
+        check_range_(from, to);
+
+        SliceView ret;
+        ret.buffer_ = buffer_;
+        ret.data_ = data_ + from;
+        ret.size_ = to - from;
+        return ret;
+    }
+
+    //! Print view to stderr.
+    void print() const {
+        if (buffer_) {
+            core::print_slice(data_, size_, buffer_->data(), buffer_->size());
+        } else {
+            core::print_slice(data_, size_, NULL, 0);
+        }
+    }
+
+    //! Convert to bool.
+    //! @returns
+    //!  true if the view is attached to buffer, even if it has zero length.
+    operator const struct unspecified_bool*() const {
+        return (const unspecified_bool*)data_;
+    }
+
+protected:
+    //! Check that [from; to) is a valid range inside view.
+    void check_range_(size_t from, size_t to) const {
+        if (from > to) {
+            roc_panic("slice: invalid range: [%lu,%lu)", (unsigned long)from,
+                      (unsigned long)to);
+        }
+        if (to > size_) {
+            roc_panic("slice: out of bounds: available=[%lu,%lu), requested=[%lu,%lu)",
+                      (unsigned long)0, (unsigned long)size_, (unsigned long)from,
+                      (unsigned long)to);
+        }
+    }
+
+    //! Buffer.
+    Buffer<T>* buffer_;
+
+    //! Pointer to the first element.
+    T* data_;
+
+    //! Number of elements.
+    size_t size_;
+};
+
+} // namespace core
+} // namespace roc
+
+#endif // ROC_CORE_SLICE_VIEW_H_
@@ -12,12 +12,16 @@
 #ifndef ROC_CORE_ATOMIC_H_
 #define ROC_CORE_ATOMIC_H_
 
+#include "roc_core/atomic_ops.h"
 #include "roc_core/noncopyable.h"
 
 namespace roc {
 namespace core {
 
 //! Atomic integer.
+//!
+//! All operations are sequentially consistent. Use AtomicOps directly when
+//! a weaker ordering is enough.
 class Atomic : public NonCopyable<> {
 public:
     //! Initialize with given value.
@@ -27,34 +31,27 @@ public:
 
     //! Atomic load.
     operator long() const {
-        return __sync_add_and_fetch(&value_, 0);
+        return AtomicOps::load_seq_cst(value_);
     }
 
     //! Atomic store.
-    //! @remarks
-    //!  Only boolean values may be implemented in a cross-platform way
-    //!  using GCC legacy __sync builtins.
-    long operator=(bool v) {
-        if (v) {
-            __sync_lock_test_and_set(&value_, 1);
-        } else {
-            __sync_and_and_fetch(&value_, 0);
-        }
+    long operator=(long v) {
+        AtomicOps::store_seq_cst(value_, v);
         return v;
     }
 
     //! Atomic increment.
     long operator++() {
-        return __sync_add_and_fetch(&value_, 1);
+        return AtomicOps::fetch_add_seq_cst(value_, 1) + 1;
     }
 
     //! Atomic decrement.
     long operator--() {
-        return __sync_sub_and_fetch(&value_, 1);
+        return AtomicOps::fetch_sub_seq_cst(value_, 1) - 1;
     }
 
 private:
-    mutable long value_;
+    long value_;
 };
 
 } // namespace core
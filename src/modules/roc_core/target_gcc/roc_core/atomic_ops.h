@@ -0,0 +1,222 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_core/target_gcc/roc_core/atomic_ops.h
+//! @brief Atomic operations.
+
+#ifndef ROC_CORE_ATOMIC_OPS_H_
+#define ROC_CORE_ATOMIC_OPS_H_
+
+#if defined(__clang__)                                                                   \
+    || (defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 7)))
+//! Defined if GCC __atomic builtins are available.
+#define ROC_HAVE_ATOMIC_BUILTINS
+#endif
+
+namespace roc {
+namespace core {
+
+//! Atomic operations.
+//!
+//! Provides atomic loads, stores, and read-modify-write operations with
+//! explicit memory ordering, similar to C++11 std::atomic. Can be used with
+//! integer and pointer types.
+//!
+//! Uses GCC __atomic builtins when available. Otherwise, falls back to legacy
+//! __sync builtins, which are always sequentially consistent.
+class AtomicOps {
+public:
+#ifdef ROC_HAVE_ATOMIC_BUILTINS
+
+    //! Acquire memory barrier.
+    static inline void fence_acquire() {
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    }
+
+    //! Release memory barrier.
+    static inline void fence_release() {
+        __atomic_thread_fence(__ATOMIC_RELEASE);
+    }
+
+    //! Full memory barrier.
+    static inline void fence_seq_cst() {
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    }
+
+    //! Atomic load (no barrier).
+    template <class T> static inline T load_relaxed(const T& var) {
+        return __atomic_load_n(&var, __ATOMIC_RELAXED);
+    }
+
+    //! Atomic load (acquire barrier).
+    template <class T> static inline T load_acquire(const T& var) {
+        return __atomic_load_n(&var, __ATOMIC_ACQUIRE);
+    }
+
+    //! Atomic load (full barrier).
+    template <class T> static inline T load_seq_cst(const T& var) {
+        return __atomic_load_n(&var, __ATOMIC_SEQ_CST);
+    }
+
+    //! Atomic store (no barrier).
+    template <class T, class V> static inline void store_relaxed(T& var, V val) {
+        __atomic_store_n(&var, (T)val, __ATOMIC_RELAXED);
+    }
+
+    //! Atomic store (release barrier).
+    template <class T, class V> static inline void store_release(T& var, V val) {
+        __atomic_store_n(&var, (T)val, __ATOMIC_RELEASE);
+    }
+
+    //! Atomic store (full barrier).
+    template <class T, class V> static inline void store_seq_cst(T& var, V val) {
+        __atomic_store_n(&var, (T)val, __ATOMIC_SEQ_CST);
+    }
+
+    //! Atomic exchange (acquire-release barrier).
+    template <class T, class V> static inline T exchange_acq_rel(T& var, V val) {
+        return __atomic_exchange_n(&var, (T)val, __ATOMIC_ACQ_REL);
+    }
+
+    //! Atomic compare-and-swap (acquire-release barrier).
+    //! @remarks
+    //!  If @p var is equal to @p exp, replaces it with @p des and returns true.
+    //!  Otherwise, writes current value of @p var to @p exp and returns false.
+    template <class T, class V>
+    static inline bool compare_exchange_acq_rel(T& var, T& exp, V des) {
+        return __atomic_compare_exchange_n(&var, &exp, (T)des, false, __ATOMIC_ACQ_REL,
+                                           __ATOMIC_ACQUIRE);
+    }
+
+    //! Atomic fetch-add (no barrier).
+    template <class T, class V> static inline T fetch_add_relaxed(T& var, V val) {
+        return __atomic_fetch_add(&var, (T)val, __ATOMIC_RELAXED);
+    }
+
+    //! Atomic fetch-add (acquire-release barrier).
+    template <class T, class V> static inline T fetch_add_acq_rel(T& var, V val) {
+        return __atomic_fetch_add(&var, (T)val, __ATOMIC_ACQ_REL);
+    }
+
+    //! Atomic fetch-add (full barrier).
+    template <class T, class V> static inline T fetch_add_seq_cst(T& var, V val) {
+        return __atomic_fetch_add(&var, (T)val, __ATOMIC_SEQ_CST);
+    }
+
+    //! Atomic fetch-sub (no barrier).
+    template <class T, class V> static inline T fetch_sub_relaxed(T& var, V val) {
+        return __atomic_fetch_sub(&var, (T)val, __ATOMIC_RELAXED);
+    }
+
+    //! Atomic fetch-sub (release barrier).
+    template <class T, class V> static inline T fetch_sub_release(T& var, V val) {
+        return __atomic_fetch_sub(&var, (T)val, __ATOMIC_RELEASE);
+    }
+
+    //! Atomic fetch-sub (acquire-release barrier).
+    template <class T, class V> static inline T fetch_sub_acq_rel(T& var, V val) {
+        return __atomic_fetch_sub(&var, (T)val, __ATOMIC_ACQ_REL);
+    }
+
+    //! Atomic fetch-sub (full barrier).
+    template <class T, class V> static inline T fetch_sub_seq_cst(T& var, V val) {
+        return __atomic_fetch_sub(&var, (T)val, __ATOMIC_SEQ_CST);
+    }
+
+#else // !ROC_HAVE_ATOMIC_BUILTINS
+
+    static inline void fence_acquire() {
+        __sync_synchronize();
+    }
+
+    static inline void fence_release() {
+        __sync_synchronize();
+    }
+
+    static inline void fence_seq_cst() {
+        __sync_synchronize();
+    }
+
+    template <class T> static inline T load_relaxed(const T& var) {
+        return __sync_add_and_fetch(const_cast<T*>(&var), 0);
+    }
+
+    template <class T> static inline T load_acquire(const T& var) {
+        return __sync_add_and_fetch(const_cast<T*>(&var), 0);
+    }
+
+    template <class T> static inline T load_seq_cst(const T& var) {
+        return __sync_add_and_fetch(const_cast<T*>(&var), 0);
+    }
+
+    template <class T, class V> static inline void store_relaxed(T& var, V val) {
+        exchange_acq_rel(var, val);
+    }
+
+    template <class T, class V> static inline void store_release(T& var, V val) {
+        exchange_acq_rel(var, val);
+    }
+
+    template <class T, class V> static inline void store_seq_cst(T& var, V val) {
+        exchange_acq_rel(var, val);
+    }
+
+    template <class T, class V> static inline T exchange_acq_rel(T& var, V val) {
+        T old = var;
+        T prev;
+        while ((prev = __sync_val_compare_and_swap(&var, old, (T)val)) != old) {
+            old = prev;
+        }
+        return old;
+    }
+
+    template <class T, class V>
+    static inline bool compare_exchange_acq_rel(T& var, T& exp, V des) {
+        T prev = __sync_val_compare_and_swap(&var, exp, (T)des);
+        if (prev == exp) {
+            return true;
+        }
+        exp = prev;
+        return false;
+    }
+
+    template <class T, class V> static inline T fetch_add_relaxed(T& var, V val) {
+        return __sync_fetch_and_add(&var, (T)val);
+    }
+
+    template <class T, class V> static inline T fetch_add_acq_rel(T& var, V val) {
+        return __sync_fetch_and_add(&var, (T)val);
+    }
+
+    template <class T, class V> static inline T fetch_add_seq_cst(T& var, V val) {
+        return __sync_fetch_and_add(&var, (T)val);
+    }
+
+    template <class T, class V> static inline T fetch_sub_relaxed(T& var, V val) {
+        return __sync_fetch_and_sub(&var, (T)val);
+    }
+
+    template <class T, class V> static inline T fetch_sub_release(T& var, V val) {
+        return __sync_fetch_and_sub(&var, (T)val);
+    }
+
+    template <class T, class V> static inline T fetch_sub_acq_rel(T& var, V val) {
+        return __sync_fetch_and_sub(&var, (T)val);
+    }
+
+    template <class T, class V> static inline T fetch_sub_seq_cst(T& var, V val) {
+        return __sync_fetch_and_sub(&var, (T)val);
+    }
+
+#endif // ROC_HAVE_ATOMIC_BUILTINS
+};
+
+} // namespace core
+} // namespace roc
+
+#endif // ROC_CORE_ATOMIC_OPS_H_
@@ -24,6 +24,9 @@
 //! Structure's fields are packed.
 #define ROC_ATTR_PACKED __attribute__((packed))
 
+//! Structure or field is aligned to given number of bytes.
+#define ROC_ATTR_ALIGNED(n) __attribute__((aligned(n)))
+
 //! Function gets printf-like arguments.
 #define ROC_ATTR_PRINTF(n_fmt_arg, n_var_arg)                                            \
     __attribute__((format(printf, n_fmt_arg, n_var_arg)))
@@ -0,0 +1,237 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "roc_core/alignment.h"
+#include "roc_core/arena_allocator.h"
+#include "roc_core/errno_to_str.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+
+#if !defined(MAP_ANONYMOUS) && defined(MAP_ANON)
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+
+namespace roc {
+namespace core {
+
+namespace {
+
+enum { HugePageSize = 2 * 1024 * 1024 };
+
+size_t round_up(size_t size, size_t alignment) {
+    return size + padding(size, alignment);
+}
+
+} // namespace
+
+ArenaAllocator::ArenaAllocator(size_t region_size, bool huge_pages)
+    : current_(NULL)
+    , region_size_(region_size)
+    , page_size_((size_t)sysconf(_SC_PAGESIZE))
+    , huge_pages_(huge_pages)
+    , num_allocations_(0) {
+    roc_log(LogDebug, "arena allocator: initializing: region_size=%lu huge_pages=%d",
+            (unsigned long)region_size_, (int)huge_pages_);
+}
+
+ArenaAllocator::~ArenaAllocator() {
+    if (num_allocations_ != 0) {
+        roc_panic("arena allocator: detected leak, num_allocations=%lu",
+                  (unsigned long)num_allocations_);
+    }
+
+    while (Region* region = regions_.front()) {
+        unmap_region_(region);
+    }
+}
+
+void* ArenaAllocator::allocate(size_t size) {
+    const size_t header_size = max_align(sizeof(Region*));
+    const size_t block_size = max_align(header_size + size);
+
+    Mutex::Lock lock(mutex_);
+
+    Region* region = current_;
+
+    if (!region || region->map_size - region->offset < block_size) {
+        const size_t region_size = max_align(sizeof(Region)) + block_size;
+
+        region = map_region_(region_size);
+        if (!region) {
+            return NULL;
+        }
+
+        // Blocks larger than a region get a dedicated one, and the current
+        // region is kept for subsequent small blocks.
+        if (region_size <= region_size_) {
+            if (current_ && current_->num_allocations == 0) {
+                unmap_region_(current_);
+            }
+            current_ = region;
+        }
+    }
+
+    char* block = (char*)region + region->offset;
+    region->offset += block_size;
+
+    *(Region**)block = region;
+
+    region->num_allocations++;
+    num_allocations_++;
+
+    return block + header_size;
+}
+
+void ArenaAllocator::deallocate(void* ptr) {
+    if (!ptr) {
+        roc_panic("arena allocator: deallocating null pointer");
+    }
+
+    const size_t header_size = max_align(sizeof(Region*));
+
+    Mutex::Lock lock(mutex_);
+
+    if (num_allocations_ == 0) {
+        roc_panic("arena allocator: unpaired deallocate");
+    }
+
+    Region* region = *(Region**)((char*)ptr - header_size);
+
+    region->num_allocations--;
+    num_allocations_--;
+
+    if (region->num_allocations != 0) {
+        return;
+    }
+
+    if (region == current_) {
+        region->offset = max_align(sizeof(Region));
+    } else {
+        unmap_region_(region);
+    }
+}
+
+size_t ArenaAllocator::num_allocations() const {
+    Mutex::Lock lock(mutex_);
+    return num_allocations_;
+}
+
+size_t ArenaAllocator::num_regions() const {
+    Mutex::Lock lock(mutex_);
+    return regions_.size();
+}
+
+ArenaAllocator::Region* ArenaAllocator::map_region_(size_t size) {
+    if (size < region_size_) {
+        size = region_size_;
+    }
+
+    void* addr = NULL;
+
+    if (huge_pages_) {
+        size = round_up(size, HugePageSize);
+        addr = map_huge_(size);
+    } else {
+        size = round_up(size, page_size_);
+        addr = map_aligned_(size, page_size_);
+    }
+
+    if (!addr) {
+        return NULL;
+    }
+
+    Region* region = new (addr) Region;
+
+    region->map_size = size;
+    region->offset = max_align(sizeof(Region));
+    region->num_allocations = 0;
+
+    regions_.push_back(*region);
+
+    roc_log(LogTrace, "arena allocator: mapped region: size=%lu num_regions=%lu",
+            (unsigned long)size, (unsigned long)regions_.size());
+
+    return region;
+}
+
+void* ArenaAllocator::map_huge_(size_t size) {
+#ifdef MAP_HUGETLB
+    void* addr = mmap(NULL, size, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (addr != MAP_FAILED) {
+        return addr;
+    }
+    roc_log(LogTrace, "arena allocator: mmap(MAP_HUGETLB): %s, falling back",
+            errno_to_str().c_str());
+#endif
+
+    void* aligned_addr = map_aligned_(size, HugePageSize);
+    if (!aligned_addr) {
+        return NULL;
+    }
+
+#ifdef MADV_HUGEPAGE
+    if (madvise(aligned_addr, size, MADV_HUGEPAGE) == -1) {
+        roc_log(LogTrace, "arena allocator: madvise(MADV_HUGEPAGE): %s",
+                errno_to_str().c_str());
+    }
+#endif
+
+    return aligned_addr;
+}
+
+void* ArenaAllocator::map_aligned_(size_t size, size_t alignment) {
+    const size_t extra_size = alignment > page_size_ ? alignment : 0;
+
+    char* addr = (char*)mmap(NULL, size + extra_size, PROT_READ | PROT_WRITE,
+                             MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if ((void*)addr == MAP_FAILED) {
+        roc_log(LogError, "arena allocator: mmap: %s", errno_to_str().c_str());
+        return NULL;
+    }
+
+    if (extra_size == 0) {
+        return addr;
+    }
+
+    const size_t head_size = padding((size_t)addr, alignment);
+    const size_t tail_size = extra_size - head_size;
+
+    if (head_size != 0 && munmap(addr, head_size) == -1) {
+        roc_panic("arena allocator: munmap: %s", errno_to_str().c_str());
+    }
+    if (tail_size != 0 && munmap(addr + head_size + size, tail_size) == -1) {
+        roc_panic("arena allocator: munmap: %s", errno_to_str().c_str());
+    }
+
+    return addr + head_size;
+}
+
+void ArenaAllocator::unmap_region_(Region* region) {
+    if (region == current_) {
+        current_ = NULL;
+    }
+
+    regions_.remove(*region);
+
+    const size_t size = region->map_size;
+    region->~Region();
+
+    if (munmap(region, size) == -1) {
+        roc_panic("arena allocator: munmap: %s", errno_to_str().c_str());
+    }
+
+    roc_log(LogTrace, "arena allocator: unmapped region: size=%lu num_regions=%lu",
+            (unsigned long)size, (unsigned long)regions_.size());
+}
+
+} // namespace core
+} // namespace roc
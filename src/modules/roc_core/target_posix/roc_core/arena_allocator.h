@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_core/target_posix/roc_core/arena_allocator.h
+//! @brief Arena allocator implementation.
+
+#ifndef ROC_CORE_ARENA_ALLOCATOR_H_
+#define ROC_CORE_ARENA_ALLOCATOR_H_
+
+#include "roc_core/iallocator.h"
+#include "roc_core/list.h"
+#include "roc_core/list_node.h"
+#include "roc_core/mutex.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/ownership.h"
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace core {
+
+//! Arena allocator implementation.
+//!
+//! Maps large memory regions using mmap() and allocates blocks from the
+//! current region by bumping a pointer. Every region counts its live blocks;
+//! when the last block of a region is deallocated, the region is unmapped,
+//! or rewound if it's the current one.
+//!
+//! If huge pages are requested, regions are mapped with MAP_HUGETLB when it's
+//! available, and otherwise are aligned to the huge page size and advised with
+//! MADV_HUGEPAGE, so that the kernel may back them with transparent huge pages.
+//!
+//! The memory is always maximum aligned. Thread-safe.
+class ArenaAllocator : public IAllocator, public NonCopyable<> {
+public:
+    //! Initialize.
+    //!
+    //! @b Parameters
+    //!  - @p region_size defines the minimum size of a mapped region in bytes;
+    //!    larger blocks get a dedicated region
+    //!  - @p huge_pages defines whether to try to back regions with huge pages
+    ArenaAllocator(size_t region_size, bool huge_pages);
+
+    ~ArenaAllocator();
+
+    //! Allocate memory.
+    virtual void* allocate(size_t size);
+
+    //! Deallocate previously allocated memory.
+    virtual void deallocate(void*);
+
+    //! Get number of allocated blocks.
+    size_t num_allocations() const;
+
+    //! Get number of mapped regions.
+    size_t num_regions() const;
+
+private:
+    struct Region : ListNode {
+        size_t map_size;
+        size_t offset;
+        size_t num_allocations;
+    };
+
+    Region* map_region_(size_t size);
+    void* map_huge_(size_t size);
+    void* map_aligned_(size_t size, size_t alignment);
+    void unmap_region_(Region* region);
+
+    Mutex mutex_;
+
+    List<Region, NoOwnership> regions_;
+    Region* current_;
+
+    const size_t region_size_;
+    const size_t page_size_;
+    const bool huge_pages_;
+
+    size_t num_allocations_;
+};
+
+} // namespace core
+} // namespace roc
+
+#endif // ROC_CORE_ARENA_ALLOCATOR_H_
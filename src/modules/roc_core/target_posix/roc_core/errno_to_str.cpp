@@ -19,7 +19,9 @@ namespace roc {
 namespace core {
 
 errno_to_str::errno_to_str() {
-    errno_to_str(errno);
+    if (strerror_r(errno, buffer_, sizeof(buffer_)) == -1) {
+        buffer_[0] = '\0';
+    }
 }
 
 errno_to_str::errno_to_str(int err) {
@@ -45,6 +45,13 @@ public:
         uv_mutex_lock(&mutex_);
     }
 
+    //! Try to lock mutex without blocking.
+    //! @returns
+    //!  true if the mutex was locked.
+    bool try_lock() const {
+        return uv_mutex_trylock(&mutex_) == 0;
+    }
+
     //! Unlock mutex.
     void unlock() const {
         uv_mutex_unlock(&mutex_);
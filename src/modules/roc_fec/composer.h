@@ -22,14 +22,21 @@ namespace roc {
 namespace fec {
 
 //! FECFRAME packet composer.
-template <class PayloadID, PayloadID_Type Type, PayloadID_Pos Pos>
+//!
+//! @tparam InnerComposer defines the type of the inner composer. If it's a
+//! concrete composer class, it's called directly instead of through IComposer,
+//! so the whole stack of composers for a protocol is fixed at compile time.
+template <class PayloadID,
+          PayloadID_Type Type,
+          PayloadID_Pos Pos,
+          class InnerComposer = packet::IComposer>
 class Composer : public packet::IComposer, public core::NonCopyable<> {
 public:
     //! Initialization.
     //! @remarks
     //!  Composes FECFRAME header or footer and passes the rest to
     //!  @p inner_composer if it's not null.
-    Composer(packet::IComposer* inner_composer)
+    Composer(InnerComposer* inner_composer)
         : inner_composer_(inner_composer) {
     }
 
@@ -60,14 +67,15 @@ public:
 
             return true;
         } else {
-            return inner_composer_->align(buffer, header_size, payload_alignment);
+            return align_inner_(inner_composer_, buffer, header_size, payload_alignment);
         }
     }
 
     //! Prepare buffer for composing a packet.
-    virtual bool
-    prepare(packet::Packet& packet, core::Slice<uint8_t>& buffer, size_t payload_size) {
-        core::Slice<uint8_t> payload_id = buffer.range(0, 0);
+    virtual bool prepare(packet::Packet& packet,
+                         core::SliceView<uint8_t>& buffer,
+                         size_t payload_size) {
+        core::SliceView<uint8_t> payload_id = buffer.range(0, 0);
 
         if (Pos == Header) {
             if (payload_id.capacity() < sizeof(PayloadID)) {
@@ -80,11 +88,11 @@ public:
             payload_id.resize(sizeof(PayloadID));
         }
 
-        core::Slice<uint8_t> payload =
+        core::SliceView<uint8_t> payload =
             payload_id.range(payload_id.size(), payload_id.size());
 
         if (inner_composer_) {
-            if (!inner_composer_->prepare(packet, payload, payload_size)) {
+            if (!prepare_inner_(inner_composer_, packet, payload, payload_size)) {
                 return false;
             }
         } else {
@@ -124,7 +132,7 @@ public:
     //! Pad packet.
     virtual bool pad(packet::Packet& packet, size_t padding_size) {
         if (inner_composer_) {
-            return inner_composer_->pad(packet, padding_size);
+            return pad_inner_(inner_composer_, packet, padding_size);
         }
 
         // padding not supported
@@ -147,26 +155,71 @@ public:
 
         payload_id.clear();
 
-        roc_panic_if((fec.encoding_symbol_id >> 16) != 0);
-        payload_id.set_esi((uint16_t)fec.encoding_symbol_id);
+        payload_id.set_esi(fec.encoding_symbol_id);
 
         payload_id.set_sbn(fec.source_block_number);
 
-        roc_panic_if((fec.source_block_length >> 16) != 0);
-        payload_id.set_k((uint16_t)fec.source_block_length);
-
-        roc_panic_if((fec.block_length >> 16) != 0);
-        payload_id.set_n((uint16_t)fec.block_length);
+        payload_id.set_k(fec.source_block_length);
+        payload_id.set_n(fec.block_length);
 
         if (inner_composer_) {
-            return inner_composer_->compose(packet);
+            return compose_inner_(inner_composer_, packet);
         }
 
         return true;
     }
 
 private:
-    packet::IComposer* inner_composer_;
+    static bool align_inner_(packet::IComposer* composer,
+                             core::Slice<uint8_t>& buffer,
+                             size_t header_size,
+                             size_t payload_alignment) {
+        return composer->align(buffer, header_size, payload_alignment);
+    }
+
+    template <class C>
+    static bool align_inner_(C* composer,
+                             core::Slice<uint8_t>& buffer,
+                             size_t header_size,
+                             size_t payload_alignment) {
+        // qualified call is not virtual
+        return composer->C::align(buffer, header_size, payload_alignment);
+    }
+
+    static bool prepare_inner_(packet::IComposer* composer,
+                               packet::Packet& packet,
+                               core::SliceView<uint8_t>& buffer,
+                               size_t payload_size) {
+        return composer->prepare(packet, buffer, payload_size);
+    }
+
+    template <class C>
+    static bool prepare_inner_(C* composer,
+                               packet::Packet& packet,
+                               core::SliceView<uint8_t>& buffer,
+                               size_t payload_size) {
+        return composer->C::prepare(packet, buffer, payload_size);
+    }
+
+    static bool
+    pad_inner_(packet::IComposer* composer, packet::Packet& packet, size_t padding_size) {
+        return composer->pad(packet, padding_size);
+    }
+
+    template <class C>
+    static bool pad_inner_(C* composer, packet::Packet& packet, size_t padding_size) {
+        return composer->C::pad(packet, padding_size);
+    }
+
+    static bool compose_inner_(packet::IComposer* composer, packet::Packet& packet) {
+        return composer->compose(packet);
+    }
+
+    template <class C> static bool compose_inner_(C* composer, packet::Packet& packet) {
+        return composer->C::compose(packet);
+    }
+
+    InnerComposer* inner_composer_;
 };
 
 } // namespace fec
@@ -21,19 +21,26 @@ namespace roc {
 namespace fec {
 
 //! FECFRAME packet parser.
-template <class PayloadID, PayloadID_Type Type, PayloadID_Pos Pos>
+//!
+//! @tparam InnerParser defines the type of the inner parser. If it's a concrete
+//! parser class, it's called directly instead of through IParser, so the whole
+//! stack of parsers for a protocol is fixed at compile time.
+template <class PayloadID,
+          PayloadID_Type Type,
+          PayloadID_Pos Pos,
+          class InnerParser = packet::IParser>
 class Parser : public packet::IParser, public core::NonCopyable<> {
 public:
     //! Initialization.
     //! @remarks
     //!  Parses FECFRAME header or footer and passes the rest to @p inner_parser
     //!  if it's not null.
-    explicit Parser(packet::IParser* inner_parser)
+    explicit Parser(InnerParser* inner_parser)
         : inner_parser_(inner_parser) {
     }
 
     //! Parse packet from buffer.
-    virtual bool parse(packet::Packet& packet, const core::Slice<uint8_t>& buffer) {
+    virtual bool parse(packet::Packet& packet, const core::SliceView<uint8_t>& buffer) {
         if (buffer.size() < sizeof(PayloadID)) {
             roc_log(LogDebug, "fec parser: bad packet, size < %d (payload id)",
                     (int)sizeof(PayloadID));
@@ -63,20 +70,37 @@ public:
         fec.block_length = payload_id->n();
 
         if (Pos == Header) {
+            fec.payload_id = buffer.range(0, sizeof(PayloadID));
             fec.payload = buffer.range(sizeof(PayloadID), buffer.size());
         } else {
+            fec.payload_id =
+                buffer.range(buffer.size() - sizeof(PayloadID), buffer.size());
             fec.payload = buffer.range(0, buffer.size() - sizeof(PayloadID));
         }
 
         if (inner_parser_) {
-            return inner_parser_->parse(packet, fec.payload);
+            return parse_inner_(inner_parser_, packet, fec.payload);
         }
 
         return true;
     }
 
 private:
-    packet::IParser* inner_parser_;
+    static bool parse_inner_(packet::IParser* parser,
+                             packet::Packet& packet,
+                             const core::SliceView<uint8_t>& buffer) {
+        return parser->parse(packet, buffer);
+    }
+
+    template <class P>
+    static bool parse_inner_(P* parser,
+                             packet::Packet& packet,
+                             const core::SliceView<uint8_t>& buffer) {
+        // qualified call is not virtual
+        return parser->P::parse(packet, buffer);
+    }
+
+    InnerParser* inner_parser_;
 };
 
 } // namespace fec
@@ -14,6 +14,12 @@
 namespace roc {
 namespace fec {
 
+namespace {
+
+enum { FetchBatchSize = 16 };
+
+} // namespace
+
 Reader::Reader(const ReaderConfig& config,
                packet::FECScheme fec_scheme,
                IBlockDecoder& decoder,
@@ -72,6 +78,33 @@ packet::PacketPtr Reader::read() {
     return (alive_ ? pp : NULL);
 }
 
+void Reader::reset() {
+    roc_panic_if_not(valid());
+
+    source_queue_.reset();
+    repair_queue_.reset();
+
+    // shrinking never releases memory
+    if (!source_block_.resize(0) || !repair_block_.resize(0)) {
+        roc_panic("fec reader: can't shrink blocks");
+    }
+
+    alive_ = true;
+    started_ = false;
+    can_repair_ = false;
+
+    next_packet_ = 0;
+    cur_sbn_ = 0;
+
+    payload_size_ = 0;
+
+    source_block_resized_ = false;
+    repair_block_resized_ = false;
+    payload_resized_ = false;
+
+    n_packets_ = 0;
+}
+
 packet::PacketPtr Reader::read_() {
     fetch_packets_();
 
@@ -203,14 +236,15 @@ void Reader::try_repair_() {
         if (!source_block_[n]) {
             continue;
         }
-        decoder_.set(n, source_block_[n]->fec()->payload);
+        decoder_.set(n, core::Slice<uint8_t>(source_block_[n]->fec()->payload));
     }
 
     for (size_t n = 0; n < repair_block_.size(); n++) {
         if (!repair_block_[n]) {
             continue;
         }
-        decoder_.set(source_block_.size() + n, repair_block_[n]->fec()->payload);
+        decoder_.set(source_block_.size() + n,
+                     core::Slice<uint8_t>(repair_block_[n]->fec()->payload));
     }
 
     for (size_t n = 0; n < source_block_.size(); n++) {
@@ -254,24 +288,34 @@ packet::PacketPtr Reader::parse_repaired_packet_(const core::Slice<uint8_t>& buf
 }
 
 void Reader::fetch_packets_() {
+    packet::PacketPtr packets[FetchBatchSize];
+
     for (;;) {
-        if (packet::PacketPtr pp = source_reader_.read()) {
-            if (!validate_fec_packet_(pp)) {
+        const size_t n_packets = source_reader_.read_many(packets, FetchBatchSize);
+
+        for (size_t n = 0; n < n_packets; n++) {
+            if (!validate_fec_packet_(packets[n])) {
                 return;
             }
-            source_queue_.write(pp);
-        } else {
+            source_queue_.write(packets[n]);
+        }
+
+        if (n_packets < FetchBatchSize) {
             break;
         }
     }
 
     for (;;) {
-        if (packet::PacketPtr pp = repair_reader_.read()) {
-            if (!validate_fec_packet_(pp)) {
+        const size_t n_packets = repair_reader_.read_many(packets, FetchBatchSize);
+
+        for (size_t n = 0; n < n_packets; n++) {
+            if (!validate_fec_packet_(packets[n])) {
                 return;
             }
-            repair_queue_.write(pp);
-        } else {
+            repair_queue_.write(packets[n]);
+        }
+
+        if (n_packets < FetchBatchSize) {
             break;
         }
     }
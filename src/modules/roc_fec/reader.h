@@ -71,6 +71,12 @@ public:
     //!  When a packet loss is detected, try to restore it from repair packets.
     virtual packet::PacketPtr read();
 
+    //! Reset to initial state.
+    //! @remarks
+    //!  Drops all queued packets and the current block and waits for the
+    //!  beginning of a new block. Keeps allocated block memory.
+    void reset();
+
 private:
     packet::PacketPtr read_();
 
@@ -185,7 +185,7 @@ bool Writer::apply_sizes_(size_t sblen, size_t rblen, size_t payload_size) {
 }
 
 void Writer::write_source_packet_(const packet::PacketPtr& pp) {
-    encoder_.set(cur_packet_, pp->fec()->payload);
+    encoder_.set(cur_packet_, core::Slice<uint8_t>(pp->fec()->payload));
 
     pp->add_flags(packet::Packet::FlagComposed);
     fill_packet_fec_fields_(pp, (packet::seqnum_t)cur_packet_);
@@ -247,7 +247,7 @@ void Writer::encode_repair_packets_() {
     for (packet::seqnum_t i = 0; i < cur_rblen_; i++) {
         packet::PacketPtr rp = repair_block_[i];
         if (rp) {
-            encoder_.set(cur_sblen_ + i, rp->fec()->payload);
+            encoder_.set(cur_sblen_ + i, core::Slice<uint8_t>(rp->fec()->payload));
         }
     }
     encoder_.fill();
@@ -284,8 +284,9 @@ void Writer::fill_packet_fec_fields_(const packet::PacketPtr& packet,
 
     fec.encoding_symbol_id = pack_n;
     fec.source_block_number = cur_sbn_;
-    fec.source_block_length = cur_sblen_;
-    fec.block_length = cur_sblen_ + cur_rblen_;
+    // block length is limited by the encoder, and FECFRAME fields are 16-bit
+    fec.source_block_length = (uint16_t)cur_sblen_;
+    fec.block_length = (uint16_t)(cur_sblen_ + cur_rblen_);
 }
 
 void Writer::validate_fec_packet_(const packet::PacketPtr& pp) {
@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_netio/target_uring/roc_netio/basic_port.h
+//! @brief Basic network port.
+
+#ifndef ROC_NETIO_BASIC_PORT_H_
+#define ROC_NETIO_BASIC_PORT_H_
+
+#include "roc_core/iallocator.h"
+#include "roc_core/list_node.h"
+#include "roc_core/refcnt.h"
+#include "roc_netio/ioperation_handler.h"
+#include "roc_packet/address.h"
+
+namespace roc {
+namespace netio {
+
+//! Basic port interface.
+//! @remarks
+//!  All methods should be called from the event loop thread.
+class BasicPort : public core::RefCnt<BasicPort>,
+                  public core::ListNode,
+                  public IOperationHandler {
+public:
+    //! Initialize.
+    explicit BasicPort(core::IAllocator&);
+
+    //! Destroy.
+    virtual ~BasicPort();
+
+    //! Get bind address.
+    virtual const packet::Address& address() const = 0;
+
+    //! Open port.
+    virtual bool open() = 0;
+
+    //! Start closing port.
+    //! @remarks
+    //!  The port is closed when all its pending operations are completed.
+    virtual void async_close() = 0;
+
+    //! Check if the port was closed.
+    virtual bool closed() const = 0;
+
+    //! Process pending work.
+    //! @remarks
+    //!  Called by the event loop after every portion of completions.
+    virtual void flush() = 0;
+
+private:
+    friend class core::RefCnt<BasicPort>;
+
+    void destroy();
+
+    core::IAllocator& allocator_;
+};
+
+} // namespace netio
+} // namespace roc
+
+#endif // ROC_NETIO_BASIC_PORT_H_
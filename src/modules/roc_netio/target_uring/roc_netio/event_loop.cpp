@@ -0,0 +1,491 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <errno.h>
+
+#include "roc_core/atomic_ops.h"
+#include "roc_core/errno_to_str.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+#include "roc_core/shared_ptr.h"
+#include "roc_netio/event_loop.h"
+#include "roc_packet/address_to_str.h"
+
+namespace roc {
+namespace netio {
+
+namespace {
+
+// Interval between pool trims, in seconds.
+const long TrimInterval = 10;
+
+} // namespace
+
+EventLoop::EventLoop(packet::PacketPool& packet_pool,
+                     core::BufferPool<uint8_t>& buffer_pool,
+                     core::BufferPool<audio::sample_t>* sample_buffer_pool,
+                     core::IAllocator& allocator,
+                     bool trim_pools)
+    : packet_pool_(packet_pool)
+    , buffer_pool_(buffer_pool)
+    , sample_buffer_pool_(sample_buffer_pool)
+    , allocator_(allocator)
+    , trim_pools_(trim_pools)
+    , started_(false)
+    , ring_(NumEntries)
+    , wake_value_(0)
+    , pending_ops_(0)
+    , stop_(0)
+    , stopping_(false)
+    , next_buf_group_(0)
+    , cond_(mutex_) {
+    if (!ring_.valid() || !waker_.valid()) {
+        return;
+    }
+
+    wake_op_.handler = this;
+    trim_op_.handler = this;
+    cancel_op_.handler = this;
+
+    trim_interval_.tv_sec = TrimInterval;
+    trim_interval_.tv_nsec = 0;
+
+    // operations are only prepared here and are submitted by the thread
+    if (!start_wake_()) {
+        return;
+    }
+
+    if (trim_pools_ && !start_trim_()) {
+        return;
+    }
+
+    started_ = Thread::start();
+}
+
+EventLoop::~EventLoop() {
+    if (started_) {
+        core::AtomicOps::store_release(stop_, 1);
+        waker_.wake();
+
+        Thread::join();
+    }
+
+    roc_panic_if(joinable());
+    roc_panic_if(open_ports_.size());
+    roc_panic_if(closing_ports_.size());
+}
+
+bool EventLoop::valid() const {
+    return started_;
+}
+
+size_t EventLoop::num_ports() const {
+    core::Mutex::Lock lock(mutex_);
+
+    return open_ports_.size();
+}
+
+bool EventLoop::has_port(const packet::Address& address) const {
+    core::Mutex::Lock lock(mutex_);
+
+    for (BasicPort* pp = open_ports_.front_borrowed(); pp;
+         pp = open_ports_.nextof_borrowed(*pp)) {
+        if (pp->address() == address) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool EventLoop::add_udp_receiver(packet::Address& bind_address,
+                                 packet::IWriter& writer,
+                                 bool reuseport,
+                                 bool timestamps) {
+    if (!valid()) {
+        roc_panic("event loop: can't use invalid event loop");
+    }
+
+    Task task;
+    task.fn = &EventLoop::add_udp_receiver_;
+    task.address = &bind_address;
+    task.writer = &writer;
+    task.reuseport = reuseport;
+    task.timestamps = timestamps;
+
+    run_task_(task);
+
+    if (!task.result) {
+        if (task.port) {
+            wait_port_closed_(*task.port);
+        }
+    }
+
+    return task.result;
+}
+
+packet::IWriter* EventLoop::add_udp_sender(packet::Address& bind_address,
+                                           bool direct_send) {
+    if (!valid()) {
+        roc_panic("event loop: can't use invalid event loop");
+    }
+
+    Task task;
+    task.fn = &EventLoop::add_udp_sender_;
+    task.address = &bind_address;
+    task.writer = NULL;
+    task.direct_send = direct_send;
+
+    run_task_(task);
+
+    if (!task.result) {
+        if (task.port) {
+            wait_port_closed_(*task.port);
+        }
+    }
+
+    return task.writer;
+}
+
+bool EventLoop::remove_port(packet::Address bind_address) {
+    if (!valid()) {
+        roc_panic("event loop: can't use invalid event loop");
+    }
+
+    Task task;
+    task.fn = &EventLoop::remove_port_;
+    task.address = &bind_address;
+    task.writer = NULL;
+
+    run_task_(task);
+
+    if (!task.result) {
+        return false;
+    }
+
+    roc_panic_if_not(task.port);
+    wait_port_closed_(*task.port);
+
+    return true;
+}
+
+void EventLoop::handle_completion(Operation& op, int res, unsigned) {
+    roc_panic_if(pending_ops_ == 0);
+    pending_ops_--;
+
+    if (&op == &wake_op_) {
+        handle_wake_(res);
+    } else if (&op == &trim_op_) {
+        handle_trim_(res);
+    }
+}
+
+void EventLoop::run() {
+    roc_log(LogDebug, "event loop: starting event loop");
+
+    // ports may be added or removed only by this thread, so lists are
+    // traversed here without the lock and modified under the lock
+    while (!stopping_ || pending_ops_ != 0 || closing_ports_.size() != 0) {
+        const int ret = ring_.submit(1);
+        if (ret < 0 && ret != -EBUSY && ret != -EAGAIN) {
+            roc_panic("event loop: io_uring_enter(): %s",
+                      core::errno_to_str(-ret).c_str());
+        }
+
+        while (io_uring_cqe* cqe = ring_.peek_cqe()) {
+            Operation& op = *(Operation*)(unsigned long)cqe->user_data;
+
+            const int res = cqe->res;
+            const unsigned flags = cqe->flags;
+
+            ring_.pop_cqe();
+
+            roc_panic_if_not(op.handler);
+            op.handler->handle_completion(op, res, flags);
+        }
+
+        flush_ports_();
+        reap_ports_();
+    }
+
+    roc_log(LogDebug, "event loop: finishing event loop");
+}
+
+void EventLoop::handle_wake_(int res) {
+    if (res < 0) {
+        roc_panic("event loop: can't read eventfd: %s", core::errno_to_str(-res).c_str());
+    }
+
+    waker_.reset();
+
+    if (core::AtomicOps::load_acquire(stop_)) {
+        stopping_ = true;
+
+        async_close_ports_();
+        stop_trim_();
+        process_tasks_();
+
+        return;
+    }
+
+    if (!start_wake_()) {
+        roc_panic("event loop: can't restart eventfd read");
+    }
+
+    process_tasks_();
+}
+
+void EventLoop::handle_trim_(int res) {
+    if (res != -ETIME) {
+        return;
+    }
+
+    packet_pool_.trim();
+    buffer_pool_.trim();
+
+    if (sample_buffer_pool_) {
+        sample_buffer_pool_->trim();
+    }
+
+    if (!stopping_ && !start_trim_()) {
+        roc_log(LogError, "event loop: can't restart trim timer");
+    }
+}
+
+bool EventLoop::start_wake_() {
+    io_uring_sqe* sqe = ring_.get_sqe();
+    if (!sqe) {
+        return false;
+    }
+
+    sqe->opcode = IORING_OP_READ;
+    sqe->fd = waker_.fd();
+    sqe->addr = (unsigned long)&wake_value_;
+    sqe->len = sizeof(wake_value_);
+    sqe->user_data = (unsigned long)&wake_op_;
+
+    pending_ops_++;
+
+    return true;
+}
+
+bool EventLoop::start_trim_() {
+    io_uring_sqe* sqe = ring_.get_sqe();
+    if (!sqe) {
+        return false;
+    }
+
+    sqe->opcode = IORING_OP_TIMEOUT;
+    sqe->fd = -1;
+    sqe->addr = (unsigned long)&trim_interval_;
+    sqe->len = 1;
+    sqe->user_data = (unsigned long)&trim_op_;
+
+    pending_ops_++;
+
+    return true;
+}
+
+void EventLoop::stop_trim_() {
+    if (!trim_pools_) {
+        return;
+    }
+
+    io_uring_sqe* sqe = ring_.get_sqe();
+    if (!sqe) {
+        roc_panic("event loop: can't stop trim timer: submission queue is full");
+    }
+
+    sqe->opcode = IORING_OP_TIMEOUT_REMOVE;
+    sqe->fd = -1;
+    sqe->addr = (unsigned long)&trim_op_;
+    sqe->user_data = (unsigned long)&cancel_op_;
+
+    pending_ops_++;
+}
+
+void EventLoop::flush_ports_() {
+    for (BasicPort* pp = open_ports_.front_borrowed(); pp;
+         pp = open_ports_.nextof_borrowed(*pp)) {
+        pp->flush();
+    }
+
+    for (BasicPort* pp = closing_ports_.front_borrowed(); pp;
+         pp = closing_ports_.nextof_borrowed(*pp)) {
+        pp->flush();
+    }
+}
+
+void EventLoop::reap_ports_() {
+    core::Mutex::Lock lock(mutex_);
+
+    bool reaped = false;
+
+    core::SharedPtr<BasicPort> curr = closing_ports_.front();
+    while (curr) {
+        core::SharedPtr<BasicPort> next = closing_ports_.nextof(*curr);
+
+        if (curr->closed()) {
+            roc_log(LogDebug, "event loop: asynchronous close finished: port %s",
+                    packet::address_to_str(curr->address()).c_str());
+
+            closing_ports_.remove(*curr);
+            reaped = true;
+        }
+
+        curr = next;
+    }
+
+    if (reaped) {
+        cond_.broadcast();
+    }
+}
+
+void EventLoop::async_close_ports_() {
+    core::Mutex::Lock lock(mutex_);
+
+    while (core::SharedPtr<BasicPort> port = open_ports_.front()) {
+        open_ports_.remove(*port);
+        closing_ports_.push_back(*port);
+
+        port->async_close();
+    }
+}
+
+void EventLoop::run_task_(Task& task) {
+    core::Mutex::Lock lock(mutex_);
+
+    tasks_.push_back(task);
+
+    waker_.wake();
+
+    while (!task.done) {
+        cond_.wait();
+    }
+}
+
+void EventLoop::process_tasks_() {
+    core::Mutex::Lock lock(mutex_);
+
+    while (Task* task = tasks_.front()) {
+        tasks_.remove(*task);
+
+        task->result = (this->*(task->fn))(*task);
+        task->done = true;
+    }
+
+    cond_.broadcast();
+}
+
+bool EventLoop::add_udp_receiver_(Task& task) {
+    core::SharedPtr<BasicPort> rp =
+        new (allocator_) UDPReceiverPort(*task.address, ring_, next_buf_group_++,
+                                         *task.writer, packet_pool_, buffer_pool_,
+                                         allocator_, task.reuseport, task.timestamps);
+
+    if (!rp) {
+        roc_log(LogError, "event loop: can't add port %s: can't allocate receiver",
+                packet::address_to_str(*task.address).c_str());
+
+        return false;
+    }
+
+    task.port = rp.get();
+
+    if (!rp->open()) {
+        roc_log(LogError, "event loop: can't add port %s: can't start receiver",
+                packet::address_to_str(*task.address).c_str());
+
+        closing_ports_.push_back(*rp);
+        rp->async_close();
+
+        return false;
+    }
+
+    *task.address = rp->address();
+    open_ports_.push_back(*rp);
+
+    return true;
+}
+
+bool EventLoop::add_udp_sender_(Task& task) {
+    core::SharedPtr<UDPSenderPort> sp =
+        new (allocator_) UDPSenderPort(*task.address, ring_, waker_, allocator_,
+                                       task.direct_send);
+    if (!sp) {
+        roc_log(LogError, "event loop: can't add port %s: can't allocate sender",
+                packet::address_to_str(*task.address).c_str());
+
+        return false;
+    }
+
+    task.port = sp.get();
+
+    if (!sp->open()) {
+        roc_log(LogError, "event loop: can't add port %s: can't start sender",
+                packet::address_to_str(*task.address).c_str());
+
+        closing_ports_.push_back(*sp);
+        sp->async_close();
+
+        return false;
+    }
+
+    task.writer = sp.get();
+    *task.address = sp->address();
+
+    open_ports_.push_back(*sp);
+
+    return true;
+}
+
+bool EventLoop::remove_port_(Task& task) {
+    roc_log(LogDebug, "event loop: removing port %s",
+            packet::address_to_str(*task.address).c_str());
+
+    core::SharedPtr<BasicPort> curr = open_ports_.front();
+    while (curr) {
+        core::SharedPtr<BasicPort> next = open_ports_.nextof(*curr);
+
+        if (curr->address() == *task.address) {
+            open_ports_.remove(*curr);
+            closing_ports_.push_back(*curr);
+
+            task.port = curr.get();
+            curr->async_close();
+
+            return true;
+        }
+
+        curr = next;
+    }
+
+    return false;
+}
+
+void EventLoop::wait_port_closed_(const BasicPort& port) {
+    core::Mutex::Lock lock(mutex_);
+
+    while (port_is_closing_(port)) {
+        cond_.wait();
+    }
+}
+
+bool EventLoop::port_is_closing_(const BasicPort& port) {
+    for (BasicPort* pp = closing_ports_.front_borrowed(); pp;
+         pp = closing_ports_.nextof_borrowed(*pp)) {
+        if (pp == &port) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+} // namespace netio
+} // namespace roc
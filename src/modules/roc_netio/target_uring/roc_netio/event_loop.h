@@ -0,0 +1,214 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_netio/target_uring/roc_netio/event_loop.h
+//! @brief Network event loop.
+
+#ifndef ROC_NETIO_EVENT_LOOP_H_
+#define ROC_NETIO_EVENT_LOOP_H_
+
+#include <linux/io_uring.h>
+
+#include "roc_audio/units.h"
+#include "roc_core/buffer_pool.h"
+#include "roc_core/cond.h"
+#include "roc_core/iallocator.h"
+#include "roc_core/list.h"
+#include "roc_core/list_node.h"
+#include "roc_core/mutex.h"
+#include "roc_core/thread.h"
+#include "roc_netio/basic_port.h"
+#include "roc_netio/ioperation_handler.h"
+#include "roc_netio/udp_receiver_port.h"
+#include "roc_netio/udp_sender_port.h"
+#include "roc_netio/uring.h"
+#include "roc_netio/waker.h"
+#include "roc_packet/address.h"
+#include "roc_packet/iwriter.h"
+#include "roc_packet/packet_pool.h"
+
+namespace roc {
+namespace netio {
+
+//! Network event loop.
+//!
+//! Runs an io_uring event loop in a background thread and serves ports added
+//! to it. On every iteration, the loop submits all prepared operations and
+//! waits for completions using a single system call. Other threads wake up
+//! the loop using an eventfd, which is read by the loop itself.
+//!
+//! If @p trim_pools is set, also periodically trims packet and buffer pools,
+//! and the sample buffer pool if it's not NULL, from the network thread, so
+//! that memory allocated during a peak load is returned to the allocator.
+class EventLoop : private IOperationHandler, private core::Thread {
+public:
+    //! Initialize.
+    //!
+    //! @remarks
+    //!  Start background thread if the object was successfully constructed.
+    EventLoop(packet::PacketPool& packet_pool,
+              core::BufferPool<uint8_t>& buffer_pool,
+              core::BufferPool<audio::sample_t>* sample_buffer_pool,
+              core::IAllocator& allocator,
+              bool trim_pools);
+
+    //! Destroy. Stop all receivers and senders.
+    //!
+    //! @remarks
+    //!  Wait until background thread finishes.
+    virtual ~EventLoop();
+
+    //! Check if event loop was successfully constructed.
+    bool valid() const;
+
+    //! Get number of receiver and sender ports.
+    size_t num_ports() const;
+
+    //! Check if there is an open port bound to @p address.
+    bool has_port(const packet::Address& address) const;
+
+    //! Add UDP datagram receiver port.
+    //!
+    //! Creates a new UDP receiver and bind it to @p bind_address. The receiver
+    //! will pass packets to @p writer. Writer will be called from the network
+    //! thread. It should not block.
+    //!
+    //! If IP is zero, INADDR_ANY is used, i.e. the socket is bound to all network
+    //! interfaces. If port is zero, a random free port is selected and written
+    //! back to @p bind_address.
+    //!
+    //! If @p reuseport is set, the socket is bound with SO_REUSEPORT, so that
+    //! several receivers may share the same address.
+    //!
+    //! If @p timestamps is set, the receiver requests kernel arrival timestamps
+    //! for received packets, if supported.
+    //!
+    //! @returns
+    //!  true on success or false if error occurred
+    bool add_udp_receiver(packet::Address& bind_address,
+                          packet::IWriter& writer,
+                          bool reuseport,
+                          bool timestamps);
+
+    //! Add UDP datagram sender port.
+    //!
+    //! Creates a new UDP sender, bind to @p bind_address, and returns a writer
+    //! that may be used to send packets from this address. Writer may be called
+    //! from any thread. It will not block the caller.
+    //!
+    //! If @p direct_send is set, the writer sends packets to the socket by
+    //! itself, and passes them to the event loop only if the socket would
+    //! block.
+    //!
+    //! If IP is zero, INADDR_ANY is used, i.e. the socket is bound to all network
+    //! interfaces. If port is zero, a random free port is selected and written
+    //! back to @p bind_address.
+    //!
+    //! @returns
+    //!  a new packet writer on success or null if error occurred
+    packet::IWriter* add_udp_sender(packet::Address& bind_address, bool direct_send);
+
+    //! Remove sender or receiver port. Wait until port will be removed.
+    //!
+    //! @returns
+    //!  false if there is no port bound to @p bind_address
+    bool remove_port(packet::Address bind_address);
+
+private:
+    enum { NumEntries = 256 };
+
+    struct Task : core::ListNode {
+        bool (EventLoop::*fn)(Task&);
+
+        packet::Address* address;
+        packet::IWriter* writer;
+        BasicPort* port;
+        bool reuseport;
+        bool timestamps;
+        bool direct_send;
+
+        bool result;
+        bool done;
+
+        Task()
+            : fn(NULL)
+            , address(NULL)
+            , writer(NULL)
+            , port(NULL)
+            , reuseport(false)
+            , timestamps(false)
+            , direct_send(false)
+            , result(false)
+            , done(false) {
+        }
+    };
+
+    virtual void handle_completion(Operation& op, int res, unsigned flags);
+    virtual void run();
+
+    void handle_wake_(int res);
+    void handle_trim_(int res);
+
+    bool start_wake_();
+    bool start_trim_();
+    void stop_trim_();
+
+    void flush_ports_();
+    void reap_ports_();
+    void async_close_ports_();
+
+    void process_tasks_();
+    void run_task_(Task&);
+
+    bool add_udp_receiver_(Task&);
+    bool add_udp_sender_(Task&);
+
+    bool remove_port_(Task&);
+    void wait_port_closed_(const BasicPort& port);
+    bool port_is_closing_(const BasicPort& port);
+
+    packet::PacketPool& packet_pool_;
+    core::BufferPool<uint8_t>& buffer_pool_;
+    core::BufferPool<audio::sample_t>* sample_buffer_pool_;
+    core::IAllocator& allocator_;
+
+    const bool trim_pools_;
+
+    bool started_;
+
+    Uring ring_;
+    Waker waker_;
+
+    Operation wake_op_;
+    uint64_t wake_value_;
+
+    Operation trim_op_;
+    __kernel_timespec trim_interval_;
+
+    Operation cancel_op_;
+
+    size_t pending_ops_;
+
+    int stop_;
+    bool stopping_;
+
+    unsigned next_buf_group_;
+
+    core::List<Task, core::NoOwnership> tasks_;
+
+    core::List<BasicPort> open_ports_;
+    core::List<BasicPort> closing_ports_;
+
+    core::Mutex mutex_;
+    core::Cond cond_;
+};
+
+} // namespace netio
+} // namespace roc
+
+#endif // ROC_NETIO_EVENT_LOOP_H_
@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_netio/target_uring/roc_netio/ioperation_handler.h
+//! @brief Operation completion handler interface.
+
+#ifndef ROC_NETIO_IOPERATION_HANDLER_H_
+#define ROC_NETIO_IOPERATION_HANDLER_H_
+
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace netio {
+
+class IOperationHandler;
+
+//! Asynchronous io_uring operation.
+//! @remarks
+//!  Address of the operation is passed as user data of the submission entry
+//!  and is returned back in the completion entry, so that the event loop can
+//!  find the handler of the completion.
+struct Operation {
+    //! Completion handler.
+    IOperationHandler* handler;
+
+    Operation()
+        : handler(NULL) {
+    }
+};
+
+//! Operation completion handler interface.
+class IOperationHandler {
+public:
+    virtual ~IOperationHandler();
+
+    //! Handle operation completion.
+    //!
+    //! @remarks
+    //!  - @p res and @p flags are taken from the completion entry.
+    //!  - Should be called from the event loop thread.
+    virtual void handle_completion(Operation& op, int res, unsigned flags) = 0;
+};
+
+} // namespace netio
+} // namespace roc
+
+#endif // ROC_NETIO_IOPERATION_HANDLER_H_
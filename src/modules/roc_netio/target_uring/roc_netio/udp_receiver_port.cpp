@@ -0,0 +1,472 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <time.h>
+
+#include "roc_core/atomic_ops.h"
+#include "roc_core/errno_to_str.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+#include "roc_netio/udp_receiver_port.h"
+#include "roc_netio/udp_socket.h"
+#include "roc_packet/address_to_str.h"
+
+namespace roc {
+namespace netio {
+
+namespace {
+
+const core::nanoseconds_t TruncatedLogInterval = 5 * core::Second;
+
+core::nanoseconds_t find_timestamp(uint8_t* control, size_t control_len) {
+#ifdef SCM_TIMESTAMPNS
+    msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+
+    msg.msg_control = control;
+    msg.msg_controllen = control_len;
+
+    for (cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+        if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_TIMESTAMPNS
+            || cmsg->cmsg_len < CMSG_LEN(sizeof(timespec))) {
+            continue;
+        }
+
+        // control messages follow the source address and may be unaligned
+        timespec ts;
+        memcpy(&ts, CMSG_DATA(cmsg), sizeof(ts));
+
+        return core::nanoseconds_t(ts.tv_sec) * core::Second + ts.tv_nsec;
+    }
+#else
+    (void)control;
+    (void)control_len;
+#endif
+
+    return 0;
+}
+
+} // namespace
+
+UDPReceiverPort::UDPReceiverPort(const packet::Address& address,
+                                 Uring& ring,
+                                 unsigned buf_group,
+                                 packet::IWriter& writer,
+                                 packet::PacketPool& packet_pool,
+                                 core::BufferPool<uint8_t>& buffer_pool,
+                                 core::IAllocator& allocator,
+                                 bool reuseport,
+                                 bool timestamps)
+    : BasicPort(allocator)
+    , ring_(ring)
+    , buf_group_(buf_group)
+    , fd_(-1)
+    , buf_ring_(NULL)
+    , buf_ring_size_(0)
+    , buf_ring_registered_(false)
+    , buf_ring_tail_(0)
+    , pending_ops_(0)
+    , recv_started_(false)
+    , cancel_needed_(false)
+    , closing_(false)
+    , closed_(false)
+    , address_(address)
+    , writer_(writer)
+    , packet_pool_(packet_pool)
+    , buffer_pool_(buffer_pool)
+    , reuseport_(reuseport)
+    , timestamps_requested_(timestamps)
+    , timestamps_(false)
+    , batch_size_(0)
+    , packet_counter_(0)
+    , num_truncated_(0)
+    , truncated_limiter_(TruncatedLogInterval) {
+    memset(&msg_, 0, sizeof(msg_));
+
+    recv_op_.handler = this;
+    cancel_op_.handler = this;
+}
+
+UDPReceiverPort::~UDPReceiverPort() {
+    if (fd_ != -1 || buf_ring_ || pending_ops_ != 0) {
+        roc_panic(
+            "udp receiver: receiver was not fully closed before calling destructor");
+    }
+}
+
+bool UDPReceiverPort::reuseport_supported() {
+#ifdef SO_REUSEPORT
+    return true;
+#else
+    return false;
+#endif
+}
+
+size_t UDPReceiverPort::buffer_overhead() {
+    return sizeof(io_uring_recvmsg_out) + sizeof(sockaddr_in6)
+        + CMSG_SPACE(sizeof(timespec));
+}
+
+const packet::Address& UDPReceiverPort::address() const {
+    return address_;
+}
+
+bool UDPReceiverPort::open() {
+    fd_ = udp_socket_open(address_, reuseport_);
+    if (fd_ == -1) {
+        return false;
+    }
+
+    if (timestamps_requested_) {
+        timestamps_ = udp_socket_enable_timestamps(fd_);
+    }
+
+    // the kernel reserves msg_namelen bytes for the source address and
+    // msg_controllen bytes for control messages in every buffer
+    msg_.msg_namelen = address_.slen();
+    if (timestamps_) {
+        msg_.msg_controllen = CMSG_SPACE(sizeof(timespec));
+    }
+
+    if (!setup_buffers_()) {
+        return false;
+    }
+
+    if (!start_recv_()) {
+        return false;
+    }
+
+    roc_log(LogInfo, "udp receiver: opened port %s",
+            packet::address_to_str(address_).c_str());
+
+    return true;
+}
+
+void UDPReceiverPort::async_close() {
+    if (closing_) {
+        return;
+    }
+
+    roc_log(LogInfo, "udp receiver: closing port %s",
+            packet::address_to_str(address_).c_str());
+
+    closing_ = true;
+
+    flush();
+
+    if (recv_started_) {
+        cancel_needed_ = !cancel_recv_();
+    }
+
+    if (pending_ops_ == 0) {
+        finish_close_();
+    }
+}
+
+bool UDPReceiverPort::closed() const {
+    return closed_;
+}
+
+void UDPReceiverPort::flush() {
+    if (cancel_needed_) {
+        cancel_needed_ = !cancel_recv_();
+    }
+
+    if (batch_size_ == 0) {
+        return;
+    }
+
+    writer_.write_many(batch_, batch_size_);
+
+    for (size_t n = 0; n < batch_size_; n++) {
+        batch_[n] = NULL;
+    }
+
+    batch_size_ = 0;
+}
+
+void UDPReceiverPort::handle_completion(Operation& op, int res, unsigned flags) {
+    if (&op == &recv_op_) {
+        handle_recv_(res, flags);
+    } else if (&op == &cancel_op_) {
+        roc_panic_if(pending_ops_ == 0);
+        pending_ops_--;
+    } else {
+        roc_panic("udp receiver: unexpected operation");
+    }
+
+    if (closing_ && !closed_ && pending_ops_ == 0) {
+        finish_close_();
+    }
+}
+
+bool UDPReceiverPort::setup_buffers_() {
+    if (buffer_pool_.buffer_size()
+        <= sizeof(io_uring_recvmsg_out) + msg_.msg_namelen + msg_.msg_controllen) {
+        roc_log(LogError, "udp receiver: buffer size is too small: size=%lu",
+                (unsigned long)buffer_pool_.buffer_size());
+        return false;
+    }
+
+    buf_ring_size_ = NumBuffers * sizeof(io_uring_buf);
+
+    // the ring should be page-aligned
+    void* ring = mmap(NULL, buf_ring_size_, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (ring == MAP_FAILED) {
+        roc_log(LogError, "udp receiver: can't allocate buffer ring: %s",
+                core::errno_to_str().c_str());
+        return false;
+    }
+
+    buf_ring_ = (io_uring_buf*)ring;
+
+    if (int err = ring_.register_buf_ring(buf_ring_, NumBuffers, buf_group_)) {
+        roc_log(LogError, "udp receiver: can't register buffer ring: %s",
+                core::errno_to_str(-err).c_str());
+        return false;
+    }
+
+    buf_ring_registered_ = true;
+
+    for (unsigned buf_id = 0; buf_id < NumBuffers; buf_id++) {
+        buffers_[buf_id] = new (buffer_pool_) core::Buffer<uint8_t>(buffer_pool_);
+        if (!buffers_[buf_id]) {
+            roc_log(LogError, "udp receiver: can't allocate buffer");
+            return false;
+        }
+
+        provide_buffer_(buf_id);
+    }
+
+    return true;
+}
+
+void UDPReceiverPort::release_buffers_() {
+    if (buf_ring_registered_) {
+        if (int err = ring_.unregister_buf_ring(buf_group_)) {
+            roc_log(LogError, "udp receiver: can't unregister buffer ring: %s",
+                    core::errno_to_str(-err).c_str());
+        }
+        buf_ring_registered_ = false;
+    }
+
+    if (buf_ring_) {
+        munmap(buf_ring_, buf_ring_size_);
+        buf_ring_ = NULL;
+    }
+
+    for (unsigned buf_id = 0; buf_id < NumBuffers; buf_id++) {
+        buffers_[buf_id] = NULL;
+    }
+}
+
+void UDPReceiverPort::provide_buffer_(unsigned buf_id) {
+    core::Buffer<uint8_t>& buffer = *buffers_[buf_id];
+
+    io_uring_buf& entry = buf_ring_[buf_ring_tail_ & (NumBuffers - 1)];
+
+    entry.addr = (unsigned long)buffer.data();
+    entry.len = (__u32)buffer.size();
+    entry.bid = (__u16)buf_id;
+
+    buf_ring_tail_++;
+
+    // the tail is stored in place of the reserved field of the first entry
+    core::AtomicOps::store_release(buf_ring_[0].resv, (__u16)buf_ring_tail_);
+}
+
+bool UDPReceiverPort::start_recv_() {
+    io_uring_sqe* sqe = ring_.get_sqe();
+    if (!sqe) {
+        roc_log(LogError,
+                "udp receiver: can't start receiving: submission queue is full");
+        return false;
+    }
+
+    sqe->opcode = IORING_OP_RECVMSG;
+    sqe->fd = fd_;
+    sqe->addr = (unsigned long)&msg_;
+    sqe->len = 1;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = (__u16)buf_group_;
+    sqe->user_data = (unsigned long)&recv_op_;
+
+    recv_started_ = true;
+    pending_ops_++;
+
+    return true;
+}
+
+bool UDPReceiverPort::cancel_recv_() {
+    io_uring_sqe* sqe = ring_.get_sqe();
+    if (!sqe) {
+        return false;
+    }
+
+    sqe->opcode = IORING_OP_ASYNC_CANCEL;
+    sqe->fd = -1;
+    sqe->addr = (unsigned long)&recv_op_;
+    sqe->user_data = (unsigned long)&cancel_op_;
+
+    pending_ops_++;
+
+    return true;
+}
+
+void UDPReceiverPort::handle_recv_(int res, unsigned flags) {
+    if (flags & IORING_CQE_F_BUFFER) {
+        const unsigned buf_id = flags >> IORING_CQE_BUFFER_SHIFT;
+        roc_panic_if(buf_id >= NumBuffers);
+
+        if (res > 0 && !closing_) {
+            handle_datagram_(buf_id, (size_t)res);
+        } else {
+            provide_buffer_(buf_id);
+        }
+    }
+
+    if (res < 0 && res != -ECANCELED && res != -ENOBUFS) {
+        roc_log(LogError, "udp receiver: recvmsg(): %s",
+                core::errno_to_str(-res).c_str());
+    }
+
+    if (flags & IORING_CQE_F_MORE) {
+        return;
+    }
+
+    // multishot operation was terminated
+    roc_panic_if(pending_ops_ == 0);
+    pending_ops_--;
+
+    recv_started_ = false;
+
+    // ENOBUFS means that all buffers are in use and the operation can be
+    // restarted after they are returned to the ring; other errors are fatal
+    if (!closing_ && (res >= 0 || res == -ENOBUFS)) {
+        start_recv_();
+    }
+}
+
+void UDPReceiverPort::handle_datagram_(unsigned buf_id, size_t size) {
+    core::SharedPtr<core::Buffer<uint8_t> > bp = buffers_[buf_id];
+
+    // replace buffer in the ring before passing this one to the pipeline;
+    // if there is no memory, drop the datagram and reuse its buffer
+    core::SharedPtr<core::Buffer<uint8_t> > new_bp =
+        new (buffer_pool_) core::Buffer<uint8_t>(buffer_pool_);
+
+    if (!new_bp) {
+        roc_log(LogError, "udp receiver: can't allocate buffer");
+        provide_buffer_(buf_id);
+        return;
+    }
+
+    buffers_[buf_id] = new_bp;
+    provide_buffer_(buf_id);
+
+    const io_uring_recvmsg_out& out = *(const io_uring_recvmsg_out*)bp->data();
+
+    const size_t payload_off =
+        sizeof(io_uring_recvmsg_out) + msg_.msg_namelen + msg_.msg_controllen;
+
+    if (size < payload_off || out.namelen > msg_.msg_namelen
+        || out.controllen > msg_.msg_controllen) {
+        roc_log(LogError, "udp receiver: unexpected recvmsg result: size=%lu",
+                (unsigned long)size);
+        return;
+    }
+
+    packet::Address src_addr;
+    if (!src_addr.set_saddr((const sockaddr*)(bp->data() + sizeof(out)))) {
+        roc_log(LogError,
+                "udp receiver: can't determine source address: num=%u dst=%s",
+                packet_counter_, packet::address_to_str(address_).c_str());
+    }
+
+    if ((out.flags & MSG_TRUNC) || payload_off + out.payloadlen > size) {
+        num_truncated_++;
+
+        roc_log(LogDebug,
+                "udp receiver: ignoring truncated packet: num=%u src=%s dst=%s size=%lu",
+                packet_counter_, packet::address_to_str(src_addr).c_str(),
+                packet::address_to_str(address_).c_str(), (unsigned long)out.payloadlen);
+
+        if (truncated_limiter_.allow()) {
+            roc_log(LogError,
+                    "udp receiver: dropped truncated packets, pool buffers are too"
+                    " small: dst=%s max_size=%lu num_truncated=%lu",
+                    packet::address_to_str(address_).c_str(),
+                    (unsigned long)(buffer_pool_.buffer_size() - payload_off),
+                    (unsigned long)num_truncated_);
+        }
+        return;
+    }
+
+    if (out.payloadlen == 0) {
+        roc_log(LogTrace, "udp receiver: empty packet: num=%u src=%s dst=%s",
+                packet_counter_, packet::address_to_str(src_addr).c_str(),
+                packet::address_to_str(address_).c_str());
+        return;
+    }
+
+    packet_counter_++;
+
+    roc_log(LogTrace, "udp receiver: received packet: num=%u src=%s dst=%s nread=%ld",
+            packet_counter_, packet::address_to_str(src_addr).c_str(),
+            packet::address_to_str(address_).c_str(), (long)out.payloadlen);
+
+    packet::PacketPtr pp = new (packet_pool_) packet::Packet(packet_pool_);
+    if (!pp) {
+        roc_log(LogError, "udp receiver: can't allocate packet");
+        return;
+    }
+
+    pp->add_flags(packet::Packet::FlagUDP);
+
+    pp->udp()->src_addr = src_addr;
+    pp->udp()->dst_addr = address_;
+
+    if (timestamps_) {
+        pp->udp()->receive_timestamp =
+            find_timestamp(bp->data() + sizeof(out) + msg_.msg_namelen, out.controllen);
+    }
+
+    pp->set_data(core::Slice<uint8_t>(*bp, payload_off, payload_off + out.payloadlen));
+
+    batch_[batch_size_++] = pp;
+
+    if (batch_size_ == MaxBatchSize) {
+        flush();
+    }
+}
+
+void UDPReceiverPort::finish_close_() {
+    roc_panic_if(pending_ops_ != 0);
+
+    flush();
+
+    release_buffers_();
+
+    if (fd_ != -1) {
+        udp_socket_close(fd_);
+        fd_ = -1;
+    }
+
+    roc_log(LogInfo, "udp receiver: closed port %s",
+            packet::address_to_str(address_).c_str());
+
+    closed_ = true;
+}
+
+} // namespace netio
+} // namespace roc
@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_netio/target_uring/roc_netio/udp_receiver_port.h
+//! @brief UDP receiver.
+
+#ifndef ROC_NETIO_UDP_RECEIVER_PORT_H_
+#define ROC_NETIO_UDP_RECEIVER_PORT_H_
+
+#include <linux/io_uring.h>
+#include <sys/socket.h>
+
+#include "roc_core/buffer_pool.h"
+#include "roc_core/iallocator.h"
+#include "roc_core/rate_limiter.h"
+#include "roc_core/shared_ptr.h"
+#include "roc_netio/basic_port.h"
+#include "roc_netio/uring.h"
+#include "roc_packet/address.h"
+#include "roc_packet/iwriter.h"
+#include "roc_packet/packet_pool.h"
+
+namespace roc {
+namespace netio {
+
+//! UDP receiver.
+//! @remarks
+//!  Uses a single multishot recvmsg operation, which produces a completion
+//!  for every received datagram without resubmission. The kernel selects
+//!  buffers from a provided buffer ring filled with buffers from the buffer
+//!  pool, and received packets reference these buffers directly.
+//!
+//!  The kernel puts a small header with the source address and the arrival
+//!  timestamp at the beginning of the buffer, so pool buffers should be
+//!  buffer_overhead() bytes larger than the largest packet. Larger packets
+//!  are truncated by the kernel; they're dropped, counted, and reported in
+//!  the log.
+//!
+//!  If timestamps are enabled and the kernel supports SO_TIMESTAMPNS, the
+//!  arrival timestamp of every datagram is stored in the UDP part of the
+//!  packet.
+//!
+//!  Received packets are collected into a batch and passed to the writer
+//!  using a single write_many() call after every portion of completions.
+//!
+//!  If reuseport is enabled, the socket is bound with SO_REUSEPORT, so that
+//!  several receivers may be bound to the same address. The kernel then
+//!  distributes datagrams between them by the hash of the source address.
+class UDPReceiverPort : public BasicPort {
+public:
+    //! Initialize.
+    //! @remarks
+    //!  @p buf_group should be unique among ports of @p ring.
+    UDPReceiverPort(const packet::Address&,
+                    Uring& ring,
+                    unsigned buf_group,
+                    packet::IWriter& writer,
+                    packet::PacketPool& packet_pool,
+                    core::BufferPool<uint8_t>& buffer_pool,
+                    core::IAllocator& allocator,
+                    bool reuseport,
+                    bool timestamps);
+
+    //! Destroy.
+    ~UDPReceiverPort();
+
+    //! Check if reuseport may be enabled on this platform.
+    static bool reuseport_supported();
+
+    //! Get number of bytes reserved in every pool buffer.
+    //! @remarks
+    //!  The kernel puts a header before the payload of every datagram.
+    static size_t buffer_overhead();
+
+    //! Get bind address.
+    virtual const packet::Address& address() const;
+
+    //! Open receiver.
+    virtual bool open();
+
+    //! Start closing receiver.
+    virtual void async_close();
+
+    //! Check if receiver was closed.
+    virtual bool closed() const;
+
+    //! Pass received packets to writer.
+    virtual void flush();
+
+    //! Handle operation completion.
+    virtual void handle_completion(Operation& op, int res, unsigned flags);
+
+private:
+    enum { NumBuffers = 128, MaxBatchSize = 32 };
+
+    bool setup_buffers_();
+    void release_buffers_();
+    void provide_buffer_(unsigned buf_id);
+
+    bool start_recv_();
+    bool cancel_recv_();
+
+    void handle_recv_(int res, unsigned flags);
+    void handle_datagram_(unsigned buf_id, size_t size);
+
+    void finish_close_();
+
+    Uring& ring_;
+    const unsigned buf_group_;
+
+    int fd_;
+
+    io_uring_buf* buf_ring_;
+    size_t buf_ring_size_;
+    bool buf_ring_registered_;
+    unsigned buf_ring_tail_;
+
+    core::SharedPtr<core::Buffer<uint8_t> > buffers_[NumBuffers];
+
+    msghdr msg_;
+
+    Operation recv_op_;
+    Operation cancel_op_;
+
+    size_t pending_ops_;
+
+    bool recv_started_;
+    bool cancel_needed_;
+    bool closing_;
+    bool closed_;
+
+    packet::Address address_;
+    packet::IWriter& writer_;
+
+    packet::PacketPool& packet_pool_;
+    core::BufferPool<uint8_t>& buffer_pool_;
+
+    const bool reuseport_;
+    const bool timestamps_requested_;
+    bool timestamps_;
+
+    packet::PacketPtr batch_[MaxBatchSize];
+    size_t batch_size_;
+
+    unsigned packet_counter_;
+
+    size_t num_truncated_;
+    core::RateLimiter truncated_limiter_;
+};
+
+} // namespace netio
+} // namespace roc
+
+#endif // ROC_NETIO_UDP_RECEIVER_PORT_H_
@@ -0,0 +1,358 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <sys/socket.h>
+
+#include "roc_core/atomic_ops.h"
+#include "roc_core/errno_to_str.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+#include "roc_netio/udp_sender_port.h"
+#include "roc_netio/udp_socket.h"
+#include "roc_packet/address_to_str.h"
+
+namespace roc {
+namespace netio {
+
+namespace {
+
+// flags stored in the high bits of the writers counter
+const size_t ClosedFlag = ~(~size_t(0) >> 1);
+const size_t StoppedFlag = ClosedFlag >> 1;
+
+} // namespace
+
+UDPSenderPort::UDPSenderPort(const packet::Address& address,
+                             Uring& ring,
+                             Waker& waker,
+                             core::IAllocator& allocator,
+                             bool direct_send)
+    : BasicPort(allocator)
+    , ring_(ring)
+    , waker_(waker)
+    , fd_(-1)
+    , address_(address)
+    , request_pool_(allocator, sizeof(SendRequest), false)
+    , pending_(0)
+    , writers_(StoppedFlag)
+    , direct_send_(direct_send)
+    , inflight_(0)
+    , closing_(false)
+    , closed_(false)
+    , packet_counter_(0) {
+}
+
+UDPSenderPort::~UDPSenderPort() {
+    if (fd_ != -1 || inflight_ != 0) {
+        roc_panic("udp sender: sender was not fully closed before calling destructor");
+    }
+}
+
+const packet::Address& UDPSenderPort::address() const {
+    return address_;
+}
+
+bool UDPSenderPort::open() {
+    fd_ = udp_socket_open(address_, false);
+    if (fd_ == -1) {
+        return false;
+    }
+
+    roc_log(LogInfo, "udp sender: opened port %s",
+            packet::address_to_str(address_).c_str());
+
+    // allow writes
+    core::AtomicOps::store_seq_cst(writers_, 0);
+
+    return true;
+}
+
+void UDPSenderPort::async_close() {
+    if (closing_) {
+        return;
+    }
+
+    roc_log(LogInfo, "udp sender: closing port %s",
+            packet::address_to_str(address_).c_str());
+
+    // only the event loop changes flags, so there is no race with other
+    // modifications of the flags
+    if (!(core::AtomicOps::load_seq_cst(writers_) & StoppedFlag)) {
+        core::AtomicOps::fetch_add_seq_cst(writers_, StoppedFlag);
+    }
+
+    closing_ = true;
+
+    flush();
+    try_finish_close_();
+}
+
+bool UDPSenderPort::closed() const {
+    return closed_;
+}
+
+void UDPSenderPort::flush() {
+    if (fd_ != -1) {
+        send_queued_();
+    }
+
+    // writers that left after the port was stopped wake us up to retry
+    try_finish_close_();
+}
+
+void UDPSenderPort::send_queued_() {
+    core::Mutex::Lock lock(send_mutex_);
+
+    packet::PacketPtr packets[MaxBatchSize];
+
+    while (inflight_ < MaxInflight) {
+        size_t max_packets = MaxInflight - inflight_;
+        if (max_packets > MaxBatchSize) {
+            max_packets = MaxBatchSize;
+        }
+
+        const size_t n_packets = read_many_(packets, max_packets);
+        if (n_packets == 0) {
+            break;
+        }
+
+        for (size_t n = 0; n < n_packets; n++) {
+            if (!send_(packets[n])) {
+                core::AtomicOps::fetch_sub_acq_rel(pending_, 1);
+            }
+            packets[n] = NULL;
+        }
+    }
+}
+
+void UDPSenderPort::handle_completion(Operation& op, int res, unsigned) {
+    SendRequest& req = (SendRequest&)op;
+
+    if (res < 0) {
+        roc_log(LogDebug, "udp sender: sendmsg(): num=%u dst=%s: %s", packet_counter_,
+                packet::address_to_str(req.packet->udp()->dst_addr).c_str(),
+                core::errno_to_str(-res).c_str());
+    }
+
+    request_pool_.destroy(req);
+
+    roc_panic_if(inflight_ == 0);
+    inflight_--;
+
+    core::AtomicOps::fetch_sub_acq_rel(pending_, 1);
+
+    try_finish_close_();
+}
+
+void UDPSenderPort::write(const packet::PacketPtr& pp) {
+    write_many(&pp, 1);
+}
+
+void UDPSenderPort::write_many(const packet::PacketPtr* packets, size_t n_packets) {
+    for (size_t n = 0; n < n_packets; n++) {
+        const packet::PacketPtr& pp = packets[n];
+
+        if (!pp) {
+            roc_panic("udp sender: unexpected null packet");
+        }
+
+        if (!pp->udp()) {
+            roc_panic("udp sender: unexpected non-udp packet");
+        }
+
+        if (!pp->data()) {
+            roc_panic("udp sender: unexpected packet w/o data");
+        }
+    }
+
+    // while the writers counter is non-zero, the event loop won't close the
+    // port, so it's safe to use the socket
+    const size_t state = core::AtomicOps::fetch_add_seq_cst(writers_, 1);
+
+    if (state & ClosedFlag) {
+        core::AtomicOps::fetch_sub_release(writers_, 1);
+        return;
+    }
+
+    if (!(state & StoppedFlag)) {
+        size_t n_sent = 0;
+
+        if (direct_send_) {
+            n_sent = try_send_direct_(packets, n_packets);
+        }
+
+        if (n_sent < n_packets) {
+            enqueue_(packets + n_sent, n_packets - n_sent);
+        }
+    }
+
+    leave_writer_();
+}
+
+void UDPSenderPort::leave_writer_() {
+    size_t state = core::AtomicOps::load_seq_cst(writers_);
+
+    for (;;) {
+        if (state & StoppedFlag) {
+            // the event loop may be waiting for us to close the port; the
+            // flag can't be replaced with ClosedFlag until we leave
+            waker_.wake();
+            core::AtomicOps::fetch_sub_release(writers_, 1);
+            return;
+        }
+
+        if (core::AtomicOps::compare_exchange_acq_rel(writers_, state, state - 1)) {
+            return;
+        }
+    }
+}
+
+size_t UDPSenderPort::try_send_direct_(const packet::PacketPtr* packets,
+                                       size_t n_packets) {
+    // if another writer or the event loop is sending, don't wait for it
+    if (!send_mutex_.try_lock()) {
+        return 0;
+    }
+
+    size_t n_sent = 0;
+
+    // don't bypass queued and in-flight packets, to keep the order
+    if (core::AtomicOps::load_seq_cst(pending_) == 0) {
+        for (; n_sent < n_packets; n_sent++) {
+            packet::Packet& pp = *packets[n_sent];
+            packet::UDP& udp = *pp.udp();
+
+            ssize_t ret;
+            do {
+                ret = sendto(fd_, pp.data().data(), pp.data().size(), 0,
+                             udp.dst_addr.saddr(), udp.dst_addr.slen());
+            } while (ret == -1 && errno == EINTR);
+
+            if (ret == -1) {
+                // pass this and remaining packets to the event loop, which will
+                // wait until the socket is writable or report the error
+                break;
+            }
+
+            packet_counter_++;
+
+            roc_log(LogTrace, "udp sender: sent packet: num=%u src=%s dst=%s sz=%ld",
+                    packet_counter_, packet::address_to_str(address_).c_str(),
+                    packet::address_to_str(udp.dst_addr).c_str(),
+                    (long)pp.data().size());
+        }
+    }
+
+    send_mutex_.unlock();
+
+    return n_sent;
+}
+
+void UDPSenderPort::enqueue_(const packet::PacketPtr* packets, size_t n_packets) {
+    core::AtomicOps::fetch_add_seq_cst(pending_, n_packets);
+
+    for (size_t n = 0; n < n_packets; n++) {
+        queue_.push_back(*packets[n]);
+    }
+
+    waker_.wake();
+}
+
+size_t UDPSenderPort::read_many_(packet::PacketPtr* packets, size_t max_packets) {
+    size_t n_packets = 0;
+
+    for (; n_packets < max_packets; n_packets++) {
+        packet::PacketPtr pp = queue_.pop_front();
+        if (!pp) {
+            break;
+        }
+
+        packets[n_packets] = pp;
+    }
+
+    return n_packets;
+}
+
+bool UDPSenderPort::send_(const packet::PacketPtr& pp) {
+    packet::UDP& udp = *pp->udp();
+
+    packet_counter_++;
+
+    roc_log(LogTrace, "udp sender: sending packet: num=%u src=%s dst=%s sz=%ld",
+            packet_counter_, packet::address_to_str(address_).c_str(),
+            packet::address_to_str(udp.dst_addr).c_str(), (long)pp->data().size());
+
+    SendRequest* req = new (request_pool_) SendRequest;
+    if (!req) {
+        roc_log(LogError, "udp sender: can't allocate send request");
+        return false;
+    }
+
+    io_uring_sqe* sqe = ring_.get_sqe();
+    if (!sqe) {
+        roc_log(LogError, "udp sender: can't send packet: submission queue is full");
+        request_pool_.destroy(*req);
+        return false;
+    }
+
+    req->handler = this;
+    req->packet = pp;
+
+    req->iov.iov_base = pp->data().data();
+    req->iov.iov_len = pp->data().size();
+
+    memset(&req->msg, 0, sizeof(req->msg));
+    req->msg.msg_name = udp.dst_addr.saddr();
+    req->msg.msg_namelen = udp.dst_addr.slen();
+    req->msg.msg_iov = &req->iov;
+    req->msg.msg_iovlen = 1;
+
+    sqe->opcode = IORING_OP_SENDMSG;
+    sqe->fd = fd_;
+    sqe->addr = (unsigned long)&req->msg;
+    sqe->len = 1;
+    sqe->user_data = (unsigned long)(Operation*)req;
+
+    inflight_++;
+
+    return true;
+}
+
+void UDPSenderPort::try_finish_close_() {
+    if (!closing_ || closed_ || inflight_ != 0) {
+        return;
+    }
+
+    // writers that have not seen StoppedFlag may still push packets and use
+    // the socket; don't wait for them, they wake us up when they leave
+    size_t state = StoppedFlag;
+    if (!core::AtomicOps::compare_exchange_acq_rel(writers_, state,
+                                                   StoppedFlag | ClosedFlag)
+        && !(state & ClosedFlag)) {
+        return;
+    }
+
+    if (core::AtomicOps::load_seq_cst(pending_) != 0) {
+        return;
+    }
+
+    if (fd_ != -1) {
+        udp_socket_close(fd_);
+        fd_ = -1;
+    }
+
+    roc_log(LogInfo, "udp sender: closed port %s",
+            packet::address_to_str(address_).c_str());
+
+    closed_ = true;
+}
+
+} // namespace netio
+} // namespace roc
@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_netio/target_uring/roc_netio/udp_sender_port.h
+//! @brief UDP sender.
+
+#ifndef ROC_NETIO_UDP_SENDER_PORT_H_
+#define ROC_NETIO_UDP_SENDER_PORT_H_
+
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#include "roc_core/iallocator.h"
+#include "roc_core/mpsc_queue.h"
+#include "roc_core/mutex.h"
+#include "roc_core/pool.h"
+#include "roc_netio/basic_port.h"
+#include "roc_netio/uring.h"
+#include "roc_netio/waker.h"
+#include "roc_packet/address.h"
+#include "roc_packet/iwriter.h"
+
+namespace roc {
+namespace netio {
+
+//! UDP sender.
+//! @remarks
+//!  Packets written to the port are pushed to a lock-free queue and the event
+//!  loop is woken up, unless it was already woken up and didn't drain the
+//!  queue yet.
+//!  The event loop then prepares a sendmsg operation for every queued packet,
+//!  and all of them are submitted to the kernel using a single system call,
+//!  together with operations of other ports.
+//!
+//!  If direct sending is enabled, the writer first tries to send packets to
+//!  the non-blocking socket by itself, and queues only packets that can't be
+//!  sent immediately. Packets are never sent directly while there are queued
+//!  or in-flight packets, so their order is preserved.
+class UDPSenderPort : public BasicPort, public packet::IWriter {
+public:
+    //! Initialize.
+    UDPSenderPort(const packet::Address&,
+                  Uring& ring,
+                  Waker& waker,
+                  core::IAllocator& allocator,
+                  bool direct_send);
+
+    //! Destroy.
+    ~UDPSenderPort();
+
+    //! Get bind address.
+    virtual const packet::Address& address() const;
+
+    //! Open sender.
+    virtual bool open();
+
+    //! Start closing sender.
+    //! @remarks
+    //!  Packets that were already queued are still sent.
+    virtual void async_close();
+
+    //! Check if sender was closed.
+    virtual bool closed() const;
+
+    //! Submit queued packets.
+    virtual void flush();
+
+    //! Handle operation completion.
+    virtual void handle_completion(Operation& op, int res, unsigned flags);
+
+    //! Write packet.
+    //! @remarks
+    //!  May be called from any thread.
+    virtual void write(const packet::PacketPtr&);
+
+    //! Write multiple packets.
+    //! @remarks
+    //!  May be called from any thread. Doesn't block and doesn't wake up the
+    //!  event loop if it's already woken up.
+    virtual void write_many(const packet::PacketPtr* packets, size_t n_packets);
+
+private:
+    enum { MaxInflight = 256, MaxBatchSize = 64 };
+
+    struct SendRequest : Operation {
+        packet::PacketPtr packet;
+        msghdr msg;
+        iovec iov;
+    };
+
+    void leave_writer_();
+
+    void send_queued_();
+
+    size_t try_send_direct_(const packet::PacketPtr* packets, size_t n_packets);
+    void enqueue_(const packet::PacketPtr* packets, size_t n_packets);
+
+    size_t read_many_(packet::PacketPtr* packets, size_t max_packets);
+    bool send_(const packet::PacketPtr& packet);
+
+    void try_finish_close_();
+
+    Uring& ring_;
+    Waker& waker_;
+
+    int fd_;
+
+    packet::Address address_;
+
+    core::Pool<SendRequest> request_pool_;
+
+    core::MpscQueue<packet::Packet> queue_;
+
+    // accessed atomically
+    size_t pending_;
+    size_t writers_; // number of writers in write_many() and stop flags
+
+    const bool direct_send_;
+
+    // serializes sending between the event loop and direct writers
+    core::Mutex send_mutex_;
+
+    size_t inflight_;
+    bool closing_;
+    bool closed_;
+
+    unsigned packet_counter_;
+};
+
+} // namespace netio
+} // namespace roc
+
+#endif // ROC_NETIO_UDP_SENDER_PORT_H_
@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <errno.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "roc_core/errno_to_str.h"
+#include "roc_core/log.h"
+#include "roc_netio/udp_socket.h"
+
+namespace roc {
+namespace netio {
+
+int udp_socket_open(packet::Address& address, bool reuseport) {
+    const int fd =
+        socket(address.saddr()->sa_family, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd == -1) {
+        roc_log(LogError, "udp socket: socket(): %s", core::errno_to_str().c_str());
+        return -1;
+    }
+
+    int one = 1;
+
+    if (address.multicast() && address.port() > 0) {
+        if (setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one)) != 0) {
+            roc_log(LogError, "udp socket: setsockopt(SO_REUSEADDR): %s",
+                    core::errno_to_str().c_str());
+            udp_socket_close(fd);
+            return -1;
+        }
+    }
+
+    if (reuseport) {
+#ifdef SO_REUSEPORT
+        if (setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &one, sizeof(one)) != 0) {
+            roc_log(LogError, "udp socket: setsockopt(SO_REUSEPORT): %s",
+                    core::errno_to_str().c_str());
+            udp_socket_close(fd);
+            return -1;
+        }
+#else
+        roc_log(LogError, "udp socket: SO_REUSEPORT is not supported");
+        udp_socket_close(fd);
+        return -1;
+#endif
+    }
+
+    if (address.version() == 6) {
+        // may be unsupported, in this case the socket remains dual-stack
+        (void)setsockopt(fd, IPPROTO_IPV6, IPV6_V6ONLY, &one, sizeof(one));
+    }
+
+    if (bind(fd, address.saddr(), address.slen()) != 0) {
+        roc_log(LogError, "udp socket: bind(): %s", core::errno_to_str().c_str());
+        udp_socket_close(fd);
+        return -1;
+    }
+
+    socklen_t addrlen = address.slen();
+    if (getsockname(fd, address.saddr(), &addrlen) != 0) {
+        roc_log(LogError, "udp socket: getsockname(): %s", core::errno_to_str().c_str());
+        udp_socket_close(fd);
+        return -1;
+    }
+
+    if (addrlen != address.slen()) {
+        roc_log(LogError,
+                "udp socket: getsockname(): unexpected len: got=%lu expected=%lu",
+                (unsigned long)addrlen, (unsigned long)address.slen());
+        udp_socket_close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+bool udp_socket_enable_timestamps(int fd) {
+#ifdef SO_TIMESTAMPNS
+    int one = 1;
+
+    if (setsockopt(fd, SOL_SOCKET, SO_TIMESTAMPNS, &one, sizeof(one)) != 0) {
+        roc_log(LogDebug, "udp socket: setsockopt(SO_TIMESTAMPNS): %s",
+                core::errno_to_str().c_str());
+        return false;
+    }
+
+    return true;
+#else
+    (void)fd;
+    return false;
+#endif
+}
+
+void udp_socket_close(int fd) {
+    if (close(fd) != 0) {
+        roc_log(LogError, "udp socket: close(): %s", core::errno_to_str().c_str());
+    }
+}
+
+} // namespace netio
+} // namespace roc
@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_netio/target_uring/roc_netio/udp_socket.h
+//! @brief UDP socket helpers.
+
+#ifndef ROC_NETIO_UDP_SOCKET_H_
+#define ROC_NETIO_UDP_SOCKET_H_
+
+#include "roc_packet/address.h"
+
+namespace roc {
+namespace netio {
+
+//! Create non-blocking UDP socket and bind it to @p address.
+//!
+//! @remarks
+//!  If port is zero, the selected port is written back to @p address.
+//!  If @p reuseport is set, the socket is bound with SO_REUSEPORT.
+//!
+//! @returns
+//!  socket descriptor or -1 if error occurred.
+int udp_socket_open(packet::Address& address, bool reuseport);
+
+//! Request kernel receive timestamps for socket.
+//!
+//! @remarks
+//!  Enables SO_TIMESTAMPNS, so that every received datagram is accompanied
+//!  by SCM_TIMESTAMPNS control message with its arrival time.
+//!
+//! @returns
+//!  false if timestamps are not supported.
+bool udp_socket_enable_timestamps(int fd);
+
+//! Close socket.
+void udp_socket_close(int fd);
+
+} // namespace netio
+} // namespace roc
+
+#endif // ROC_NETIO_UDP_SOCKET_H_
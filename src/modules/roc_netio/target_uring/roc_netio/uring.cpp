@@ -0,0 +1,263 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "roc_core/atomic_ops.h"
+#include "roc_core/errno_to_str.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+#include "roc_netio/uring.h"
+
+namespace roc {
+namespace netio {
+
+namespace {
+
+int sys_io_uring_setup(unsigned entries, io_uring_params* params) {
+    return (int)syscall(__NR_io_uring_setup, entries, params);
+}
+
+int sys_io_uring_enter(int fd,
+                       unsigned to_submit,
+                       unsigned min_complete,
+                       unsigned flags) {
+    return (int)syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, NULL, 0);
+}
+
+int sys_io_uring_register(int fd, unsigned opcode, void* arg, unsigned nr_args) {
+    return (int)syscall(__NR_io_uring_register, fd, opcode, arg, nr_args);
+}
+
+void* map_ring(int fd, size_t size, off_t offset) {
+    void* ptr =
+        mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, offset);
+    if (ptr == MAP_FAILED) {
+        return NULL;
+    }
+    return ptr;
+}
+
+template <class T> T* ring_field(void* ring, unsigned offset) {
+    return (T*)((char*)ring + offset);
+}
+
+} // namespace
+
+Uring::Uring(unsigned n_entries)
+    : fd_(-1)
+    , sq_ring_(NULL)
+    , sq_ring_size_(0)
+    , cq_ring_(NULL)
+    , cq_ring_size_(0)
+    , sqes_(NULL)
+    , sqes_size_(0)
+    , sq_khead_(NULL)
+    , sq_ktail_(NULL)
+    , sq_array_(NULL)
+    , sq_mask_(0)
+    , sq_entries_(0)
+    , sq_tail_(0)
+    , cq_khead_(NULL)
+    , cq_ktail_(NULL)
+    , cqes_(NULL)
+    , cq_mask_(0) {
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+
+    // multishot receive may produce many completions per submission
+    params.flags = IORING_SETUP_CQSIZE;
+    params.cq_entries = n_entries * 4;
+
+    fd_ = sys_io_uring_setup(n_entries, &params);
+    if (fd_ == -1) {
+        roc_log(LogError, "uring: io_uring_setup(): %s", core::errno_to_str().c_str());
+        return;
+    }
+
+    if (!map_rings_(params)) {
+        unmap_rings_();
+        close(fd_);
+        fd_ = -1;
+        return;
+    }
+}
+
+Uring::~Uring() {
+    if (fd_ != -1) {
+        unmap_rings_();
+        close(fd_);
+    }
+}
+
+bool Uring::valid() const {
+    return fd_ != -1;
+}
+
+io_uring_sqe* Uring::get_sqe() {
+    roc_panic_if(!valid());
+
+    if (sq_tail_ - core::AtomicOps::load_acquire(*sq_khead_) >= sq_entries_) {
+        if (submit(0) < 0) {
+            return NULL;
+        }
+        if (sq_tail_ - core::AtomicOps::load_acquire(*sq_khead_) >= sq_entries_) {
+            return NULL;
+        }
+    }
+
+    io_uring_sqe* sqe = &sqes_[sq_tail_ & sq_mask_];
+    memset(sqe, 0, sizeof(*sqe));
+
+    sq_array_[sq_tail_ & sq_mask_] = sq_tail_ & sq_mask_;
+    sq_tail_++;
+
+    return sqe;
+}
+
+int Uring::submit(unsigned min_complete) {
+    roc_panic_if(!valid());
+
+    // make entries visible to the kernel
+    core::AtomicOps::store_release(*sq_ktail_, sq_tail_);
+
+    const unsigned to_submit = sq_tail_ - core::AtomicOps::load_acquire(*sq_khead_);
+    const unsigned flags = min_complete != 0 ? IORING_ENTER_GETEVENTS : 0;
+
+    for (;;) {
+        const int ret = sys_io_uring_enter(fd_, to_submit, min_complete, flags);
+        if (ret >= 0) {
+            return ret;
+        }
+        if (errno != EINTR) {
+            return -errno;
+        }
+    }
+}
+
+io_uring_cqe* Uring::peek_cqe() {
+    roc_panic_if(!valid());
+
+    const unsigned head = *cq_khead_;
+
+    if (head == core::AtomicOps::load_acquire(*cq_ktail_)) {
+        return NULL;
+    }
+
+    return &cqes_[head & cq_mask_];
+}
+
+void Uring::pop_cqe() {
+    roc_panic_if(!valid());
+
+    core::AtomicOps::store_release(*cq_khead_, *cq_khead_ + 1);
+}
+
+int Uring::register_buf_ring(void* ring, unsigned n_entries, unsigned group_id) {
+    roc_panic_if(!valid());
+
+    io_uring_buf_reg reg;
+    memset(&reg, 0, sizeof(reg));
+
+    reg.ring_addr = (unsigned long)ring;
+    reg.ring_entries = n_entries;
+    reg.bgid = (__u16)group_id;
+
+    if (sys_io_uring_register(fd_, IORING_REGISTER_PBUF_RING, &reg, 1) == -1) {
+        return -errno;
+    }
+
+    return 0;
+}
+
+int Uring::unregister_buf_ring(unsigned group_id) {
+    roc_panic_if(!valid());
+
+    io_uring_buf_reg reg;
+    memset(&reg, 0, sizeof(reg));
+
+    reg.bgid = (__u16)group_id;
+
+    if (sys_io_uring_register(fd_, IORING_UNREGISTER_PBUF_RING, &reg, 1) == -1) {
+        return -errno;
+    }
+
+    return 0;
+}
+
+bool Uring::map_rings_(const io_uring_params& params) {
+    sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        if (cq_ring_size_ > sq_ring_size_) {
+            sq_ring_size_ = cq_ring_size_;
+        }
+        cq_ring_size_ = 0;
+    }
+
+    if (!(sq_ring_ = map_ring(fd_, sq_ring_size_, IORING_OFF_SQ_RING))) {
+        roc_log(LogError, "uring: can't map submission ring: %s",
+                core::errno_to_str().c_str());
+        return false;
+    }
+
+    if (cq_ring_size_ != 0) {
+        if (!(cq_ring_ = map_ring(fd_, cq_ring_size_, IORING_OFF_CQ_RING))) {
+            roc_log(LogError, "uring: can't map completion ring: %s",
+                    core::errno_to_str().c_str());
+            return false;
+        }
+    }
+
+    sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+
+    if (!(sqes_ = (io_uring_sqe*)map_ring(fd_, sqes_size_, IORING_OFF_SQES))) {
+        roc_log(LogError, "uring: can't map submission entries: %s",
+                core::errno_to_str().c_str());
+        return false;
+    }
+
+    void* cq_ring = cq_ring_ ? cq_ring_ : sq_ring_;
+
+    sq_khead_ = ring_field<unsigned>(sq_ring_, params.sq_off.head);
+    sq_ktail_ = ring_field<unsigned>(sq_ring_, params.sq_off.tail);
+    sq_array_ = ring_field<unsigned>(sq_ring_, params.sq_off.array);
+    sq_mask_ = *ring_field<unsigned>(sq_ring_, params.sq_off.ring_mask);
+    sq_entries_ = params.sq_entries;
+    sq_tail_ = *sq_ktail_;
+
+    cq_khead_ = ring_field<unsigned>(cq_ring, params.cq_off.head);
+    cq_ktail_ = ring_field<unsigned>(cq_ring, params.cq_off.tail);
+    cqes_ = ring_field<io_uring_cqe>(cq_ring, params.cq_off.cqes);
+    cq_mask_ = *ring_field<unsigned>(cq_ring, params.cq_off.ring_mask);
+
+    return true;
+}
+
+void Uring::unmap_rings_() {
+    if (sqes_) {
+        munmap(sqes_, sqes_size_);
+        sqes_ = NULL;
+    }
+    if (cq_ring_) {
+        munmap(cq_ring_, cq_ring_size_);
+        cq_ring_ = NULL;
+    }
+    if (sq_ring_) {
+        munmap(sq_ring_, sq_ring_size_);
+        sq_ring_ = NULL;
+    }
+}
+
+} // namespace netio
+} // namespace roc
@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_netio/target_uring/roc_netio/uring.h
+//! @brief io_uring instance.
+
+#ifndef ROC_NETIO_URING_H_
+#define ROC_NETIO_URING_H_
+
+#include <linux/io_uring.h>
+
+#include "roc_core/noncopyable.h"
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace netio {
+
+//! io_uring instance.
+//! @remarks
+//!  Thin wrapper for submission and completion queues, implemented directly
+//!  on top of system calls, so that liburing is not needed. Not thread-safe;
+//!  should be used only from the event loop thread.
+class Uring : public core::NonCopyable<> {
+public:
+    //! Initialize.
+    //! @remarks
+    //!  Creates rings with @p n_entries submission queue entries.
+    explicit Uring(unsigned n_entries);
+
+    //! Destroy.
+    ~Uring();
+
+    //! Check if rings were successfully created.
+    bool valid() const;
+
+    //! Get free submission queue entry.
+    //! @remarks
+    //!  The returned entry is zeroed. If the submission queue is full, pending
+    //!  entries are submitted first.
+    //! @returns
+    //!  NULL if there is still no free entry.
+    io_uring_sqe* get_sqe();
+
+    //! Submit pending entries and wait for completions.
+    //! @remarks
+    //!  Blocks until at least @p min_complete completions are available.
+    //! @returns
+    //!  number of submitted entries or negative errno.
+    int submit(unsigned min_complete);
+
+    //! Get next completion.
+    //! @returns
+    //!  NULL if there are no available completions.
+    io_uring_cqe* peek_cqe();
+
+    //! Remove completion returned by peek_cqe() from the queue.
+    void pop_cqe();
+
+    //! Register provided buffer ring.
+    //! @remarks
+    //!  @p ring should be page-aligned and contain @p n_entries entries.
+    //! @returns
+    //!  zero or negative errno.
+    int register_buf_ring(void* ring, unsigned n_entries, unsigned group_id);
+
+    //! Unregister provided buffer ring.
+    //! @returns
+    //!  zero or negative errno.
+    int unregister_buf_ring(unsigned group_id);
+
+private:
+    bool map_rings_(const io_uring_params& params);
+    void unmap_rings_();
+
+    int fd_;
+
+    void* sq_ring_;
+    size_t sq_ring_size_;
+
+    void* cq_ring_;
+    size_t cq_ring_size_;
+
+    io_uring_sqe* sqes_;
+    size_t sqes_size_;
+
+    unsigned* sq_khead_;
+    unsigned* sq_ktail_;
+    unsigned* sq_array_;
+    unsigned sq_mask_;
+    unsigned sq_entries_;
+    unsigned sq_tail_;
+
+    unsigned* cq_khead_;
+    unsigned* cq_ktail_;
+    io_uring_cqe* cqes_;
+    unsigned cq_mask_;
+};
+
+} // namespace netio
+} // namespace roc
+
+#endif // ROC_NETIO_URING_H_
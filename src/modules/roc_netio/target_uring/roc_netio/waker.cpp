@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <errno.h>
+#include <stdint.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include "roc_core/atomic_ops.h"
+#include "roc_core/errno_to_str.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+#include "roc_netio/waker.h"
+
+namespace roc {
+namespace netio {
+
+Waker::Waker()
+    : fd_(-1)
+    , pending_(0) {
+    fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (fd_ == -1) {
+        roc_log(LogError, "waker: eventfd(): %s", core::errno_to_str().c_str());
+    }
+}
+
+Waker::~Waker() {
+    if (fd_ != -1) {
+        close(fd_);
+    }
+}
+
+bool Waker::valid() const {
+    return fd_ != -1;
+}
+
+int Waker::fd() const {
+    return fd_;
+}
+
+void Waker::wake() {
+    roc_panic_if(!valid());
+
+    if (core::AtomicOps::exchange_acq_rel(pending_, 1) != 0) {
+        return;
+    }
+
+    const uint64_t value = 1;
+
+    ssize_t ret;
+    do {
+        ret = write(fd_, &value, sizeof(value));
+    } while (ret == -1 && errno == EINTR);
+
+    // EAGAIN means that the counter is already non-zero
+    if (ret == -1 && errno != EAGAIN) {
+        roc_panic("waker: write(): %s", core::errno_to_str().c_str());
+    }
+}
+
+void Waker::reset() {
+    core::AtomicOps::exchange_acq_rel(pending_, 0);
+}
+
+} // namespace netio
+} // namespace roc
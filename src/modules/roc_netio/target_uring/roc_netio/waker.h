@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_netio/target_uring/roc_netio/waker.h
+//! @brief Event loop waker.
+
+#ifndef ROC_NETIO_WAKER_H_
+#define ROC_NETIO_WAKER_H_
+
+#include "roc_core/noncopyable.h"
+
+namespace roc {
+namespace netio {
+
+//! Event loop waker.
+//! @remarks
+//!  Wraps an eventfd, which is read by the event loop. Wakeups are coalesced:
+//!  after the first wake() call, the eventfd is not written again until the
+//!  event loop calls reset().
+class Waker : public core::NonCopyable<> {
+public:
+    //! Initialize.
+    Waker();
+
+    //! Destroy.
+    ~Waker();
+
+    //! Check if eventfd was successfully created.
+    bool valid() const;
+
+    //! Get eventfd.
+    int fd() const;
+
+    //! Wake up event loop.
+    //! @remarks
+    //!  May be called from any thread.
+    void wake();
+
+    //! Allow next wakeup.
+    //! @remarks
+    //!  Should be called from the event loop thread before it handles the
+    //!  work for which it was woken up.
+    void reset();
+
+private:
+    int fd_;
+    int pending_;
+};
+
+} // namespace netio
+} // namespace roc
+
+#endif // ROC_NETIO_WAKER_H_
@@ -6,7 +6,7 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/.
  */
 
-#include "roc_netio/transceiver.h"
+#include "roc_netio/event_loop.h"
 #include "roc_core/log.h"
 #include "roc_core/panic.h"
 #include "roc_core/shared_ptr.h"
@@ -15,26 +15,37 @@
 namespace roc {
 namespace netio {
 
-Transceiver::Transceiver(packet::PacketPool& packet_pool,
-                         core::BufferPool<uint8_t>& buffer_pool,
-                         core::IAllocator& allocator)
+namespace {
+
+// Interval between pool trims, in milliseconds.
+const uint64_t TrimInterval = 10000;
+
+} // namespace
+
+EventLoop::EventLoop(packet::PacketPool& packet_pool,
+                     core::BufferPool<uint8_t>& buffer_pool,
+                     core::BufferPool<audio::sample_t>* sample_buffer_pool,
+                     core::IAllocator& allocator,
+                     bool trim_pools)
     : packet_pool_(packet_pool)
     , buffer_pool_(buffer_pool)
+    , sample_buffer_pool_(sample_buffer_pool)
     , allocator_(allocator)
     , started_(false)
     , loop_initialized_(false)
     , stop_sem_initialized_(false)
     , task_sem_initialized_(false)
+    , trim_timer_initialized_(false)
     , cond_(mutex_) {
     if (int err = uv_loop_init(&loop_)) {
-        roc_log(LogError, "transceiver: uv_loop_init(): [%s] %s", uv_err_name(err),
+        roc_log(LogError, "event loop: uv_loop_init(): [%s] %s", uv_err_name(err),
                 uv_strerror(err));
         return;
     }
     loop_initialized_ = true;
 
     if (int err = uv_async_init(&loop_, &stop_sem_, stop_sem_cb_)) {
-        roc_log(LogError, "transceiver: uv_async_init(): [%s] %s", uv_err_name(err),
+        roc_log(LogError, "event loop: uv_async_init(): [%s] %s", uv_err_name(err),
                 uv_strerror(err));
         return;
     }
@@ -42,20 +53,37 @@ Transceiver::Transceiver(packet::PacketPool& packet_pool,
     stop_sem_initialized_ = true;
 
     if (int err = uv_async_init(&loop_, &task_sem_, task_sem_cb_)) {
-        roc_log(LogError, "transceiver: uv_async_init(): [%s] %s", uv_err_name(err),
+        roc_log(LogError, "event loop: uv_async_init(): [%s] %s", uv_err_name(err),
                 uv_strerror(err));
         return;
     }
     task_sem_.data = this;
     task_sem_initialized_ = true;
 
+    if (trim_pools) {
+        if (int err = uv_timer_init(&loop_, &trim_timer_)) {
+            roc_log(LogError, "event loop: uv_timer_init(): [%s] %s", uv_err_name(err),
+                    uv_strerror(err));
+            return;
+        }
+        trim_timer_.data = this;
+        trim_timer_initialized_ = true;
+
+        if (int err = uv_timer_start(&trim_timer_, trim_timer_cb_, TrimInterval,
+                                     TrimInterval)) {
+            roc_log(LogError, "event loop: uv_timer_start(): [%s] %s",
+                    uv_err_name(err), uv_strerror(err));
+            return;
+        }
+    }
+
     started_ = Thread::start();
 }
 
-Transceiver::~Transceiver() {
+EventLoop::~EventLoop() {
     if (started_) {
         if (int err = uv_async_send(&stop_sem_)) {
-            roc_panic("transceiver: uv_async_send(): [%s] %s", uv_err_name(err),
+            roc_panic("event loop: uv_async_send(): [%s] %s", uv_err_name(err),
                       uv_strerror(err));
         }
     } else {
@@ -69,11 +97,11 @@ Transceiver::~Transceiver() {
             // If the thread was never started we should manually run the loop to
             // wait all opened handles to be closed. Otherwise, uv_loop_close()
             // will fail with EBUSY.
-            Transceiver::run(); // non-virtual call from dtor
+            EventLoop::run(); // non-virtual call from dtor
         }
 
         if (int err = uv_loop_close(&loop_)) {
-            roc_panic("transceiver: uv_loop_close(): [%s] %s", uv_err_name(err),
+            roc_panic("event loop: uv_loop_close(): [%s] %s", uv_err_name(err),
                       uv_strerror(err));
         }
     }
@@ -83,28 +111,46 @@ Transceiver::~Transceiver() {
     roc_panic_if(closing_ports_.size());
     roc_panic_if(task_sem_initialized_);
     roc_panic_if(stop_sem_initialized_);
+    roc_panic_if(trim_timer_initialized_);
 }
 
-bool Transceiver::valid() const {
+bool EventLoop::valid() const {
     return started_;
 }
 
-size_t Transceiver::num_ports() const {
+size_t EventLoop::num_ports() const {
     core::Mutex::Lock lock(mutex_);
 
     return open_ports_.size();
 }
 
-bool Transceiver::add_udp_receiver(packet::Address& bind_address,
-                                   packet::IWriter& writer) {
+bool EventLoop::has_port(const packet::Address& address) const {
+    core::Mutex::Lock lock(mutex_);
+
+    for (BasicPort* pp = open_ports_.front_borrowed(); pp;
+         pp = open_ports_.nextof_borrowed(*pp)) {
+        if (pp->address() == address) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool EventLoop::add_udp_receiver(packet::Address& bind_address,
+                                 packet::IWriter& writer,
+                                 bool reuseport,
+                                 bool timestamps) {
     if (!valid()) {
-        roc_panic("transceiver: can't use invalid transceiver");
+        roc_panic("event loop: can't use invalid event loop");
     }
 
     Task task;
-    task.fn = &Transceiver::add_udp_receiver_;
+    task.fn = &EventLoop::add_udp_receiver_;
     task.address = &bind_address;
     task.writer = &writer;
+    task.reuseport = reuseport;
+    task.timestamps = timestamps;
 
     run_task_(task);
 
@@ -117,15 +163,17 @@ bool Transceiver::add_udp_receiver(packet::Address& bind_address,
     return task.result;
 }
 
-packet::IWriter* Transceiver::add_udp_sender(packet::Address& bind_address) {
+packet::IWriter* EventLoop::add_udp_sender(packet::Address& bind_address,
+                                           bool direct_send) {
     if (!valid()) {
-        roc_panic("transceiver: can't use invalid transceiver");
+        roc_panic("event loop: can't use invalid event loop");
     }
 
     Task task;
-    task.fn = &Transceiver::add_udp_sender_;
+    task.fn = &EventLoop::add_udp_sender_;
     task.address = &bind_address;
     task.writer = NULL;
+    task.direct_send = direct_send;
 
     run_task_(task);
 
@@ -138,37 +186,38 @@ packet::IWriter* Transceiver::add_udp_sender(packet::Address& bind_address) {
     return task.writer;
 }
 
-void Transceiver::remove_port(packet::Address bind_address) {
+bool EventLoop::remove_port(packet::Address bind_address) {
     if (!valid()) {
-        roc_panic("transceiver: can't use invalid transceiver");
+        roc_panic("event loop: can't use invalid event loop");
     }
 
     Task task;
-    task.fn = &Transceiver::remove_port_;
+    task.fn = &EventLoop::remove_port_;
     task.address = &bind_address;
     task.writer = NULL;
 
     run_task_(task);
 
     if (!task.result) {
-        roc_panic("transceiver: can't remove port %s: unknown port",
-                  packet::address_to_str(bind_address).c_str());
-    } else {
-        roc_panic_if_not(task.port);
-        wait_port_closed_(*task.port);
+        return false;
     }
+
+    roc_panic_if_not(task.port);
+    wait_port_closed_(*task.port);
+
+    return true;
 }
 
-void Transceiver::handle_closed(BasicPort& port) {
+void EventLoop::handle_closed(BasicPort& port) {
     core::Mutex::Lock lock(mutex_);
 
-    for (core::SharedPtr<BasicPort> pp = closing_ports_.front(); pp;
-         pp = closing_ports_.nextof(*pp)) {
-        if (pp.get() != &port) {
+    for (BasicPort* pp = closing_ports_.front_borrowed(); pp;
+         pp = closing_ports_.nextof_borrowed(*pp)) {
+        if (pp != &port) {
             continue;
         }
 
-        roc_log(LogDebug, "transceiver: asynchronous close finished: port %s",
+        roc_log(LogDebug, "event loop: asynchronous close finished: port %s",
                 packet::address_to_str(port.address()).c_str());
 
         closing_ports_.remove(*pp);
@@ -178,34 +227,47 @@ void Transceiver::handle_closed(BasicPort& port) {
     }
 }
 
-void Transceiver::run() {
-    roc_log(LogDebug, "transceiver: starting event loop");
+void EventLoop::run() {
+    roc_log(LogDebug, "event loop: starting event loop");
 
     int err = uv_run(&loop_, UV_RUN_DEFAULT);
     if (err != 0) {
-        roc_log(LogInfo, "transceiver: uv_run() returned non-zero");
+        roc_log(LogInfo, "event loop: uv_run() returned non-zero");
     }
 
-    roc_log(LogDebug, "transceiver: finishing event loop");
+    roc_log(LogDebug, "event loop: finishing event loop");
 }
 
-void Transceiver::task_sem_cb_(uv_async_t* handle) {
+void EventLoop::task_sem_cb_(uv_async_t* handle) {
     roc_panic_if_not(handle);
 
-    Transceiver& self = *(Transceiver*)handle->data;
+    EventLoop& self = *(EventLoop*)handle->data;
     self.process_tasks_();
 }
 
-void Transceiver::stop_sem_cb_(uv_async_t* handle) {
+void EventLoop::stop_sem_cb_(uv_async_t* handle) {
     roc_panic_if_not(handle);
 
-    Transceiver& self = *(Transceiver*)handle->data;
+    EventLoop& self = *(EventLoop*)handle->data;
     self.async_close_ports_();
     self.close_sems_();
     self.process_tasks_();
 }
 
-void Transceiver::async_close_ports_() {
+void EventLoop::trim_timer_cb_(uv_timer_t* handle) {
+    roc_panic_if_not(handle);
+
+    EventLoop& self = *(EventLoop*)handle->data;
+
+    self.packet_pool_.trim();
+    self.buffer_pool_.trim();
+
+    if (self.sample_buffer_pool_) {
+        self.sample_buffer_pool_->trim();
+    }
+}
+
+void EventLoop::async_close_ports_() {
     core::Mutex::Lock lock(mutex_);
 
     while (core::SharedPtr<BasicPort> port = open_ports_.front()) {
@@ -216,7 +278,7 @@ void Transceiver::async_close_ports_() {
     }
 }
 
-void Transceiver::close_sems_() {
+void EventLoop::close_sems_() {
     if (task_sem_initialized_) {
         uv_close((uv_handle_t*)&task_sem_, NULL);
         task_sem_initialized_ = false;
@@ -226,15 +288,20 @@ void Transceiver::close_sems_() {
         uv_close((uv_handle_t*)&stop_sem_, NULL);
         stop_sem_initialized_ = false;
     }
+
+    if (trim_timer_initialized_) {
+        uv_close((uv_handle_t*)&trim_timer_, NULL);
+        trim_timer_initialized_ = false;
+    }
 }
 
-void Transceiver::run_task_(Task& task) {
+void EventLoop::run_task_(Task& task) {
     core::Mutex::Lock lock(mutex_);
 
     tasks_.push_back(task);
 
     if (int err = uv_async_send(&task_sem_)) {
-        roc_panic("transceiver: uv_async_send(): [%s] %s", uv_err_name(err),
+        roc_panic("event loop: uv_async_send(): [%s] %s", uv_err_name(err),
                   uv_strerror(err));
     }
 
@@ -243,7 +310,7 @@ void Transceiver::run_task_(Task& task) {
     }
 }
 
-void Transceiver::process_tasks_() {
+void EventLoop::process_tasks_() {
     core::Mutex::Lock lock(mutex_);
 
     while (Task* task = tasks_.front()) {
@@ -256,13 +323,14 @@ void Transceiver::process_tasks_() {
     cond_.broadcast();
 }
 
-bool Transceiver::add_udp_receiver_(Task& task) {
+bool EventLoop::add_udp_receiver_(Task& task) {
     core::SharedPtr<BasicPort> rp =
         new (allocator_) UDPReceiverPort(*this, *task.address, loop_, *task.writer,
-                                         packet_pool_, buffer_pool_, allocator_);
+                                         packet_pool_, buffer_pool_, allocator_,
+                                         task.reuseport, task.timestamps);
 
     if (!rp) {
-        roc_log(LogError, "transceiver: can't add port %s: can't allocate receiver",
+        roc_log(LogError, "event loop: can't add port %s: can't allocate receiver",
                 packet::address_to_str(*task.address).c_str());
 
         return false;
@@ -271,7 +339,7 @@ bool Transceiver::add_udp_receiver_(Task& task) {
     task.port = rp.get();
 
     if (!rp->open()) {
-        roc_log(LogError, "transceiver: can't add port %s: can't start receiver",
+        roc_log(LogError, "event loop: can't add port %s: can't start receiver",
                 packet::address_to_str(*task.address).c_str());
 
         closing_ports_.push_back(*rp);
@@ -286,11 +354,12 @@ bool Transceiver::add_udp_receiver_(Task& task) {
     return true;
 }
 
-bool Transceiver::add_udp_sender_(Task& task) {
+bool EventLoop::add_udp_sender_(Task& task) {
     core::SharedPtr<UDPSenderPort> sp =
-        new (allocator_) UDPSenderPort(*this, *task.address, loop_, allocator_);
+        new (allocator_) UDPSenderPort(*this, *task.address, loop_, allocator_,
+                                       task.direct_send);
     if (!sp) {
-        roc_log(LogError, "transceiver: can't add port %s: can't allocate sender",
+        roc_log(LogError, "event loop: can't add port %s: can't allocate sender",
                 packet::address_to_str(*task.address).c_str());
 
         return false;
@@ -299,7 +368,7 @@ bool Transceiver::add_udp_sender_(Task& task) {
     task.port = sp.get();
 
     if (!sp->open()) {
-        roc_log(LogError, "transceiver: can't add port %s: can't start sender",
+        roc_log(LogError, "event loop: can't add port %s: can't start sender",
                 packet::address_to_str(*task.address).c_str());
 
         closing_ports_.push_back(*sp);
@@ -316,8 +385,8 @@ bool Transceiver::add_udp_sender_(Task& task) {
     return true;
 }
 
-bool Transceiver::remove_port_(Task& task) {
-    roc_log(LogDebug, "transceiver: removing port %s",
+bool EventLoop::remove_port_(Task& task) {
+    roc_log(LogDebug, "event loop: removing port %s",
             packet::address_to_str(*task.address).c_str());
 
     core::SharedPtr<BasicPort> curr = open_ports_.front();
@@ -340,7 +409,7 @@ bool Transceiver::remove_port_(Task& task) {
     return false;
 }
 
-void Transceiver::wait_port_closed_(const BasicPort& port) {
+void EventLoop::wait_port_closed_(const BasicPort& port) {
     core::Mutex::Lock lock(mutex_);
 
     while (port_is_closing_(port)) {
@@ -348,10 +417,10 @@ void Transceiver::wait_port_closed_(const BasicPort& port) {
     }
 }
 
-bool Transceiver::port_is_closing_(const BasicPort& port) {
-    for (core::SharedPtr<BasicPort> pp = closing_ports_.front(); pp;
-         pp = closing_ports_.nextof(*pp)) {
-        if (pp.get() == &port) {
+bool EventLoop::port_is_closing_(const BasicPort& port) {
+    for (BasicPort* pp = closing_ports_.front_borrowed(); pp;
+         pp = closing_ports_.nextof_borrowed(*pp)) {
+        if (pp == &port) {
             return true;
         }
     }
@@ -6,14 +6,15 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/.
  */
 
-//! @file roc_netio/target_uv/roc_netio/transceiver.h
-//! @brief Network sender/receiver.
+//! @file roc_netio/target_uv/roc_netio/event_loop.h
+//! @brief Network event loop.
 
-#ifndef ROC_NETIO_TRANSCEIVER_H_
-#define ROC_NETIO_TRANSCEIVER_H_
+#ifndef ROC_NETIO_EVENT_LOOP_H_
+#define ROC_NETIO_EVENT_LOOP_H_
 
 #include <uv.h>
 
+#include "roc_audio/units.h"
 #include "roc_core/buffer_pool.h"
 #include "roc_core/cond.h"
 #include "roc_core/iallocator.h"
@@ -32,29 +33,39 @@
 namespace roc {
 namespace netio {
 
-//! Network sender/receiver.
-class Transceiver : private ICloseHandler, private core::Thread {
+//! Network event loop.
+//!
+//! Runs a libuv event loop in a background thread and serves ports added
+//! to it. If @p trim_pools is set, also periodically trims packet and buffer
+//! pools, and the sample buffer pool if it's not NULL, from the network thread,
+//! so that memory allocated during a peak load is returned to the allocator.
+class EventLoop : private ICloseHandler, private core::Thread {
 public:
     //! Initialize.
     //!
     //! @remarks
     //!  Start background thread if the object was successfully constructed.
-    Transceiver(packet::PacketPool& packet_pool,
-                core::BufferPool<uint8_t>& buffer_pool,
-                core::IAllocator& allocator);
+    EventLoop(packet::PacketPool& packet_pool,
+              core::BufferPool<uint8_t>& buffer_pool,
+              core::BufferPool<audio::sample_t>* sample_buffer_pool,
+              core::IAllocator& allocator,
+              bool trim_pools);
 
     //! Destroy. Stop all receivers and senders.
     //!
     //! @remarks
     //!  Wait until background thread finishes.
-    virtual ~Transceiver();
+    virtual ~EventLoop();
 
-    //! Check if transceiver was successfully constructed.
+    //! Check if event loop was successfully constructed.
     bool valid() const;
 
     //! Get number of receiver and sender ports.
     size_t num_ports() const;
 
+    //! Check if there is an open port bound to @p address.
+    bool has_port(const packet::Address& address) const;
+
     //! Add UDP datagram receiver port.
     //!
     //! Creates a new UDP receiver and bind it to @p bind_address. The receiver
@@ -65,9 +76,18 @@ public:
     //! interfaces. If port is zero, a random free port is selected and written
     //! back to @p bind_address.
     //!
+    //! If @p reuseport is set, the socket is bound with SO_REUSEPORT, so that
+    //! several receivers may share the same address.
+    //!
+    //! If @p timestamps is set, the receiver requests kernel arrival timestamps
+    //! for received packets, if supported.
+    //!
     //! @returns
     //!  true on success or false if error occurred
-    bool add_udp_receiver(packet::Address& bind_address, packet::IWriter& writer);
+    bool add_udp_receiver(packet::Address& bind_address,
+                          packet::IWriter& writer,
+                          bool reuseport,
+                          bool timestamps);
 
     //! Add UDP datagram sender port.
     //!
@@ -75,24 +95,34 @@ public:
     //! that may be used to send packets from this address. Writer may be called
     //! from any thread. It will not block the caller.
     //!
+    //! If @p direct_send is set, the writer sends packets to the socket by
+    //! itself, and passes them to the event loop only if the socket would
+    //! block.
+    //!
     //! If IP is zero, INADDR_ANY is used, i.e. the socket is bound to all network
     //! interfaces. If port is zero, a random free port is selected and written
     //! back to @p bind_address.
     //!
     //! @returns
     //!  a new packet writer on success or null if error occurred
-    packet::IWriter* add_udp_sender(packet::Address& bind_address);
+    packet::IWriter* add_udp_sender(packet::Address& bind_address, bool direct_send);
 
     //! Remove sender or receiver port. Wait until port will be removed.
-    void remove_port(packet::Address bind_address);
+    //!
+    //! @returns
+    //!  false if there is no port bound to @p bind_address
+    bool remove_port(packet::Address bind_address);
 
 private:
     struct Task : core::ListNode {
-        bool (Transceiver::*fn)(Task&);
+        bool (EventLoop::*fn)(Task&);
 
         packet::Address* address;
         packet::IWriter* writer;
         BasicPort* port;
+        bool reuseport;
+        bool timestamps;
+        bool direct_send;
 
         bool result;
         bool done;
@@ -102,6 +132,9 @@ private:
             , address(NULL)
             , writer(NULL)
             , port(NULL)
+            , reuseport(false)
+            , timestamps(false)
+            , direct_send(false)
             , result(false)
             , done(false) {
         }
@@ -109,6 +142,7 @@ private:
 
     static void task_sem_cb_(uv_async_t* handle);
     static void stop_sem_cb_(uv_async_t* handle);
+    static void trim_timer_cb_(uv_timer_t* handle);
 
     virtual void handle_closed(BasicPort&);
     virtual void run();
@@ -128,6 +162,7 @@ private:
 
     packet::PacketPool& packet_pool_;
     core::BufferPool<uint8_t>& buffer_pool_;
+    core::BufferPool<audio::sample_t>* sample_buffer_pool_;
     core::IAllocator& allocator_;
 
     bool started_;
@@ -141,6 +176,9 @@ private:
     uv_async_t task_sem_;
     bool task_sem_initialized_;
 
+    uv_timer_t trim_timer_;
+    bool trim_timer_initialized_;
+
     core::List<Task, core::NoOwnership> tasks_;
 
     core::List<BasicPort> open_ports_;
@@ -153,4 +191,4 @@ private:
 } // namespace netio
 } // namespace roc
 
-#endif // ROC_NETIO_TRANSCEIVER_H_
+#endif // ROC_NETIO_EVENT_LOOP_H_
@@ -7,90 +7,132 @@
  */
 
 #include "roc_netio/udp_receiver_port.h"
+#include "roc_core/errno_to_str.h"
 #include "roc_core/log.h"
 #include "roc_core/panic.h"
 #include "roc_core/shared_ptr.h"
 #include "roc_packet/address_to_str.h"
 
+#if defined(__linux__) && defined(_GNU_SOURCE)
+#include <errno.h>
+#include <netinet/in.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#define ROC_NETIO_HAVE_RECVMMSG
+
+#if defined(SO_REUSEPORT)
+#define ROC_NETIO_HAVE_REUSEPORT
+#endif
+
+#if defined(SO_TIMESTAMPNS)
+#define ROC_NETIO_HAVE_TIMESTAMPS
+#endif
+#endif
+
 namespace roc {
 namespace netio {
 
+#ifdef ROC_NETIO_HAVE_TIMESTAMPS
+
+namespace {
+
+core::nanoseconds_t find_timestamp(msghdr& msg) {
+    for (cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+        if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_TIMESTAMPNS
+            || cmsg->cmsg_len < CMSG_LEN(sizeof(timespec))) {
+            continue;
+        }
+
+        timespec ts;
+        memcpy(&ts, CMSG_DATA(cmsg), sizeof(ts));
+
+        return core::nanoseconds_t(ts.tv_sec) * core::Second + ts.tv_nsec;
+    }
+
+    return 0;
+}
+
+} // namespace
+
+#endif // ROC_NETIO_HAVE_TIMESTAMPS
+
 UDPReceiverPort::UDPReceiverPort(ICloseHandler& close_handler,
                                  const packet::Address& address,
                                  uv_loop_t& event_loop,
                                  packet::IWriter& writer,
                                  packet::PacketPool& packet_pool,
                                  core::BufferPool<uint8_t>& buffer_pool,
-                                 core::IAllocator& allocator)
+                                 core::IAllocator& allocator,
+                                 bool reuseport,
+                                 bool timestamps)
     : BasicPort(allocator)
     , close_handler_(close_handler)
     , loop_(event_loop)
     , handle_initialized_(false)
+    , poll_initialized_(false)
+    , fd_(-1)
+    , check_initialized_(false)
     , recv_started_(false)
     , closed_(false)
     , address_(address)
     , writer_(writer)
     , packet_pool_(packet_pool)
     , buffer_pool_(buffer_pool)
+    , reuseport_(reuseport)
+    , timestamps_requested_(timestamps)
+    , timestamps_(false)
+    , batch_size_(0)
     , packet_counter_(0) {
 }
 
 UDPReceiverPort::~UDPReceiverPort() {
-    if (handle_initialized_) {
+    if (handle_initialized_ || poll_initialized_ || check_initialized_) {
         roc_panic(
             "udp receiver: receiver was not fully closed before calling destructor");
     }
 }
 
+bool UDPReceiverPort::reuseport_supported() {
+#ifdef ROC_NETIO_HAVE_REUSEPORT
+    return true;
+#else
+    return false;
+#endif
+}
+
+size_t UDPReceiverPort::buffer_overhead() {
+    return 0;
+}
+
 const packet::Address& UDPReceiverPort::address() const {
     return address_;
 }
 
 bool UDPReceiverPort::open() {
-    if (int err = uv_udp_init(&loop_, &handle_)) {
-        roc_log(LogError, "udp receiver: uv_udp_init(): [%s] %s", uv_err_name(err),
+    if (int err = uv_check_init(&loop_, &check_handle_)) {
+        roc_log(LogError, "udp receiver: uv_check_init(): [%s] %s", uv_err_name(err),
                 uv_strerror(err));
         return false;
     }
 
-    handle_.data = this;
-    handle_initialized_ = true;
-
-    unsigned flags = 0;
-    if (address_.multicast() && address_.port() > 0) {
-        flags |= UV_UDP_REUSEADDR;
-    }
-
-    int bind_err = UV_EINVAL;
-    if (address_.version() == 6) {
-        bind_err = uv_udp_bind(&handle_, address_.saddr(), flags | UV_UDP_IPV6ONLY);
-    }
-    if (bind_err == UV_EINVAL || bind_err == UV_ENOTSUP) {
-        bind_err = uv_udp_bind(&handle_, address_.saddr(), flags);
-    }
-    if (bind_err != 0) {
-        roc_log(LogError, "udp receiver: uv_udp_bind(): [%s] %s", uv_err_name(bind_err),
-                uv_strerror(bind_err));
-        return false;
-    }
+    check_handle_.data = this;
+    check_initialized_ = true;
 
-    int addrlen = (int)address_.slen();
-    if (int err = uv_udp_getsockname(&handle_, address_.saddr(), &addrlen)) {
-        roc_log(LogError, "udp receiver: uv_udp_getsockname(): [%s] %s", uv_err_name(err),
-                uv_strerror(err));
+#ifdef ROC_NETIO_HAVE_RECVMMSG
+    if (!open_poll_()) {
         return false;
     }
-
-    if (addrlen != (int)address_.slen()) {
-        roc_log(
-            LogError,
-            "udp receiver: uv_udp_getsockname(): unexpected len: got=%lu expected=%lu",
-            (unsigned long)addrlen, (unsigned long)address_.slen());
+#else
+    if (!open_udp_()) {
         return false;
     }
+#endif
 
-    if (int err = uv_udp_recv_start(&handle_, alloc_cb_, recv_cb_)) {
-        roc_log(LogError, "udp receiver: uv_udp_recv_start(): [%s] %s", uv_err_name(err),
+    if (int err = uv_check_start(&check_handle_, check_cb_)) {
+        roc_log(LogError, "udp receiver: uv_check_start(): [%s] %s", uv_err_name(err),
                 uv_strerror(err));
         return false;
     }
@@ -98,8 +140,6 @@ bool UDPReceiverPort::open() {
     roc_log(LogInfo, "udp receiver: opened port %s",
             packet::address_to_str(address_).c_str());
 
-    recv_started_ = true;
-
     return true;
 }
 
@@ -108,7 +148,9 @@ void UDPReceiverPort::async_close() {
         return; // handle_closed() was already called
     }
 
-    if (!handle_initialized_) {
+    flush_();
+
+    if (!handle_initialized_ && !poll_initialized_ && !check_initialized_) {
         closed_ = true;
         close_handler_.handle_closed(*this);
 
@@ -119,17 +161,34 @@ void UDPReceiverPort::async_close() {
             packet::address_to_str(address_).c_str());
 
     if (recv_started_) {
-        if (int err = uv_udp_recv_stop(&handle_)) {
-            roc_log(LogError, "udp receiver: uv_udp_recv_stop(): [%s] %s",
-                    uv_err_name(err), uv_strerror(err));
+        if (handle_initialized_) {
+            if (int err = uv_udp_recv_stop(&handle_)) {
+                roc_log(LogError, "udp receiver: uv_udp_recv_stop(): [%s] %s",
+                        uv_err_name(err), uv_strerror(err));
+            }
+        }
+
+        if (poll_initialized_) {
+            if (int err = uv_poll_stop(&poll_handle_)) {
+                roc_log(LogError, "udp receiver: uv_poll_stop(): [%s] %s",
+                        uv_err_name(err), uv_strerror(err));
+            }
         }
 
         recv_started_ = false;
     }
 
-    if (!uv_is_closing((uv_handle_t*)&handle_)) {
+    if (handle_initialized_ && !uv_is_closing((uv_handle_t*)&handle_)) {
         uv_close((uv_handle_t*)&handle_, close_cb_);
     }
+
+    if (poll_initialized_ && !uv_is_closing((uv_handle_t*)&poll_handle_)) {
+        uv_close((uv_handle_t*)&poll_handle_, close_cb_);
+    }
+
+    if (check_initialized_ && !uv_is_closing((uv_handle_t*)&check_handle_)) {
+        uv_close((uv_handle_t*)&check_handle_, close_cb_);
+    }
 }
 
 void UDPReceiverPort::close_cb_(uv_handle_t* handle) {
@@ -137,7 +196,24 @@ void UDPReceiverPort::close_cb_(uv_handle_t* handle) {
 
     UDPReceiverPort& self = *(UDPReceiverPort*)handle->data;
 
-    self.handle_initialized_ = false;
+    if (handle == (uv_handle_t*)&self.handle_) {
+        self.handle_initialized_ = false;
+    } else if (handle == (uv_handle_t*)&self.poll_handle_) {
+        self.poll_initialized_ = false;
+
+        // uv_poll_t doesn't own the socket
+        if (close(self.fd_) != 0) {
+            roc_log(LogError, "udp receiver: close(): %s",
+                    core::errno_to_str(errno).c_str());
+        }
+        self.fd_ = -1;
+    } else {
+        self.check_initialized_ = false;
+    }
+
+    if (self.handle_initialized_ || self.poll_initialized_ || self.check_initialized_) {
+        return;
+    }
 
     roc_log(LogInfo, "udp receiver: closed port %s",
             packet::address_to_str(self.address_).c_str());
@@ -146,6 +222,31 @@ void UDPReceiverPort::close_cb_(uv_handle_t* handle) {
     self.close_handler_.handle_closed(self);
 }
 
+void UDPReceiverPort::check_cb_(uv_check_t* handle) {
+    roc_panic_if_not(handle);
+
+    UDPReceiverPort& self = *(UDPReceiverPort*)handle->data;
+
+    self.flush_();
+}
+
+void UDPReceiverPort::poll_cb_(uv_poll_t* handle, int status, int events) {
+    roc_panic_if_not(handle);
+
+    UDPReceiverPort& self = *(UDPReceiverPort*)handle->data;
+
+    if (status < 0) {
+        roc_log(LogError, "udp receiver: network error: dst=%s: [%s] %s",
+                packet::address_to_str(self.address_).c_str(), uv_err_name(status),
+                uv_strerror(status));
+        return;
+    }
+
+    if (events & UV_READABLE) {
+        self.receive_many_();
+    }
+}
+
 void UDPReceiverPort::alloc_cb_(uv_handle_t* handle, size_t size, uv_buf_t* buf) {
     roc_panic_if_not(handle);
     roc_panic_if_not(buf);
@@ -215,6 +316,7 @@ void UDPReceiverPort::recv_cb_(uv_udp_t* handle,
     if (nread == 0) {
         if (!sockaddr) {
             // no more data for now
+            self.flush_();
         } else {
             roc_log(LogTrace, "udp receiver: empty packet: num=%u src=%s dst=%s",
                     self.packet_counter_, packet::address_to_str(src_addr).c_str(),
@@ -236,18 +338,331 @@ void UDPReceiverPort::recv_cb_(uv_udp_t* handle,
         return;
     }
 
-    self.packet_counter_++;
-
-    roc_log(LogTrace, "udp receiver: received packet: num=%u src=%s dst=%s nread=%ld",
-            self.packet_counter_, packet::address_to_str(src_addr).c_str(),
-            packet::address_to_str(self.address_).c_str(), (long)nread);
-
     if ((size_t)nread > bp->size()) {
         roc_panic("udp receiver: unexpected buffer size: got %ld, max %ld", (long)nread,
                   (long)bp->size());
     }
 
-    packet::PacketPtr pp = new (self.packet_pool_) packet::Packet(self.packet_pool_);
+    self.add_packet_(src_addr, core::Slice<uint8_t>(*bp, 0, (size_t)nread), 0);
+}
+
+bool UDPReceiverPort::open_udp_() {
+    if (reuseport_) {
+        roc_log(LogError, "udp receiver: SO_REUSEPORT is not supported on this platform");
+        return false;
+    }
+
+    if (int err = uv_udp_init(&loop_, &handle_)) {
+        roc_log(LogError, "udp receiver: uv_udp_init(): [%s] %s", uv_err_name(err),
+                uv_strerror(err));
+        return false;
+    }
+
+    handle_.data = this;
+    handle_initialized_ = true;
+
+    unsigned flags = 0;
+    if (address_.multicast() && address_.port() > 0) {
+        flags |= UV_UDP_REUSEADDR;
+    }
+
+    int bind_err = UV_EINVAL;
+    if (address_.version() == 6) {
+        bind_err = uv_udp_bind(&handle_, address_.saddr(), flags | UV_UDP_IPV6ONLY);
+    }
+    if (bind_err == UV_EINVAL || bind_err == UV_ENOTSUP) {
+        bind_err = uv_udp_bind(&handle_, address_.saddr(), flags);
+    }
+    if (bind_err != 0) {
+        roc_log(LogError, "udp receiver: uv_udp_bind(): [%s] %s", uv_err_name(bind_err),
+                uv_strerror(bind_err));
+        return false;
+    }
+
+    int addrlen = (int)address_.slen();
+    if (int err = uv_udp_getsockname(&handle_, address_.saddr(), &addrlen)) {
+        roc_log(LogError, "udp receiver: uv_udp_getsockname(): [%s] %s", uv_err_name(err),
+                uv_strerror(err));
+        return false;
+    }
+
+    if (addrlen != (int)address_.slen()) {
+        roc_log(
+            LogError,
+            "udp receiver: uv_udp_getsockname(): unexpected len: got=%lu expected=%lu",
+            (unsigned long)addrlen, (unsigned long)address_.slen());
+        return false;
+    }
+
+    if (int err = uv_udp_recv_start(&handle_, alloc_cb_, recv_cb_)) {
+        roc_log(LogError, "udp receiver: uv_udp_recv_start(): [%s] %s", uv_err_name(err),
+                uv_strerror(err));
+        return false;
+    }
+
+    recv_started_ = true;
+
+    return true;
+}
+
+#ifdef ROC_NETIO_HAVE_RECVMMSG
+
+bool UDPReceiverPort::open_poll_() {
+    // libuv doesn't provide a way to set SO_REUSEPORT or to read control
+    // messages and several datagrams at once, so we create the socket by
+    // ourselves and read it when libuv reports that it's readable
+    fd_ = open_socket_();
+    if (fd_ == -1) {
+        return false;
+    }
+
+    if (int err = uv_poll_init_socket(&loop_, &poll_handle_, (uv_os_sock_t)fd_)) {
+        roc_log(LogError, "udp receiver: uv_poll_init_socket(): [%s] %s",
+                uv_err_name(err), uv_strerror(err));
+        close(fd_);
+        fd_ = -1;
+        return false;
+    }
+
+    poll_handle_.data = this;
+    poll_initialized_ = true;
+
+    if (timestamps_requested_) {
+        enable_timestamps_();
+    }
+
+    if (int err = uv_poll_start(&poll_handle_, UV_READABLE, poll_cb_)) {
+        roc_log(LogError, "udp receiver: uv_poll_start(): [%s] %s", uv_err_name(err),
+                uv_strerror(err));
+        return false;
+    }
+
+    recv_started_ = true;
+
+    return true;
+}
+
+int UDPReceiverPort::open_socket_() {
+    int fd =
+        socket(address_.saddr()->sa_family, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd == -1) {
+        roc_log(LogError, "udp receiver: socket(): %s",
+                core::errno_to_str(errno).c_str());
+        return -1;
+    }
+
+    int one = 1;
+
+    if (reuseport_) {
+#ifdef ROC_NETIO_HAVE_REUSEPORT
+        if (setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &one, sizeof(one)) != 0) {
+            roc_log(LogError, "udp receiver: setsockopt(SO_REUSEPORT): %s",
+                    core::errno_to_str(errno).c_str());
+            close(fd);
+            return -1;
+        }
+#else  // !ROC_NETIO_HAVE_REUSEPORT
+        roc_log(LogError,
+                "udp receiver: SO_REUSEPORT is not supported on this platform");
+        close(fd);
+        return -1;
+#endif // ROC_NETIO_HAVE_REUSEPORT
+    }
+
+    if (address_.multicast() && (reuseport_ || address_.port() > 0)) {
+        if (setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one)) != 0) {
+            roc_log(LogError, "udp receiver: setsockopt(SO_REUSEADDR): %s",
+                    core::errno_to_str(errno).c_str());
+            close(fd);
+            return -1;
+        }
+    }
+
+    if (address_.version() == 6) {
+        // may be unsupported, in this case the socket remains dual-stack
+        (void)setsockopt(fd, IPPROTO_IPV6, IPV6_V6ONLY, &one, sizeof(one));
+    }
+
+    if (bind(fd, address_.saddr(), address_.slen()) != 0) {
+        roc_log(LogError, "udp receiver: bind(): %s", core::errno_to_str(errno).c_str());
+        close(fd);
+        return -1;
+    }
+
+    socklen_t addrlen = address_.slen();
+    if (getsockname(fd, address_.saddr(), &addrlen) != 0) {
+        roc_log(LogError, "udp receiver: getsockname(): %s",
+                core::errno_to_str(errno).c_str());
+        close(fd);
+        return -1;
+    }
+
+    if (addrlen != address_.slen()) {
+        roc_log(LogError,
+                "udp receiver: getsockname(): unexpected len: got=%lu expected=%lu",
+                (unsigned long)addrlen, (unsigned long)address_.slen());
+        close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+void UDPReceiverPort::enable_timestamps_() {
+#ifdef ROC_NETIO_HAVE_TIMESTAMPS
+    int one = 1;
+
+    if (setsockopt(fd_, SOL_SOCKET, SO_TIMESTAMPNS, &one, sizeof(one)) != 0) {
+        roc_log(LogDebug, "udp receiver: setsockopt(SO_TIMESTAMPNS): %s",
+                core::errno_to_str(errno).c_str());
+        return;
+    }
+
+    timestamps_ = true;
+#endif // ROC_NETIO_HAVE_TIMESTAMPS
+}
+
+void UDPReceiverPort::receive_many_() {
+    // read no more than fits into the batch, so that a full read fills it up
+    const size_t n_wanted = MaxBatchSize - batch_size_;
+
+    mmsghdr msgs[MaxBatchSize];
+    iovec iovs[MaxBatchSize];
+    sockaddr_storage addrs[MaxBatchSize];
+
+#ifdef ROC_NETIO_HAVE_TIMESTAMPS
+    union {
+        char buf[CMSG_SPACE(sizeof(timespec))];
+        cmsghdr align;
+    } controls[MaxBatchSize];
+#endif
+
+    size_t n_bufs = 0;
+
+    for (; n_bufs < n_wanted; n_bufs++) {
+        if (!recv_bufs_[n_bufs]) {
+            recv_bufs_[n_bufs] = new (buffer_pool_) core::Buffer<uint8_t>(buffer_pool_);
+
+            if (!recv_bufs_[n_bufs]) {
+                roc_log(LogError, "udp receiver: can't allocate buffer");
+                break;
+            }
+        }
+
+        iovs[n_bufs].iov_base = recv_bufs_[n_bufs]->data();
+        iovs[n_bufs].iov_len = recv_bufs_[n_bufs]->size();
+
+        msghdr& hdr = msgs[n_bufs].msg_hdr;
+        memset(&msgs[n_bufs], 0, sizeof(msgs[n_bufs]));
+
+        hdr.msg_name = &addrs[n_bufs];
+        hdr.msg_namelen = sizeof(addrs[n_bufs]);
+        hdr.msg_iov = &iovs[n_bufs];
+        hdr.msg_iovlen = 1;
+
+#ifdef ROC_NETIO_HAVE_TIMESTAMPS
+        if (timestamps_) {
+            hdr.msg_control = controls[n_bufs].buf;
+            hdr.msg_controllen = sizeof(controls[n_bufs].buf);
+        }
+#endif
+    }
+
+    if (n_bufs == 0) {
+        return;
+    }
+
+    int ret;
+    do {
+        ret = recvmmsg(fd_, msgs, (unsigned)n_bufs, 0, NULL);
+    } while (ret == -1 && errno == EINTR);
+
+    if (ret == -1) {
+        if (errno != EAGAIN) {
+            roc_log(LogError, "udp receiver: network error: num=%u dst=%s: %s",
+                    packet_counter_, packet::address_to_str(address_).c_str(),
+                    core::errno_to_str(errno).c_str());
+        }
+        flush_();
+        return;
+    }
+
+    for (size_t n = 0; n < (size_t)ret; n++) {
+        const msghdr& hdr = msgs[n].msg_hdr;
+        const size_t size = msgs[n].msg_len;
+
+        packet::Address src_addr;
+        if (!src_addr.set_saddr((const sockaddr*)&addrs[n])) {
+            roc_log(
+                LogError,
+                "udp receiver: can't determine source address: num=%u dst=%s nread=%ld",
+                packet_counter_, packet::address_to_str(address_).c_str(), (long)size);
+        }
+
+        if (size == 0) {
+            roc_log(LogTrace, "udp receiver: empty packet: num=%u src=%s dst=%s",
+                    packet_counter_, packet::address_to_str(src_addr).c_str(),
+                    packet::address_to_str(address_).c_str());
+            continue;
+        }
+
+        if (hdr.msg_flags & MSG_TRUNC) {
+            roc_log(LogDebug,
+                    "udp receiver:"
+                    " ignoring partial read: num=%u src=%s dst=%s nread=%ld",
+                    packet_counter_, packet::address_to_str(src_addr).c_str(),
+                    packet::address_to_str(address_).c_str(), (long)size);
+            continue;
+        }
+
+        core::nanoseconds_t timestamp = 0;
+#ifdef ROC_NETIO_HAVE_TIMESTAMPS
+        if (timestamps_) {
+            timestamp = find_timestamp(msgs[n].msg_hdr);
+        }
+#endif
+
+        // the packet now owns the buffer, a new one is allocated on next read
+        core::Slice<uint8_t> data(*recv_bufs_[n], 0, size);
+        recv_bufs_[n] = NULL;
+
+        add_packet_(src_addr, data, timestamp);
+    }
+
+    if ((size_t)ret < n_bufs) {
+        // no more data for now
+        flush_();
+    }
+}
+
+#else // !ROC_NETIO_HAVE_RECVMMSG
+
+bool UDPReceiverPort::open_poll_() {
+    return false;
+}
+
+int UDPReceiverPort::open_socket_() {
+    return -1;
+}
+
+void UDPReceiverPort::enable_timestamps_() {
+}
+
+void UDPReceiverPort::receive_many_() {
+}
+
+#endif // ROC_NETIO_HAVE_RECVMMSG
+
+void UDPReceiverPort::add_packet_(const packet::Address& src_addr,
+                                  const core::Slice<uint8_t>& data,
+                                  core::nanoseconds_t timestamp) {
+    packet_counter_++;
+
+    roc_log(LogTrace, "udp receiver: received packet: num=%u src=%s dst=%s nread=%ld",
+            packet_counter_, packet::address_to_str(src_addr).c_str(),
+            packet::address_to_str(address_).c_str(), (long)data.size());
+
+    packet::PacketPtr pp = new (packet_pool_) packet::Packet(packet_pool_);
     if (!pp) {
         roc_log(LogError, "udp receiver: can't allocate packet");
         return;
@@ -256,11 +671,30 @@ void UDPReceiverPort::recv_cb_(uv_udp_t* handle,
     pp->add_flags(packet::Packet::FlagUDP);
 
     pp->udp()->src_addr = src_addr;
-    pp->udp()->dst_addr = self.address_;
+    pp->udp()->dst_addr = address_;
+    pp->udp()->receive_timestamp = timestamp;
+
+    pp->set_data(data);
 
-    pp->set_data(core::Slice<uint8_t>(*bp, 0, (size_t)nread));
+    batch_[batch_size_++] = pp;
+
+    if (batch_size_ == MaxBatchSize) {
+        flush_();
+    }
+}
+
+void UDPReceiverPort::flush_() {
+    if (batch_size_ == 0) {
+        return;
+    }
+
+    writer_.write_many(batch_, batch_size_);
+
+    for (size_t n = 0; n < batch_size_; n++) {
+        batch_[n] = NULL;
+    }
 
-    self.writer_.write(pp);
+    batch_size_ = 0;
 }
 
 } // namespace netio
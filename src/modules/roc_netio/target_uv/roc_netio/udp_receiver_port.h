@@ -14,11 +14,15 @@
 
 #include <uv.h>
 
+#include "roc_core/buffer.h"
 #include "roc_core/buffer_pool.h"
 #include "roc_core/iallocator.h"
 #include "roc_core/list.h"
 #include "roc_core/list_node.h"
 #include "roc_core/refcnt.h"
+#include "roc_core/shared_ptr.h"
+#include "roc_core/slice.h"
+#include "roc_core/time.h"
 #include "roc_netio/basic_port.h"
 #include "roc_netio/iclose_handler.h"
 #include "roc_packet/address.h"
@@ -29,6 +33,26 @@ namespace roc {
 namespace netio {
 
 //! UDP receiver.
+//! @remarks
+//!  Received packets are collected into a batch and passed to the writer
+//!  using a single write_many() call. The batch is flushed when it's full,
+//!  when there are no more datagrams in the socket, and at the end of every
+//!  event loop iteration.
+//!
+//!  On Linux, the receiver creates the socket by itself, polls it using
+//!  uv_poll_t, and reads up to a batch of datagrams per recvmmsg() call.
+//!  Buffers that were not filled by a call are kept for the next one, so
+//!  the port holds up to a batch of pool buffers while it's open. On other
+//!  platforms, datagrams are read one by one using uv_udp_t.
+//!
+//!  If reuseport is enabled, the socket is bound with SO_REUSEPORT, so that
+//!  several receivers may be bound to the same address. The kernel then
+//!  distributes datagrams between them by the hash of the source address.
+//!
+//!  If timestamps are enabled, on Linux SO_TIMESTAMPNS is enabled on the
+//!  socket and the arrival timestamp of every datagram is taken from the
+//!  SCM_TIMESTAMPNS control message and stored in the UDP part of the packet.
+//!  Other platforms don't provide timestamps.
 class UDPReceiverPort : public BasicPort {
 public:
     //! Initialize.
@@ -38,11 +62,21 @@ public:
                     packet::IWriter& writer,
                     packet::PacketPool& packet_pool,
                     core::BufferPool<uint8_t>& buffer_pool,
-                    core::IAllocator& allocator);
+                    core::IAllocator& allocator,
+                    bool reuseport,
+                    bool timestamps);
 
     //! Destroy.
     ~UDPReceiverPort();
 
+    //! Check if reuseport may be enabled on this platform.
+    static bool reuseport_supported();
+
+    //! Get number of bytes reserved in every pool buffer.
+    //! @remarks
+    //!  Packets are received to the beginning of the buffer, so it's zero.
+    static size_t buffer_overhead();
+
     //! Get bind address.
     virtual const packet::Address& address() const;
 
@@ -53,7 +87,11 @@ public:
     virtual void async_close();
 
 private:
+    enum { MaxBatchSize = 32 };
+
     static void close_cb_(uv_handle_t* handle);
+    static void check_cb_(uv_check_t* handle);
+    static void poll_cb_(uv_poll_t* handle, int status, int events);
     static void alloc_cb_(uv_handle_t* handle, size_t size, uv_buf_t* buf);
     static void recv_cb_(uv_udp_t* handle,
                          ssize_t nread,
@@ -61,6 +99,17 @@ private:
                          const sockaddr* addr,
                          unsigned flags);
 
+    bool open_udp_();
+    bool open_poll_();
+    int open_socket_();
+    void enable_timestamps_();
+
+    void receive_many_();
+    void add_packet_(const packet::Address& src_addr,
+                     const core::Slice<uint8_t>& data,
+                     core::nanoseconds_t timestamp);
+    void flush_();
+
     ICloseHandler& close_handler_;
 
     uv_loop_t& loop_;
@@ -68,6 +117,13 @@ private:
     uv_udp_t handle_;
     bool handle_initialized_;
 
+    uv_poll_t poll_handle_;
+    bool poll_initialized_;
+    int fd_;
+
+    uv_check_t check_handle_;
+    bool check_initialized_;
+
     bool recv_started_;
     bool closed_;
 
@@ -77,6 +133,15 @@ private:
     packet::PacketPool& packet_pool_;
     core::BufferPool<uint8_t>& buffer_pool_;
 
+    const bool reuseport_;
+    const bool timestamps_requested_;
+    bool timestamps_;
+
+    packet::PacketPtr batch_[MaxBatchSize];
+    size_t batch_size_;
+
+    core::SharedPtr<core::Buffer<uint8_t> > recv_bufs_[MaxBatchSize];
+
     unsigned packet_counter_;
 };
 
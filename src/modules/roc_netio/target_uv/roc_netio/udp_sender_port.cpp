@@ -7,27 +7,56 @@
  */
 
 #include "roc_netio/udp_sender_port.h"
-#include "roc_core/helpers.h"
+#include "roc_core/atomic_ops.h"
+#include "roc_core/errno_to_str.h"
 #include "roc_core/log.h"
 #include "roc_core/panic.h"
 #include "roc_packet/address_to_str.h"
 
+#if defined(__linux__) && defined(_GNU_SOURCE)
+#include <errno.h>
+#include <netinet/in.h>
+#include <netinet/udp.h>
+#include <string.h>
+#include <sys/socket.h>
+
+#define ROC_NETIO_HAVE_SENDMMSG
+#endif
+
 namespace roc {
 namespace netio {
 
+namespace {
+
+// flags stored in the high bits of the writers counter
+const size_t ClosedFlag = ~(~size_t(0) >> 1);
+const size_t StoppedFlag = ClosedFlag >> 1;
+
+} // namespace
+
 UDPSenderPort::UDPSenderPort(ICloseHandler& close_handler,
                              const packet::Address& address,
                              uv_loop_t& event_loop,
-                             core::IAllocator& allocator)
+                             core::IAllocator& allocator,
+                             bool direct_send)
     : BasicPort(allocator)
     , close_handler_(close_handler)
     , loop_(event_loop)
     , write_sem_initialized_(false)
     , handle_initialized_(false)
     , address_(address)
+    , request_pool_(allocator, sizeof(SendRequest), false)
     , pending_(0)
-    , stopped_(true)
+    , writers_(StoppedFlag)
+    , wakeup_pending_(0)
+    , direct_send_(direct_send)
+    , closing_(false)
     , closed_(false)
+#if defined(ROC_NETIO_HAVE_SENDMMSG) && defined(UDP_SEGMENT)
+    , gso_enabled_(true)
+#else
+    , gso_enabled_(false)
+#endif
     , packet_counter_(0) {
 }
 
@@ -95,49 +124,73 @@ bool UDPSenderPort::open() {
     roc_log(LogInfo, "udp sender: opened port %s",
             packet::address_to_str(address_).c_str());
 
-    stopped_ = false;
+    // allow writes
+    core::AtomicOps::store_seq_cst(writers_, 0);
 
     return true;
 }
 
 void UDPSenderPort::async_close() {
-    core::Mutex::Lock lock(mutex_);
+    if (closing_) {
+        return;
+    }
 
-    stopped_ = true;
+    closing_ = true;
 
-    if (pending_ == 0) {
+    // only the event loop changes flags, so there is no race with other
+    // modifications of the flags
+    if (!(core::AtomicOps::load_seq_cst(writers_) & StoppedFlag)) {
+        core::AtomicOps::fetch_add_seq_cst(writers_, StoppedFlag);
+    }
+
+    if (can_close_()) {
         close_();
     }
 }
 
 void UDPSenderPort::write(const packet::PacketPtr& pp) {
-    if (!pp) {
-        roc_panic("udp sender: unexpected null packet");
-    }
+    write_many(&pp, 1);
+}
+
+void UDPSenderPort::write_many(const packet::PacketPtr* packets, size_t n_packets) {
+    for (size_t n = 0; n < n_packets; n++) {
+        const packet::PacketPtr& pp = packets[n];
+
+        if (!pp) {
+            roc_panic("udp sender: unexpected null packet");
+        }
 
-    if (!pp->udp()) {
-        roc_panic("udp sender: unexpected non-udp packet");
+        if (!pp->udp()) {
+            roc_panic("udp sender: unexpected non-udp packet");
+        }
+
+        if (!pp->data()) {
+            roc_panic("udp sender: unexpected packet w/o data");
+        }
     }
 
-    if (!pp->data()) {
-        roc_panic("udp sender: unexpected packet w/o data");
+    // while the writers counter is non-zero, the event loop won't close the
+    // port, so it's safe to use the socket and write_sem_
+    const size_t state = core::AtomicOps::fetch_add_seq_cst(writers_, 1);
+
+    if (state & ClosedFlag) {
+        core::AtomicOps::fetch_sub_release(writers_, 1);
+        return;
     }
 
-    {
-        core::Mutex::Lock lock(mutex_);
+    if (!(state & StoppedFlag)) {
+        size_t n_sent = 0;
 
-        if (stopped_) {
-            return;
+        if (direct_send_) {
+            n_sent = try_send_direct_(packets, n_packets);
         }
 
-        list_.push_back(*pp);
-        ++pending_;
+        if (n_sent < n_packets) {
+            enqueue_(packets + n_sent, n_packets - n_sent);
+        }
     }
 
-    if (int err = uv_async_send(&write_sem_)) {
-        roc_panic("udp sender: uv_async_send(): [%s] %s", uv_err_name(err),
-                  uv_strerror(err));
-    }
+    leave_writer_();
 }
 
 void UDPSenderPort::close_cb_(uv_handle_t* handle) {
@@ -167,47 +220,52 @@ void UDPSenderPort::write_sem_cb_(uv_async_t* handle) {
 
     UDPSenderPort& self = *(UDPSenderPort*)handle->data;
 
-    while (packet::PacketPtr pp = self.read_()) {
-        packet::UDP& udp = *pp->udp();
+    // packets pushed after this point will cause a new wakeup
+    core::AtomicOps::exchange_acq_rel(self.wakeup_pending_, 0);
+
+    {
+        core::Mutex::Lock lock(self.send_mutex_);
 
-        self.packet_counter_++;
+        packet::PacketPtr packets[MaxBatchSize];
 
-        roc_log(LogTrace, "udp sender: sending packet: num=%u src=%s dst=%s sz=%ld",
-                self.packet_counter_, packet::address_to_str(self.address_).c_str(),
-                packet::address_to_str(udp.dst_addr).c_str(), (long)pp->data().size());
+        while (const size_t n_packets = self.read_many_(packets, MaxBatchSize)) {
+            size_t n_sent = 0;
 
-        uv_buf_t buf;
-        buf.base = (char*)pp->data().data();
-        buf.len = pp->data().size();
+            // don't bypass packets already queued by libuv, to keep the order
+            if (self.handle_.send_queue_count == 0) {
+                n_sent = self.send_direct_(packets, n_packets);
+            }
 
-        udp.request.data = &self;
+            for (size_t n = n_sent; n < n_packets; n++) {
+                self.send_async_(packets[n]);
+            }
 
-        if (int err = uv_udp_send(&udp.request, &self.handle_, &buf, 1,
-                                  udp.dst_addr.saddr(), send_cb_)) {
-            roc_log(LogError, "udp sender: uv_udp_send(): [%s] %s", uv_err_name(err),
-                    uv_strerror(err));
-            continue;
+            for (size_t n = 0; n < n_packets; n++) {
+                packets[n] = NULL;
+            }
+
+            if (n_sent != 0) {
+                self.complete_(n_sent);
+            }
         }
+    }
 
-        // will be decremented in send_cb_()
-        pp->incref();
+    // writers that left after the port was stopped wake us up to retry
+    if (self.closing_ && self.can_close_()) {
+        self.close_();
     }
 }
 
 void UDPSenderPort::send_cb_(uv_udp_send_t* req, int status) {
     roc_panic_if_not(req);
 
-    UDPSenderPort& self = *(UDPSenderPort*)req->data;
-
-    packet::PacketPtr pp =
-        packet::Packet::container_of(ROC_CONTAINER_OF(req, packet::UDP, request));
-
-    // one reference for incref() called from write_sem_cb_()
-    // one reference for the shared pointer above
-    roc_panic_if(pp->getref() < 2);
+    SendRequest& send_req = *(SendRequest*)req->data;
+    UDPSenderPort& self = *send_req.port;
 
-    // decrement reference counter incremented in async_cb_()
-    pp->decref();
+    // keep packet alive until we're done with it, and return the request
+    // to the pool, dropping the reference held by the request
+    packet::PacketPtr pp = send_req.packet;
+    self.request_pool_.destroy(send_req);
 
     if (status < 0) {
         roc_log(LogError,
@@ -218,24 +276,277 @@ void UDPSenderPort::send_cb_(uv_udp_send_t* req, int status) {
                 (long)pp->data().size(), uv_err_name(status), uv_strerror(status));
     }
 
-    core::Mutex::Lock lock(self.mutex_);
+    self.complete_(1);
+}
 
-    --self.pending_;
+void UDPSenderPort::leave_writer_() {
+    size_t state = core::AtomicOps::load_seq_cst(writers_);
+
+    for (;;) {
+        if (state & StoppedFlag) {
+            // the event loop may be waiting for us to close the port; the
+            // flag can't be replaced with ClosedFlag until we leave
+            if (int err = uv_async_send(&write_sem_)) {
+                roc_panic("udp sender: uv_async_send(): [%s] %s", uv_err_name(err),
+                          uv_strerror(err));
+            }
+            core::AtomicOps::fetch_sub_release(writers_, 1);
+            return;
+        }
 
-    if (self.stopped_ && self.pending_ == 0) {
-        self.close_();
+        if (core::AtomicOps::compare_exchange_acq_rel(writers_, state, state - 1)) {
+            return;
+        }
     }
 }
 
-packet::PacketPtr UDPSenderPort::read_() {
-    core::Mutex::Lock lock(mutex_);
+size_t UDPSenderPort::try_send_direct_(const packet::PacketPtr* packets,
+                                       size_t n_packets) {
+    // if another writer or the event loop is sending, don't wait for it
+    if (!send_mutex_.try_lock()) {
+        return 0;
+    }
+
+    size_t n_sent = 0;
+
+    // don't bypass packets passed to the event loop, to keep the order
+    if (core::AtomicOps::load_seq_cst(pending_) == 0) {
+        while (n_sent < n_packets) {
+            size_t n_batch = n_packets - n_sent;
+            if (n_batch > MaxBatchSize) {
+                n_batch = MaxBatchSize;
+            }
+
+            const size_t n_batch_sent = send_direct_(packets + n_sent, n_batch);
 
-    packet::PacketPtr pp = list_.front();
-    if (pp) {
-        list_.remove(*pp);
+            n_sent += n_batch_sent;
+
+            if (n_batch_sent < n_batch) {
+                break;
+            }
+        }
+    }
+
+    send_mutex_.unlock();
+
+    return n_sent;
+}
+
+void UDPSenderPort::enqueue_(const packet::PacketPtr* packets, size_t n_packets) {
+    core::AtomicOps::fetch_add_seq_cst(pending_, n_packets);
+
+    for (size_t n = 0; n < n_packets; n++) {
+        queue_.push_back(*packets[n]);
+    }
+
+    if (core::AtomicOps::exchange_acq_rel(wakeup_pending_, 1) == 0) {
+        if (int err = uv_async_send(&write_sem_)) {
+            roc_panic("udp sender: uv_async_send(): [%s] %s", uv_err_name(err),
+                      uv_strerror(err));
+        }
+    }
+}
+
+size_t UDPSenderPort::read_many_(packet::PacketPtr* packets, size_t max_packets) {
+    size_t n_packets = 0;
+
+    for (; n_packets < max_packets; n_packets++) {
+        packet::PacketPtr pp = queue_.pop_front();
+        if (!pp) {
+            break;
+        }
+
+        packets[n_packets] = pp;
+    }
+
+    return n_packets;
+}
+
+#ifdef ROC_NETIO_HAVE_SENDMMSG
+
+size_t UDPSenderPort::send_direct_(const packet::PacketPtr* packets, size_t n_packets) {
+    enum {
+        // limits imposed by kernel on a single UDP GSO message
+        MaxSegments = 64,
+        MaxMessageSize = 65507
+    };
+
+    uv_os_fd_t fd;
+    if (uv_fileno((uv_handle_t*)&handle_, &fd) != 0) {
+        return 0;
+    }
+
+    mmsghdr msgs[MaxBatchSize];
+    iovec iovs[MaxBatchSize];
+    size_t msg_packets[MaxBatchSize];
+
+#ifdef UDP_SEGMENT
+    union {
+        char buf[CMSG_SPACE(sizeof(uint16_t))];
+        cmsghdr align;
+    } controls[MaxBatchSize];
+#endif
+
+    roc_panic_if(n_packets > MaxBatchSize);
+
+    for (;;) {
+        size_t n_msgs = 0;
+
+        for (size_t first = 0; first < n_packets;) {
+            packet::UDP& udp = *packets[first]->udp();
+            const size_t size = packets[first]->data().size();
+
+            size_t last = first + 1;
+
+            if (gso_enabled_) {
+                while (last < n_packets && last - first < MaxSegments
+                       && (last - first + 1) * size <= MaxMessageSize
+                       && packets[last]->data().size() == size
+                       && packets[last]->udp()->dst_addr == udp.dst_addr) {
+                    last++;
+                }
+            }
+
+            for (size_t n = first; n < last; n++) {
+                iovs[n].iov_base = packets[n]->data().data();
+                iovs[n].iov_len = packets[n]->data().size();
+            }
+
+            mmsghdr& msg = msgs[n_msgs];
+            memset(&msg, 0, sizeof(msg));
+
+            msg.msg_hdr.msg_name = udp.dst_addr.saddr();
+            msg.msg_hdr.msg_namelen = udp.dst_addr.slen();
+            msg.msg_hdr.msg_iov = &iovs[first];
+            msg.msg_hdr.msg_iovlen = last - first;
+
+#ifdef UDP_SEGMENT
+            if (last - first > 1) {
+                msg.msg_hdr.msg_control = controls[n_msgs].buf;
+                msg.msg_hdr.msg_controllen = sizeof(controls[n_msgs].buf);
+
+                cmsghdr* cmsg = CMSG_FIRSTHDR(&msg.msg_hdr);
+                cmsg->cmsg_level = IPPROTO_UDP;
+                cmsg->cmsg_type = UDP_SEGMENT;
+                cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+
+                const uint16_t segment_size = (uint16_t)size;
+                memcpy(CMSG_DATA(cmsg), &segment_size, sizeof(segment_size));
+            }
+#endif
+
+            msg_packets[n_msgs] = last - first;
+            n_msgs++;
+
+            first = last;
+        }
+
+        int ret;
+        do {
+            ret = sendmmsg(fd, msgs, (unsigned)n_msgs, 0);
+        } while (ret == -1 && errno == EINTR);
+
+        if (ret >= 0) {
+            size_t n_sent = 0;
+            for (size_t n = 0; n < (size_t)ret; n++) {
+                n_sent += msg_packets[n];
+            }
+
+            for (size_t n = 0; n < n_sent; n++) {
+                packet_counter_++;
+
+                roc_log(LogTrace, "udp sender: sent packet: num=%u src=%s dst=%s sz=%ld",
+                        packet_counter_, packet::address_to_str(address_).c_str(),
+                        packet::address_to_str(packets[n]->udp()->dst_addr).c_str(),
+                        (long)packets[n]->data().size());
+            }
+
+            return n_sent;
+        }
+
+        if (errno == EAGAIN) {
+            return 0;
+        }
+
+        if (gso_enabled_ && n_msgs < n_packets
+            && (errno == EIO || errno == EINVAL || errno == EOPNOTSUPP)) {
+            // kernel or device doesn't support UDP GSO, retry without it;
+            // other errors, e.g. ENOBUFS or ECONNREFUSED, don't disable it
+            roc_log(LogDebug, "udp sender: disabling gso: sendmmsg(): %s",
+                    core::errno_to_str(errno).c_str());
+
+            gso_enabled_ = false;
+            continue;
+        }
+
+        roc_log(LogDebug, "udp sender: sendmmsg(): %s",
+                core::errno_to_str(errno).c_str());
+
+        return 0;
+    }
+}
+
+#else // !ROC_NETIO_HAVE_SENDMMSG
+
+size_t UDPSenderPort::send_direct_(const packet::PacketPtr*, size_t) {
+    return 0;
+}
+
+#endif // ROC_NETIO_HAVE_SENDMMSG
+
+void UDPSenderPort::send_async_(const packet::PacketPtr& pp) {
+    const packet::UDP& udp = *pp->udp();
+
+    packet_counter_++;
+
+    roc_log(LogTrace, "udp sender: sending packet: num=%u src=%s dst=%s sz=%ld",
+            packet_counter_, packet::address_to_str(address_).c_str(),
+            packet::address_to_str(udp.dst_addr).c_str(), (long)pp->data().size());
+
+    uv_buf_t buf;
+    buf.base = (char*)pp->data().data();
+    buf.len = pp->data().size();
+
+    SendRequest* req = new (request_pool_) SendRequest;
+    if (!req) {
+        roc_log(LogError, "udp sender: can't allocate send request");
+        complete_(1);
+        return;
+    }
+
+    req->request.data = req;
+    req->port = this;
+    req->packet = pp;
+
+    if (int err = uv_udp_send(&req->request, &handle_, &buf, 1, udp.dst_addr.saddr(),
+                              send_cb_)) {
+        roc_log(LogError, "udp sender: uv_udp_send(): [%s] %s", uv_err_name(err),
+                uv_strerror(err));
+        request_pool_.destroy(*req);
+        complete_(1);
+        return;
+    }
+}
+
+void UDPSenderPort::complete_(size_t n_packets) {
+    core::AtomicOps::fetch_sub_acq_rel(pending_, n_packets);
+
+    if (closing_ && can_close_()) {
+        close_();
+    }
+}
+
+bool UDPSenderPort::can_close_() {
+    // writers that have not seen StoppedFlag may still push packets and use
+    // write_sem_; don't wait for them, they wake us up when they leave
+    size_t state = StoppedFlag;
+    if (!core::AtomicOps::compare_exchange_acq_rel(writers_, state,
+                                                   StoppedFlag | ClosedFlag)
+        && !(state & ClosedFlag)) {
+        return false;
     }
 
-    return pp;
+    return core::AtomicOps::load_seq_cst(pending_) == 0;
 }
 
 void UDPSenderPort::close_() {
@@ -15,7 +15,9 @@
 #include <uv.h>
 
 #include "roc_core/iallocator.h"
+#include "roc_core/mpsc_queue.h"
 #include "roc_core/mutex.h"
+#include "roc_core/pool.h"
 #include "roc_core/refcnt.h"
 #include "roc_netio/basic_port.h"
 #include "roc_netio/iclose_handler.h"
@@ -26,13 +28,30 @@ namespace roc {
 namespace netio {
 
 //! UDP sender.
+//! @remarks
+//!  Packets written to the port are sent from the event loop thread. When the
+//!  platform supports it, all queued packets are sent using a single sendmmsg()
+//!  call, and consecutive packets of equal size to the same destination are
+//!  merged into one UDP GSO message, which the kernel splits into datagrams.
+//!  Otherwise, or if the socket would block, packets are sent one by one
+//!  using libuv.
+//!
+//!  Writers don't take locks: packets are pushed to a lock-free queue, and
+//!  the event loop is woken up only if it was not already woken up since it
+//!  last drained the queue, so a burst of writes costs a single wakeup.
+//!
+//!  If direct sending is enabled, the writer first tries to send packets by
+//!  itself, and queues only packets that can't be sent without blocking.
+//!  Packets are never sent directly while there are queued packets, so their
+//!  order is preserved.
 class UDPSenderPort : public BasicPort, public packet::IWriter {
 public:
     //! Initialize.
     UDPSenderPort(ICloseHandler& close_handler,
                   const packet::Address&,
                   uv_loop_t& event_loop,
-                  core::IAllocator& allocator);
+                  core::IAllocator& allocator,
+                  bool direct_send);
 
     //! Destroy.
     ~UDPSenderPort();
@@ -51,12 +70,37 @@ public:
     //!  May be called from any thread.
     virtual void write(const packet::PacketPtr&);
 
+    //! Write multiple packets.
+    //! @remarks
+    //!  May be called from any thread. Doesn't block and doesn't wake up the
+    //!  event loop if it's already woken up.
+    virtual void write_many(const packet::PacketPtr* packets, size_t n_packets);
+
 private:
+    enum { MaxBatchSize = 64 };
+
+    struct SendRequest {
+        uv_udp_send_t request;
+        UDPSenderPort* port;
+        packet::PacketPtr packet;
+    };
+
     static void close_cb_(uv_handle_t* handle);
     static void write_sem_cb_(uv_async_t* handle);
     static void send_cb_(uv_udp_send_t* req, int status);
 
-    packet::PacketPtr read_();
+    size_t read_many_(packet::PacketPtr* packets, size_t max_packets);
+
+    size_t try_send_direct_(const packet::PacketPtr* packets, size_t n_packets);
+    void enqueue_(const packet::PacketPtr* packets, size_t n_packets);
+
+    size_t send_direct_(const packet::PacketPtr* packets, size_t n_packets);
+    void send_async_(const packet::PacketPtr& packet);
+
+    void leave_writer_();
+
+    void complete_(size_t n_packets);
+    bool can_close_();
     void close_();
 
     ICloseHandler& close_handler_;
@@ -71,13 +115,25 @@ private:
 
     packet::Address address_;
 
-    core::List<packet::Packet> list_;
-    core::Mutex mutex_;
+    core::Pool<SendRequest> request_pool_;
+
+    core::MpscQueue<packet::Packet> queue_;
 
+    // accessed atomically
     size_t pending_;
-    bool stopped_;
+    size_t writers_; // number of writers in write_many() and stop flags
+    int wakeup_pending_;
+
+    const bool direct_send_;
+
+    // serializes sending between the event loop and direct writers
+    core::Mutex send_mutex_;
+
+    bool closing_;
     bool closed_;
 
+    bool gso_enabled_;
+
     unsigned packet_counter_;
 };
 
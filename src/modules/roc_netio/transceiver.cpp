@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) 2015 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_netio/transceiver.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+#include "roc_netio/udp_receiver_port.h"
+#include "roc_packet/address_to_str.h"
+
+namespace roc {
+namespace netio {
+
+Transceiver::Transceiver(const TransceiverConfig& config,
+                         packet::PacketPool& packet_pool,
+                         core::BufferPool<uint8_t>& buffer_pool,
+                         core::IAllocator& allocator,
+                         core::BufferPool<audio::sample_t>* sample_buffer_pool)
+    : allocator_(allocator)
+    , num_loops_(config.num_loops)
+    , next_loop_(0)
+    , num_shards_(config.num_receiver_shards)
+    , direct_send_(config.direct_send)
+    , receive_timestamps_(config.receive_timestamps)
+    , valid_(false) {
+    if (num_loops_ < 1) {
+        num_loops_ = 1;
+    }
+    if (num_loops_ > MaxLoops) {
+        roc_log(LogError, "transceiver: too many event loops, using %lu instead of %lu",
+                (unsigned long)MaxLoops, (unsigned long)num_loops_);
+        num_loops_ = MaxLoops;
+    }
+
+    if (num_shards_ < 1) {
+        num_shards_ = 1;
+    }
+    if (num_shards_ > num_loops_) {
+        roc_log(LogError,
+                "transceiver: number of receiver shards can't exceed number of event"
+                " loops, using %lu instead of %lu",
+                (unsigned long)num_loops_, (unsigned long)num_shards_);
+        num_shards_ = num_loops_;
+    }
+    if (num_shards_ > 1 && !UDPReceiverPort::reuseport_supported()) {
+        roc_log(LogError,
+                "transceiver: receiver sharding is not supported on this platform,"
+                " disabling it");
+        num_shards_ = 1;
+    }
+
+    roc_log(LogDebug,
+            "transceiver: initializing: n_loops=%lu n_receiver_shards=%lu"
+            " direct_send=%d receive_timestamps=%d",
+            (unsigned long)num_loops_, (unsigned long)num_shards_, (int)direct_send_,
+            (int)receive_timestamps_);
+
+    for (size_t n = 0; n < num_loops_; n++) {
+        loops_[n].reset(new (allocator_) EventLoop(packet_pool, buffer_pool,
+                                                   sample_buffer_pool, allocator_,
+                                                   n == 0),
+                        allocator_);
+
+        if (!loops_[n]) {
+            roc_log(LogError, "transceiver: can't allocate event loop");
+            return;
+        }
+
+        if (!loops_[n]->valid()) {
+            roc_log(LogError, "transceiver: can't start event loop");
+            return;
+        }
+    }
+
+    valid_ = true;
+}
+
+Transceiver::~Transceiver() {
+    // event loops are stopped and destroyed by unique pointers
+}
+
+size_t Transceiver::buffer_overhead() {
+    return UDPReceiverPort::buffer_overhead();
+}
+
+bool Transceiver::valid() const {
+    return valid_;
+}
+
+size_t Transceiver::num_loops() const {
+    return num_loops_;
+}
+
+size_t Transceiver::num_ports() const {
+    size_t n_ports = 0;
+
+    for (size_t n = 0; n < num_loops_; n++) {
+        if (loops_[n]) {
+            n_ports += loops_[n]->num_ports();
+        }
+    }
+
+    return n_ports;
+}
+
+bool Transceiver::add_udp_receiver(packet::Address& bind_address,
+                                   packet::IWriter& writer) {
+    if (!valid()) {
+        roc_panic("transceiver: can't use invalid transceiver");
+    }
+
+    core::Mutex::Lock lock(mutex_);
+
+    if (num_shards_ == 1) {
+        return select_loop_().add_udp_receiver(bind_address, writer, false,
+                                               receive_timestamps_);
+    }
+
+    // sockets with SO_REUSEPORT may be bound to the same address, so we should
+    // check for duplicates by ourselves
+    if (has_port_(bind_address)) {
+        roc_log(LogError, "transceiver: can't add port %s: address is already used",
+                packet::address_to_str(bind_address).c_str());
+        return false;
+    }
+
+    for (size_t n = 0; n < num_shards_; n++) {
+        // the first shard writes selected port back to bind_address, so that
+        // remaining shards are bound to the same port
+        if (!select_loop_().add_udp_receiver(bind_address, writer, true,
+                                             receive_timestamps_)) {
+            if (n != 0) {
+                remove_port_(bind_address);
+            }
+            return false;
+        }
+    }
+
+    return true;
+}
+
+packet::IWriter* Transceiver::add_udp_sender(packet::Address& bind_address) {
+    if (!valid()) {
+        roc_panic("transceiver: can't use invalid transceiver");
+    }
+
+    core::Mutex::Lock lock(mutex_);
+
+    return select_loop_().add_udp_sender(bind_address, direct_send_);
+}
+
+void Transceiver::remove_port(packet::Address bind_address) {
+    if (!valid()) {
+        roc_panic("transceiver: can't use invalid transceiver");
+    }
+
+    core::Mutex::Lock lock(mutex_);
+
+    if (!remove_port_(bind_address)) {
+        roc_panic("transceiver: can't remove port %s: unknown port",
+                  packet::address_to_str(bind_address).c_str());
+    }
+}
+
+EventLoop& Transceiver::select_loop_() {
+    EventLoop& loop = *loops_[next_loop_];
+    next_loop_ = (next_loop_ + 1) % num_loops_;
+    return loop;
+}
+
+bool Transceiver::has_port_(const packet::Address& address) const {
+    for (size_t n = 0; n < num_loops_; n++) {
+        if (loops_[n]->has_port(address)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool Transceiver::remove_port_(const packet::Address& address) {
+    bool removed = false;
+
+    // a sharded receiver has a port with the same address in several loops
+    for (size_t n = 0; n < num_loops_; n++) {
+        if (loops_[n]->remove_port(address)) {
+            removed = true;
+        }
+    }
+
+    return removed;
+}
+
+} // namespace netio
+} // namespace roc
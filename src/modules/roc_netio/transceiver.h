@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) 2015 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_netio/transceiver.h
+//! @brief Network sender/receiver.
+
+#ifndef ROC_NETIO_TRANSCEIVER_H_
+#define ROC_NETIO_TRANSCEIVER_H_
+
+#include "roc_audio/units.h"
+#include "roc_core/buffer_pool.h"
+#include "roc_core/iallocator.h"
+#include "roc_core/mutex.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/unique_ptr.h"
+#include "roc_netio/event_loop.h"
+#include "roc_packet/address.h"
+#include "roc_packet/iwriter.h"
+#include "roc_packet/packet_pool.h"
+
+namespace roc {
+namespace netio {
+
+//! Transceiver parameters.
+struct TransceiverConfig {
+    //! Number of event loops.
+    //! @remarks
+    //!  Every event loop has its own thread. Ports are distributed between
+    //!  event loops in round-robin order. If greater than one, writers passed
+    //!  to receiver ports should allow concurrent writes.
+    size_t num_loops;
+
+    //! Number of sockets per receiver port.
+    //! @remarks
+    //!  If greater than one, every receiver address is bound by this number of
+    //!  sockets with SO_REUSEPORT, distributed between event loops. The kernel
+    //!  selects the socket by the hash of the source address, so all packets of
+    //!  a sender are received by the same socket and thread, and their order is
+    //!  preserved. Note that any process of the same user may join the group.
+    //!  Can't exceed the number of event loops. Ignored if SO_REUSEPORT is not
+    //!  supported.
+    size_t num_receiver_shards;
+
+    //! Send packets from the writer thread.
+    //! @remarks
+    //!  If set, sender ports write packets to the non-blocking socket directly
+    //!  from the thread that calls the writer, without waking up the event
+    //!  loop. Only packets that can't be sent immediately, e.g. because the
+    //!  socket buffer is full, are passed to the event loop.
+    bool direct_send;
+
+    //! Request kernel arrival timestamps for received packets.
+    //! @remarks
+    //!  If set, receiver ports enable SO_TIMESTAMPNS on their sockets, and the
+    //!  arrival time of every packet is stored in its UDP part, where it's used
+    //!  to measure interarrival jitter. The kernel then reads the clock for
+    //!  every datagram and passes an extra control message with it, which adds
+    //!  a small per-packet cost. Ignored if not supported by the platform.
+    bool receive_timestamps;
+
+    TransceiverConfig()
+        : num_loops(1)
+        , num_receiver_shards(1)
+        , direct_send(false)
+        , receive_timestamps(false) {
+    }
+};
+
+//! Network sender/receiver.
+//!
+//! Dispatches ports between one or several event loops. The first event
+//! loop also periodically trims packet and buffer pools. The pipeline doesn't
+//! have a thread of its own to trim its pools, so the sample buffer pool used
+//! by the pipeline may be passed to be trimmed as well.
+class Transceiver : public core::NonCopyable<> {
+public:
+    //! Initialize.
+    //!
+    //! @remarks
+    //!  Start background threads if the object was successfully constructed.
+    Transceiver(const TransceiverConfig& config,
+                packet::PacketPool& packet_pool,
+                core::BufferPool<uint8_t>& buffer_pool,
+                core::IAllocator& allocator,
+                core::BufferPool<audio::sample_t>* sample_buffer_pool = NULL);
+
+    //! Destroy. Stop all receivers and senders.
+    //!
+    //! @remarks
+    //!  Wait until background threads finish.
+    ~Transceiver();
+
+    //! Get number of bytes reserved in every buffer of the buffer pool.
+    //! @remarks
+    //!  Depending on the backend, received packets may not start at the
+    //!  beginning of the buffer. Buffers of the pool passed to the constructor
+    //!  should be this number of bytes larger than the largest packet.
+    static size_t buffer_overhead();
+
+    //! Check if transceiver was successfully constructed.
+    bool valid() const;
+
+    //! Get number of event loops.
+    size_t num_loops() const;
+
+    //! Get number of receiver and sender ports.
+    //!
+    //! @remarks
+    //!  A sharded receiver port is counted once per socket.
+    size_t num_ports() const;
+
+    //! Add UDP datagram receiver port.
+    //!
+    //! Creates a new UDP receiver and bind it to @p bind_address. The receiver
+    //! will pass packets to @p writer. Writer will be called from the network
+    //! thread. It should not block.
+    //!
+    //! If there are several event loops, writer may be called from several
+    //! network threads concurrently: by receiver shards of this address, and
+    //! by other receivers that share the same writer. In this case, writer
+    //! should allow concurrent writes, like packet::ConcurrentQueue or
+    //! pipeline::Receiver.
+    //!
+    //! If IP is zero, INADDR_ANY is used, i.e. the socket is bound to all network
+    //! interfaces. If port is zero, a random free port is selected and written
+    //! back to @p bind_address.
+    //!
+    //! @returns
+    //!  true on success or false if error occurred
+    bool add_udp_receiver(packet::Address& bind_address, packet::IWriter& writer);
+
+    //! Add UDP datagram sender port.
+    //!
+    //! Creates a new UDP sender, bind to @p bind_address, and returns a writer
+    //! that may be used to send packets from this address. Writer may be called
+    //! from any thread. It will not block the caller. If direct sending is
+    //! enabled, the writer sends packets to the network by itself.
+    //!
+    //! If IP is zero, INADDR_ANY is used, i.e. the socket is bound to all network
+    //! interfaces. If port is zero, a random free port is selected and written
+    //! back to @p bind_address.
+    //!
+    //! @returns
+    //!  a new packet writer on success or null if error occurred
+    packet::IWriter* add_udp_sender(packet::Address& bind_address);
+
+    //! Remove sender or receiver port. Wait until port will be removed.
+    void remove_port(packet::Address bind_address);
+
+private:
+    enum { MaxLoops = 32 };
+
+    EventLoop& select_loop_();
+
+    bool has_port_(const packet::Address& address) const;
+    bool remove_port_(const packet::Address& address);
+
+    core::IAllocator& allocator_;
+
+    core::UniquePtr<EventLoop> loops_[MaxLoops];
+    size_t num_loops_;
+    size_t next_loop_;
+
+    size_t num_shards_;
+
+    bool direct_send_;
+    bool receive_timestamps_;
+
+    bool valid_;
+
+    core::Mutex mutex_;
+};
+
+} // namespace netio
+} // namespace roc
+
+#endif // ROC_NETIO_TRANSCEIVER_H_
@@ -13,7 +13,8 @@ namespace roc {
 namespace packet {
 
 ConcurrentQueue::ConcurrentQueue()
-    : cond_(mutex_) {
+    : cond_(mutex_)
+    , num_waiting_(0) {
 }
 
 PacketPtr ConcurrentQueue::read() {
@@ -21,7 +22,9 @@ PacketPtr ConcurrentQueue::read() {
 
     PacketPtr packet;
     while (!(packet = list_.front())) {
+        num_waiting_++;
         cond_.wait();
+        num_waiting_--;
     }
 
     list_.remove(*packet);
@@ -29,15 +32,58 @@ PacketPtr ConcurrentQueue::read() {
     return packet;
 }
 
+size_t ConcurrentQueue::read_many(PacketPtr* packets, size_t max_packets) {
+    if (max_packets == 0) {
+        return 0;
+    }
+
+    core::Mutex::Lock lock(mutex_);
+
+    while (list_.size() == 0) {
+        num_waiting_++;
+        cond_.wait();
+        num_waiting_--;
+    }
+
+    size_t n_packets = 0;
+
+    while (n_packets < max_packets) {
+        PacketPtr packet = list_.front();
+        if (!packet) {
+            break;
+        }
+
+        list_.remove(*packet);
+        packets[n_packets++] = packet;
+    }
+
+    return n_packets;
+}
+
 void ConcurrentQueue::write(const PacketPtr& packet) {
-    if (!packet) {
-        roc_panic("concurrent queue: packet is null");
+    write_many(&packet, 1);
+}
+
+void ConcurrentQueue::write_many(const PacketPtr* packets, size_t n_packets) {
+    for (size_t n = 0; n < n_packets; n++) {
+        if (!packets[n]) {
+            roc_panic("concurrent queue: packet is null");
+        }
+    }
+
+    if (n_packets == 0) {
+        return;
     }
 
     core::Mutex::Lock lock(mutex_);
 
-    list_.push_back(*packet);
-    cond_.broadcast();
+    for (size_t n = 0; n < n_packets; n++) {
+        list_.push_back(*packets[n]);
+    }
+
+    if (num_waiting_ != 0) {
+        cond_.broadcast();
+    }
 }
 
 } // namespace packet
@@ -16,6 +16,7 @@
 #include "roc_core/list.h"
 #include "roc_core/mutex.h"
 #include "roc_core/noncopyable.h"
+#include "roc_core/stddefs.h"
 #include "roc_packet/ireader.h"
 #include "roc_packet/iwriter.h"
 #include "roc_packet/packet.h"
@@ -24,6 +25,10 @@ namespace roc {
 namespace packet {
 
 //! Concurrent blocking packet queue.
+//! @remarks
+//!  Unbounded queue protected by a mutex. Any number of threads may write
+//!  and read packets concurrently. Writers signal the condition variable
+//!  only when some reader is blocked on it.
 class ConcurrentQueue : public IReader, public IWriter, public core::NonCopyable<> {
 public:
     ConcurrentQueue();
@@ -34,15 +39,29 @@ public:
     //!  packet from the queue.
     virtual PacketPtr read();
 
+    //! Read multiple packets.
+    //! @remarks
+    //!  Blocks until the queue becomes non-empty and removes up to
+    //!  @p max_packets first packets from the queue.
+    //! @returns
+    //!  number of packets stored into @p packets, at least one.
+    virtual size_t read_many(PacketPtr* packets, size_t max_packets);
+
     //! Add packet to the queue.
     //! @remarks
     //!  Adds packet to the end of the queue.
     virtual void write(const PacketPtr& packet);
 
+    //! Add multiple packets to the queue.
+    //! @remarks
+    //!  Adds packets to the end of the queue under a single lock.
+    virtual void write_many(const PacketPtr* packets, size_t n_packets);
+
 private:
     core::Mutex mutex_;
     core::Cond cond_;
     core::List<Packet> list_;
+    size_t num_waiting_;
 };
 
 } // namespace packet
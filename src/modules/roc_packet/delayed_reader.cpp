@@ -13,6 +13,12 @@
 namespace roc {
 namespace packet {
 
+namespace {
+
+enum { FetchBatchSize = 16 };
+
+} // namespace
+
 DelayedReader::DelayedReader(IReader& reader,
                              core::nanoseconds_t delay,
                              size_t sample_rate)
@@ -39,9 +45,44 @@ PacketPtr DelayedReader::read() {
     return reader_.read();
 }
 
+size_t DelayedReader::read_many(PacketPtr* packets, size_t max_packets) {
+    if (!started_) {
+        if (!fetch_packets_()) {
+            return 0;
+        }
+
+        started_ = true;
+    }
+
+    size_t n_packets = 0;
+
+    while (n_packets < max_packets && queue_.size() != 0) {
+        packets[n_packets++] = read_queued_packet_();
+    }
+
+    if (n_packets < max_packets) {
+        n_packets += reader_.read_many(packets + n_packets, max_packets - n_packets);
+    }
+
+    return n_packets;
+}
+
+void DelayedReader::reset() {
+    queue_.reset();
+    started_ = false;
+}
+
 bool DelayedReader::fetch_packets_() {
-    while (PacketPtr pp = reader_.read()) {
-        queue_.write(pp);
+    PacketPtr packets[FetchBatchSize];
+
+    for (;;) {
+        const size_t n_packets = reader_.read_many(packets, FetchBatchSize);
+
+        queue_.write_many(packets, n_packets);
+
+        if (n_packets < FetchBatchSize) {
+            break;
+        }
     }
 
     const timestamp_t qs = queue_size_();
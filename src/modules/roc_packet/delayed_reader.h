@@ -37,6 +37,14 @@ public:
     //! Read packet.
     virtual PacketPtr read();
 
+    //! Read multiple packets.
+    virtual size_t read_many(PacketPtr* packets, size_t max_packets);
+
+    //! Reset to initial state.
+    //! @remarks
+    //!  Drops queued packets and waits for the initial delay again.
+    void reset();
+
 private:
     bool fetch_packets_();
     PacketPtr read_queued_packet_();
@@ -12,7 +12,7 @@
 #ifndef ROC_PACKET_FEC_H_
 #define ROC_PACKET_FEC_H_
 
-#include "roc_core/slice.h"
+#include "roc_core/slice_view.h"
 #include "roc_core/stddefs.h"
 #include "roc_packet/units.h"
 
@@ -46,7 +46,7 @@ struct FEC {
     //!  Repair packets are numbered in range [k; k + n), where
     //!  k is a number of source packets per block (source_block_length)
     //!  n is a number of repair packets per block.
-    size_t encoding_symbol_id;
+    uint16_t encoding_symbol_id;
 
     //! Number of a source block in a packet stream.
     //!
@@ -60,7 +60,7 @@ struct FEC {
     //!
     //! @remarks
     //!  Different blocks can have different number of source packets.
-    size_t source_block_length;
+    uint16_t source_block_length;
 
     //! Number of source packets and repair in the block to which this packet belongs to.
     //!
@@ -68,15 +68,17 @@ struct FEC {
     //!  Different blocks can have different number of packets.
     //!  Always larger than source_block_length.
     //!  This field is not supported on all FEC schemes.
-    size_t block_length;
+    uint16_t block_length;
 
     //! FECFRAME header or footer.
-    core::Slice<uint8_t> payload_id;
+    //! @remarks
+    //!  Points to the packet data buffer, which is owned by the packet.
+    core::SliceView<uint8_t> payload_id;
 
     //! FECFRAME payload.
     //! @remarks
     //!  Doesn't include FECFRAME header or footer.
-    core::Slice<uint8_t> payload;
+    core::SliceView<uint8_t> payload;
 
     //! Construct zero FEC packet.
     FEC();
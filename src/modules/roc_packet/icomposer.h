@@ -13,6 +13,7 @@
 #define ROC_PACKET_ICOMPOSER_H_
 
 #include "roc_core/slice.h"
+#include "roc_core/slice_view.h"
 #include "roc_packet/packet.h"
 
 namespace roc {
@@ -40,12 +41,13 @@ public:
     //!  payload. If the packet payload contains an inner packet, calls the inner
     //!  composer as well The @p payload_size referes to the payload of the most
     //!  inner packet. Modifies the @p packet so that its payload fields point to
-    //!  the appropriate parts of the @p buffer.
+    //!  the appropriate parts of the @p buffer. The @p buffer is usually a
+    //!  slice which is then attached to the @p packet using set_data().
     //! @returns
     //!  true if the packet was successfully prepared or false if the @p buffer
     //!  capacity is not enough.
     virtual bool
-    prepare(Packet& packet, core::Slice<uint8_t>& buffer, size_t payload_size) = 0;
+    prepare(Packet& packet, core::SliceView<uint8_t>& buffer, size_t payload_size) = 0;
 
     //! Pad packet.
     //! @remarks
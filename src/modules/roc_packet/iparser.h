@@ -12,7 +12,7 @@
 #ifndef ROC_PACKET_IPARSER_H_
 #define ROC_PACKET_IPARSER_H_
 
-#include "roc_core/slice.h"
+#include "roc_core/slice_view.h"
 #include "roc_packet/packet.h"
 
 namespace roc {
@@ -26,10 +26,11 @@ public:
     //! Parse packet from buffer.
     //! @remarks
     //!  Parses input @p buffer and fills @p packet. If the packet payload contains
-    //!  an inner packet, calls the inner parser as well.
+    //!  an inner packet, calls the inner parser as well. The @p buffer should
+    //!  be owned by the @p packet, since packet fields will point into it.
     //! @returns
     //!  true if the packet was successfully parsed or false if the packet is invalid.
-    virtual bool parse(Packet& packet, const core::Slice<uint8_t>& buffer) = 0;
+    virtual bool parse(Packet& packet, const core::SliceView<uint8_t>& buffer) = 0;
 };
 
 } // namespace packet
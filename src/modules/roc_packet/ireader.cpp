@@ -14,5 +14,18 @@ namespace packet {
 IReader::~IReader() {
 }
 
+size_t IReader::read_many(PacketPtr* packets, size_t max_packets) {
+    size_t n_packets = 0;
+
+    while (n_packets < max_packets) {
+        if (!(packets[n_packets] = read())) {
+            break;
+        }
+        n_packets++;
+    }
+
+    return n_packets;
+}
+
 } // namespace packet
 } // namespace roc
@@ -12,6 +12,7 @@
 #ifndef ROC_PACKET_IREADER_H_
 #define ROC_PACKET_IREADER_H_
 
+#include "roc_core/stddefs.h"
 #include "roc_packet/packet.h"
 
 namespace roc {
@@ -26,6 +27,15 @@ public:
     //! @returns
     //!  next available packet or NULL if there are no packets.
     virtual PacketPtr read() = 0;
+
+    //! Read multiple packets.
+    //! @returns
+    //!  number of packets stored into @p packets, or zero if there are no packets.
+    //! @remarks
+    //!  The default implementation calls read() until it returns NULL or
+    //!  @p max_packets packets are read. Readers that can pass packets in
+    //!  batches more efficiently override it.
+    virtual size_t read_many(PacketPtr* packets, size_t max_packets);
 };
 
 } // namespace packet
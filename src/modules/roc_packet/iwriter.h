@@ -12,18 +12,28 @@
 #ifndef ROC_PACKET_IWRITER_H_
 #define ROC_PACKET_IWRITER_H_
 
+#include "roc_core/stddefs.h"
 #include "roc_packet/packet.h"
 
 namespace roc {
 namespace packet {
 
 //! Packet writer interface.
+//! @remarks
+//!  Writers are not thread-safe unless documented otherwise. Writers that may
+//!  be called from several threads concurrently state this explicitly.
 class IWriter {
 public:
     virtual ~IWriter();
 
     //! Write packet.
     virtual void write(const PacketPtr&) = 0;
+
+    //! Write multiple packets.
+    //! @remarks
+    //!  The default implementation calls write() for every packet. Writers
+    //!  that can pass packets in batches more efficiently override it.
+    virtual void write_many(const PacketPtr* packets, size_t n_packets);
 };
 
 } // namespace packet
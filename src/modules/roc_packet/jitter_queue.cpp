@@ -0,0 +1,249 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_packet/jitter_queue.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace packet {
+
+JitterQueue::JitterQueue(core::IAllocator& allocator, size_t capacity)
+    : slots_(allocator)
+    , mask_(capacity - 1)
+    , head_sn_(0)
+    , span_(0)
+    , size_(0)
+    , num_dropped_(0)
+    , next_sn_(0)
+    , has_next_(false)
+    , valid_(false) {
+    if (!valid_capacity(capacity)) {
+        roc_panic("jitter queue: capacity should be a power of two in range [1; %lu]:"
+                  " capacity=%lu",
+                  (unsigned long)MaxCapacity, (unsigned long)capacity);
+    }
+
+    if (!slots_.resize(capacity)) {
+        roc_log(LogError, "jitter queue: can't allocate slots: capacity=%lu",
+                (unsigned long)capacity);
+        return;
+    }
+
+    valid_ = true;
+}
+
+bool JitterQueue::valid_capacity(size_t capacity) {
+    return capacity != 0 && capacity <= MaxCapacity && (capacity & (capacity - 1)) == 0;
+}
+
+bool JitterQueue::valid() const {
+    return valid_;
+}
+
+void JitterQueue::write(const PacketPtr& packet) {
+    roc_panic_if(!valid());
+
+    if (!packet) {
+        roc_panic("jitter queue: attempting to add null packet");
+    }
+
+    const RTP* rtp = packet->rtp();
+    if (!rtp) {
+        roc_log(LogDebug, "jitter queue: dropping packet without rtp header");
+        return;
+    }
+
+    const seqnum_t sn = rtp->seqnum;
+
+    if (has_next_) {
+        const seqnum_diff_t dist = seqnum_diff(next_sn_, sn);
+        if (dist > 0 && (size_t)dist <= slots_.size()) {
+            roc_log(LogDebug, "jitter queue: dropping late packet: next=%lu sn=%lu",
+                    (unsigned long)next_sn_, (unsigned long)sn);
+            return;
+        }
+    }
+
+    if (size_ == 0) {
+        head_sn_ = sn;
+        span_ = 0;
+    } else if (seqnum_lt(sn, head_sn_)) {
+        if (!extend_back_(sn)) {
+            roc_log(LogDebug, "jitter queue: dropping too old packet: head=%lu sn=%lu",
+                    (unsigned long)head_sn_, (unsigned long)sn);
+            return;
+        }
+    } else if ((size_t)seqnum_diff(sn, head_sn_) > mask_) {
+        move_forward_(sn);
+    }
+
+    PacketPtr& slot = slots_[slot_(sn)];
+    if (slot) {
+        roc_log(LogDebug, "jitter queue: dropping duplicate packet: sn=%lu",
+                (unsigned long)sn);
+        return;
+    }
+
+    slot = packet;
+    size_++;
+
+    const size_t offset = (size_t)seqnum_diff(sn, head_sn_);
+    if (span_ < offset + 1) {
+        span_ = offset + 1;
+    }
+
+    if (!latest_ || latest_->compare(*packet) <= 0) {
+        latest_ = packet;
+    }
+}
+
+void JitterQueue::write_many(const PacketPtr* packets, size_t n_packets) {
+    for (size_t n = 0; n < n_packets; n++) {
+        JitterQueue::write(packets[n]);
+    }
+}
+
+PacketPtr JitterQueue::read() {
+    roc_panic_if(!valid());
+
+    if (size_ == 0) {
+        return NULL;
+    }
+
+    PacketPtr& slot = slots_[slot_(head_sn_)];
+
+    PacketPtr packet = slot;
+    slot = NULL;
+    size_--;
+
+    next_sn_ = seqnum_t(head_sn_ + 1);
+    has_next_ = true;
+
+    head_sn_ = next_sn_;
+    span_--;
+
+    skip_empty_();
+
+    return packet;
+}
+
+size_t JitterQueue::read_many(PacketPtr* packets, size_t max_packets) {
+    size_t n_packets = 0;
+
+    for (; n_packets < max_packets; n_packets++) {
+        if (!(packets[n_packets] = JitterQueue::read())) {
+            break;
+        }
+    }
+
+    return n_packets;
+}
+
+size_t JitterQueue::size() const {
+    return size_;
+}
+
+size_t JitterQueue::num_dropped() const {
+    return num_dropped_;
+}
+
+PacketPtr JitterQueue::head() const {
+    if (size_ == 0) {
+        return NULL;
+    }
+    return slots_[slot_(head_sn_)];
+}
+
+PacketPtr JitterQueue::tail() const {
+    if (size_ == 0) {
+        return NULL;
+    }
+    return slots_[slot_(seqnum_t(head_sn_ + span_ - 1))];
+}
+
+PacketPtr JitterQueue::latest() const {
+    return latest_;
+}
+
+void JitterQueue::reset() {
+    for (size_t n = 0; n < span_; n++) {
+        slots_[slot_(seqnum_t(head_sn_ + n))] = NULL;
+    }
+
+    head_sn_ = 0;
+    span_ = 0;
+    size_ = 0;
+    num_dropped_ = 0;
+
+    next_sn_ = 0;
+    has_next_ = false;
+
+    latest_ = NULL;
+}
+
+size_t JitterQueue::slot_(seqnum_t sn) const {
+    return sn & mask_;
+}
+
+bool JitterQueue::extend_back_(seqnum_t sn) {
+    const size_t shift = (size_t)seqnum_diff(head_sn_, sn);
+
+    if (span_ + shift > slots_.size()) {
+        return false;
+    }
+
+    head_sn_ = sn;
+    span_ += shift;
+
+    return true;
+}
+
+void JitterQueue::move_forward_(seqnum_t sn) {
+    const size_t shift = (size_t)seqnum_diff(sn, head_sn_) - mask_;
+
+    size_t n_dropped = 0;
+
+    for (size_t n = 0; n < shift && n < span_; n++) {
+        PacketPtr& slot = slots_[slot_(seqnum_t(head_sn_ + n))];
+        if (slot) {
+            slot = NULL;
+            size_--;
+            n_dropped++;
+        }
+    }
+
+    roc_log(LogDebug, "jitter queue: queue is full, moving window: shift=%lu dropped=%lu",
+            (unsigned long)shift, (unsigned long)n_dropped);
+
+    num_dropped_ += n_dropped;
+
+    head_sn_ = seqnum_t(head_sn_ + shift);
+    span_ = span_ > shift ? span_ - shift : 0;
+
+    skip_empty_();
+
+    if (size_ == 0) {
+        head_sn_ = sn;
+    }
+}
+
+void JitterQueue::skip_empty_() {
+    if (size_ == 0) {
+        span_ = 0;
+        return;
+    }
+
+    while (!slots_[slot_(head_sn_)]) {
+        head_sn_++;
+        span_--;
+    }
+}
+
+} // namespace packet
+} // namespace roc
@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_packet/jitter_queue.h
+//! @brief Jitter queue.
+
+#ifndef ROC_PACKET_JITTER_QUEUE_H_
+#define ROC_PACKET_JITTER_QUEUE_H_
+
+#include "roc_core/array.h"
+#include "roc_core/iallocator.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/stddefs.h"
+#include "roc_packet/ireader.h"
+#include "roc_packet/iwriter.h"
+#include "roc_packet/packet.h"
+#include "roc_packet/units.h"
+
+namespace roc {
+namespace packet {
+
+//! Jitter queue.
+//!
+//! Reorders RTP packets using a ring buffer indexed by seqnum modulo capacity.
+//! Insertion, duplicate detection, and reading the head packet take constant
+//! time, regardless of the number of queued packets and the amount of reordering.
+//!
+//! The queue holds a window of at most @c capacity consecutive seqnums:
+//!  - a packet that doesn't fit the window because it's too new, moves the
+//!    window forward, and queued packets that fall out of it are dropped
+//!  - a packet that doesn't fit the window because it's too old, is dropped
+//!  - a packet preceding an already read packet is considered late and is dropped
+//!  - a packet with the same seqnum as a queued packet is dropped
+//!  - a packet without RTP header is dropped
+class JitterQueue : public IWriter, public IReader, public core::NonCopyable<> {
+public:
+    //! Maximum capacity.
+    enum { MaxCapacity = 32768 };
+
+    //! Check if @p capacity is a valid queue capacity.
+    static bool valid_capacity(size_t capacity);
+
+    //! Initialize.
+    //! @remarks
+    //!  @p capacity defines the maximum number of consecutive seqnums in the
+    //!  queue; it should be a power of two not greater than MaxCapacity.
+    JitterQueue(core::IAllocator& allocator, size_t capacity);
+
+    //! Check if the object was successfully constructed.
+    bool valid() const;
+
+    //! Add packet to the queue.
+    virtual void write(const PacketPtr& packet);
+
+    //! Add multiple packets to the queue.
+    virtual void write_many(const PacketPtr* packets, size_t n_packets);
+
+    //! Read next packet.
+    //! @returns
+    //!  the packet with the smallest seqnum or null if there are no packets
+    //! @remarks
+    //!  Removes returned packet from the queue.
+    virtual PacketPtr read();
+
+    //! Read multiple packets.
+    //! @returns
+    //!  number of packets with the smallest seqnums removed from the queue.
+    virtual size_t read_many(PacketPtr* packets, size_t max_packets);
+
+    //! Get number of packets in queue.
+    size_t size() const;
+
+    //! Get number of packets dropped because the queue was full.
+    //! @remarks
+    //!  Counts packets dropped when the window was moved forward. Late and
+    //!  duplicate packets are not counted.
+    size_t num_dropped() const;
+
+    //! Get first packet in the queue.
+    //! @returns
+    //!  the packet with the smallest seqnum or null if there are no packets
+    //! @remarks
+    //!  Returned packet is not removed from the queue.
+    PacketPtr head() const;
+
+    //! Get last packet in the queue.
+    //! @returns
+    //!  the packet with the largest seqnum or null if there are no packets
+    //! @remarks
+    //!  Returned packet is not removed from the queue.
+    PacketPtr tail() const;
+
+    //! Get the latest packet that were ever added to the queue.
+    //! @remarks
+    //!  Returns null if the queue never has any packets. Otherwise, returns
+    //!  the latest ever added packet, even if that packet is not currently
+    //!  in the queue. Returned packet is not removed from the queue.
+    PacketPtr latest() const;
+
+    //! Reset to initial state.
+    //! @remarks
+    //!  Removes all packets from the queue, forgets the latest packet, and
+    //!  zeroes drop counter.
+    void reset();
+
+private:
+    size_t slot_(seqnum_t sn) const;
+
+    bool extend_back_(seqnum_t sn);
+    void move_forward_(seqnum_t sn);
+    void skip_empty_();
+
+    core::Array<PacketPtr> slots_;
+    const size_t mask_;
+
+    seqnum_t head_sn_;
+    size_t span_;
+    size_t size_;
+    size_t num_dropped_;
+
+    seqnum_t next_sn_;
+    bool has_next_;
+
+    PacketPtr latest_;
+
+    bool valid_;
+};
+
+} // namespace packet
+} // namespace roc
+
+#endif // ROC_PACKET_JITTER_QUEUE_H_
@@ -12,11 +12,15 @@
 #ifndef ROC_PACKET_PACKET_H_
 #define ROC_PACKET_PACKET_H_
 
+#include "roc_core/alignment.h"
+#include "roc_core/attributes.h"
 #include "roc_core/helpers.h"
 #include "roc_core/list_node.h"
+#include "roc_core/mpsc_queue_node.h"
 #include "roc_core/pool.h"
 #include "roc_core/refcnt.h"
 #include "roc_core/shared_ptr.h"
+#include "roc_core/slice.h"
 #include "roc_packet/fec.h"
 #include "roc_packet/print.h"
 #include "roc_packet/rtp.h"
@@ -32,7 +36,15 @@ class Packet;
 typedef core::SharedPtr<Packet> PacketPtr;
 
 //! Packet.
-class Packet : public core::RefCnt<Packet>, public core::ListNode {
+//! @remarks
+//!  The reference counter and queue links are modified by every thread passing
+//!  the packet to another one, while the headers and data are written once and
+//!  then read by the pipeline. They're placed on different cache lines, so
+//!  packets should be allocated from a cache line aligned pool, which is what
+//!  PacketPool does.
+class Packet : public core::RefCnt<Packet>,
+               public core::ListNode,
+               public core::MpscQueueNode {
 public:
     //! Constructor.
     explicit Packet(PacketPool&);
@@ -108,11 +120,6 @@ public:
         packet::print(*this, flags);
     }
 
-    //! Get pointer to packet from a pointer to its UDP part.
-    static Packet* container_of(UDP* udp) {
-        return ROC_CONTAINER_OF(udp, Packet, udp_);
-    }
-
 private:
     friend class core::RefCnt<Packet>;
 
@@ -120,7 +127,7 @@ private:
 
     PacketPool& pool_;
 
-    unsigned flags_;
+    unsigned flags_ ROC_ATTR_ALIGNED(core::CacheLineSize);
 
     UDP udp_;
     RTP rtp_;
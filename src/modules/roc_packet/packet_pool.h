@@ -22,8 +22,10 @@ namespace packet {
 class PacketPool : public core::Pool<Packet> {
 public:
     //! Constructor.
+    //! @remarks
+    //!  Packets are cache line aligned.
     PacketPool(core::IAllocator& allocator, bool poison)
-        : core::Pool<Packet>(allocator, sizeof(Packet), poison) {
+        : core::Pool<Packet>(allocator, sizeof(Packet), poison, core::CacheLineSize) {
     }
 };
 
@@ -7,10 +7,17 @@
  */
 
 #include "roc_packet/queue.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
 
 namespace roc {
 namespace packet {
 
+Queue::Queue(size_t max_size)
+    : max_size_(max_size)
+    , num_dropped_(0) {
+}
+
 PacketPtr Queue::read() {
     PacketPtr packet = list_.front();
     if (!packet) {
@@ -20,16 +27,61 @@ PacketPtr Queue::read() {
     return packet;
 }
 
+size_t Queue::read_many(PacketPtr* packets, size_t max_packets) {
+    size_t n_packets = 0;
+
+    for (; n_packets < max_packets; n_packets++) {
+        Packet* packet = list_.front_borrowed();
+        if (!packet) {
+            break;
+        }
+        packets[n_packets] = packet;
+        list_.remove(*packet);
+    }
+
+    return n_packets;
+}
+
 void Queue::write(const PacketPtr& packet) {
     if (!packet) {
         roc_panic("queue: null packet");
     }
-    list_.push_back(*packet);
+    push_(*packet);
+}
+
+void Queue::write_many(const PacketPtr* packets, size_t n_packets) {
+    for (size_t n = 0; n < n_packets; n++) {
+        if (!packets[n]) {
+            roc_panic("queue: null packet");
+        }
+        push_(*packets[n]);
+    }
 }
 
 size_t Queue::size() const {
     return list_.size();
 }
 
+size_t Queue::num_dropped() const {
+    return num_dropped_;
+}
+
+void Queue::reset() {
+    while (PacketPtr packet = list_.front()) {
+        list_.remove(*packet);
+    }
+    num_dropped_ = 0;
+}
+
+void Queue::push_(Packet& packet) {
+    if (max_size_ > 0 && list_.size() == max_size_) {
+        roc_log(LogDebug, "queue: queue is full, dropping oldest packet: max_size=%lu",
+                (unsigned long)max_size_);
+        list_.remove(*list_.front_borrowed());
+        num_dropped_++;
+    }
+    list_.push_back(packet);
+}
+
 } // namespace packet
 } // namespace roc
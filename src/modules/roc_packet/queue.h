@@ -14,6 +14,7 @@
 
 #include "roc_core/list.h"
 #include "roc_core/noncopyable.h"
+#include "roc_core/stddefs.h"
 #include "roc_packet/ireader.h"
 #include "roc_packet/iwriter.h"
 #include "roc_packet/packet.h"
@@ -24,21 +25,49 @@ namespace packet {
 //! Packet queue.
 class Queue : public IReader, public IWriter, public core::NonCopyable<> {
 public:
+    //! Initialize.
+    //! @remarks
+    //!  @p max_size defines the maximum number of packets in queue; when the
+    //!  queue is full, the oldest packet is dropped to make room for a new one.
+    //!  0 means no limit.
+    explicit Queue(size_t max_size = 0);
+
     //! Read next packet.
     //! @returns
     //!  the first packet in the queue or null if there are no packets.
     virtual PacketPtr read();
 
+    //! Read multiple packets.
+    //! @returns
+    //!  number of packets removed from the beginning of the queue.
+    virtual size_t read_many(PacketPtr* packets, size_t max_packets);
+
     //! Add packet to the queue.
     //! @remarks
     //!  Adds packet to the end of the queue.
     virtual void write(const PacketPtr& packet);
 
+    //! Add multiple packets to the queue.
+    virtual void write_many(const PacketPtr* packets, size_t n_packets);
+
     //! Get number of packets in queue.
     size_t size() const;
 
+    //! Get number of packets dropped because the queue was full.
+    size_t num_dropped() const;
+
+    //! Reset to initial state.
+    //! @remarks
+    //!  Removes all packets from the queue and zeroes drop counter.
+    void reset();
+
 private:
+    void push_(Packet& packet);
+
     core::List<Packet> list_;
+
+    const size_t max_size_;
+    size_t num_dropped_;
 };
 
 } // namespace packet
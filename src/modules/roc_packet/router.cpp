@@ -48,6 +48,36 @@ bool Router::add_route(IWriter& writer, unsigned flags) {
 void Router::write(const PacketPtr& packet) {
     roc_panic_if_not(valid());
 
+    if (Route* route = find_route_(packet)) {
+        route->writer->write(packet);
+    }
+}
+
+void Router::write_many(const PacketPtr* packets, size_t n_packets) {
+    roc_panic_if_not(valid());
+
+    // pass every run of packets going to the same route as one batch
+    Route* run_route = NULL;
+    size_t run_begin = 0;
+
+    for (size_t n = 0; n < n_packets; n++) {
+        Route* route = find_route_(packets[n]);
+
+        if (route != run_route) {
+            if (run_route) {
+                run_route->writer->write_many(packets + run_begin, n - run_begin);
+            }
+            run_route = route;
+            run_begin = n;
+        }
+    }
+
+    if (run_route) {
+        run_route->writer->write_many(packets + run_begin, n_packets - run_begin);
+    }
+}
+
+Router::Route* Router::find_route_(const PacketPtr& packet) {
     if (!packet) {
         roc_panic("router: unexpected null packet");
     }
@@ -77,11 +107,21 @@ void Router::write(const PacketPtr& packet) {
                     (unsigned long)r.source, (unsigned int)r.flags);
         }
 
-        r.writer->write(packet);
-        return;
+        return &r;
     }
 
     roc_log(LogDebug, "router: can't route packet, dropping");
+
+    return NULL;
+}
+
+void Router::reset() {
+    roc_panic_if_not(valid());
+
+    for (size_t n = 0; n < routes_.size(); n++) {
+        routes_[n].source = 0;
+        routes_[n].has_source = false;
+    }
 }
 
 } // namespace packet
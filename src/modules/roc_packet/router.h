@@ -41,6 +41,17 @@ public:
     //!  Route @p packet to a writer or drop it if no routes found.
     virtual void write(const PacketPtr& packet);
 
+    //! Write multiple packets.
+    //! @remarks
+    //!  Routes every packet like write() does, but passes consecutive packets
+    //!  going to the same writer as a single batch.
+    virtual void write_many(const PacketPtr* packets, size_t n_packets);
+
+    //! Reset to initial state.
+    //! @remarks
+    //!  Keeps added routes, but forgets their detected sources.
+    void reset();
+
 private:
     struct Route {
         IWriter* writer;
@@ -49,6 +60,8 @@ private:
         bool has_source;
     };
 
+    Route* find_route_(const PacketPtr& packet);
+
     core::Array<Route> routes_;
 
     bool valid_;
@@ -12,7 +12,7 @@
 #ifndef ROC_PACKET_RTP_H_
 #define ROC_PACKET_RTP_H_
 
-#include "roc_core/slice.h"
+#include "roc_core/slice_view.h"
 #include "roc_core/stddefs.h"
 #include "roc_packet/units.h"
 
@@ -54,17 +54,19 @@ struct RTP {
     unsigned int payload_type;
 
     //! Packet header.
-    core::Slice<uint8_t> header;
+    //! @remarks
+    //!  Points to the packet data buffer, which is owned by the packet.
+    core::SliceView<uint8_t> header;
 
     //! Packet payload.
     //! @remarks
     //!  Doesn't include RTP headers and padding.
-    core::Slice<uint8_t> payload;
+    core::SliceView<uint8_t> payload;
 
     //! Packet padding.
     //! @remarks
     //!  Not included in header and payload, but affects overall packet size.
-    core::Slice<uint8_t> padding;
+    core::SliceView<uint8_t> padding;
 
     //! Construct zero RTP packet.
     RTP();
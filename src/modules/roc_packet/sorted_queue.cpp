@@ -26,6 +26,21 @@ PacketPtr SortedQueue::read() {
     return NULL;
 }
 
+size_t SortedQueue::read_many(PacketPtr* packets, size_t max_packets) {
+    size_t n_packets = 0;
+
+    for (; n_packets < max_packets; n_packets++) {
+        Packet* packet = list_.back_borrowed();
+        if (!packet) {
+            break;
+        }
+        packets[n_packets] = packet;
+        list_.remove(*packet);
+    }
+
+    return n_packets;
+}
+
 void SortedQueue::write(const PacketPtr& packet) {
     if (!packet) {
         roc_panic("sorted queue: attempting to add null packet");
@@ -83,5 +98,13 @@ PacketPtr SortedQueue::latest() const {
     return latest_;
 }
 
+void SortedQueue::reset() {
+    while (PacketPtr packet = list_.back()) {
+        list_.remove(*packet);
+    }
+
+    latest_ = NULL;
+}
+
 } // namespace packet
 } // namespace roc
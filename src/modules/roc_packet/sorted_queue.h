@@ -45,6 +45,11 @@ public:
     //!  Removes returned packet from the queue.
     virtual PacketPtr read();
 
+    //! Read multiple packets.
+    //! @returns
+    //!  number of packets removed from the beginning of the queue.
+    virtual size_t read_many(PacketPtr* packets, size_t max_packets);
+
     //! Get number of packets in queue.
     size_t size() const;
 
@@ -69,6 +74,11 @@ public:
     //!  in the queue. Returned packet is not removed from the queue.
     PacketPtr latest() const;
 
+    //! Reset to initial state.
+    //! @remarks
+    //!  Removes all packets from the queue and forgets the latest packet.
+    void reset();
+
 private:
     core::List<Packet> list_;
     PacketPtr latest_;
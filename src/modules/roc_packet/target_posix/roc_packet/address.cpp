@@ -161,6 +161,31 @@ bool Address::operator!=(const Address& other) const {
     return !(*this == other);
 }
 
+core::hashsum_t Address::hash() const {
+    const sa_family_t family = family_();
+
+    core::hashsum_t hash = core::hashsum_mem(&family, sizeof(family));
+
+    switch (family) {
+    case AF_INET:
+        core::hashsum_add(hash, &sa_.addr4.sin_addr.s_addr,
+                          sizeof(sa_.addr4.sin_addr.s_addr));
+        core::hashsum_add(hash, &sa_.addr4.sin_port, sizeof(sa_.addr4.sin_port));
+        break;
+
+    case AF_INET6:
+        core::hashsum_add(hash, sa_.addr6.sin6_addr.s6_addr,
+                          sizeof(sa_.addr6.sin6_addr.s6_addr));
+        core::hashsum_add(hash, &sa_.addr6.sin6_port, sizeof(sa_.addr6.sin6_port));
+        break;
+
+    default:
+        break;
+    }
+
+    return hash;
+}
+
 socklen_t Address::sizeof_(sa_family_t family) {
     switch (family) {
     case AF_INET:
@@ -15,6 +15,7 @@
 #include <netinet/in.h>
 #include <sys/socket.h>
 
+#include "roc_core/hashsum.h"
 #include "roc_core/stddefs.h"
 
 namespace roc {
@@ -65,6 +66,11 @@ public:
     //! Compare addresses.
     bool operator!=(const Address& other) const;
 
+    //! Compute hash of the address.
+    //! @remarks
+    //!  Addresses that are equal have the same hash.
+    core::hashsum_t hash() const;
+
 private:
     static socklen_t sizeof_(sa_family_t family);
 
@@ -6,16 +6,13 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/.
  */
 
-//! @file roc_packet/target_uv/roc_packet/udp.h
+//! @file roc_packet/udp.h
 //! @brief UDP packet.
 
 #ifndef ROC_PACKET_UDP_H_
 #define ROC_PACKET_UDP_H_
 
-#include <uv.h>
-
-#include "roc_core/slice.h"
-#include "roc_core/stddefs.h"
+#include "roc_core/time.h"
 #include "roc_packet/address.h"
 
 namespace roc {
@@ -29,8 +26,16 @@ struct UDP {
     //! Destination address.
     Address dst_addr;
 
-    //! Sender request state.
-    uv_udp_send_t request;
+    //! Packet arrival time reported by the kernel.
+    //! @remarks
+    //!  Zero if the timestamp is not available. Only differences between
+    //!  timestamps of packets received on the same host are meaningful.
+    core::nanoseconds_t receive_timestamp;
+
+    //! Construct zero UDP packet.
+    UDP()
+        : receive_timestamp(0) {
+    }
 };
 
 } // namespace packet
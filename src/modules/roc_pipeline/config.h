@@ -49,6 +49,21 @@ const int DefaultMinLatencyFactor = -1;
 //! Default maximum latency relative to target latency.
 const int DefaultMaxLatencyFactor = 2;
 
+//! Default jitter queue size, number of packets.
+const size_t DefaultJitterQueueSize = 1024;
+
+//! Default repair queue size, number of packets.
+const size_t DefaultRepairQueueSize = 256;
+
+//! Default maximum number of incoming packets not yet fetched by receiver.
+const size_t DefaultMaxQueuedPackets = 1024;
+
+//! Default number of receiver sessions kept for reuse.
+const size_t DefaultSessionPoolSize = 8;
+
+//! Default timeout after which relay forgets an inactive stream.
+const core::nanoseconds_t DefaultRelayStreamTimeout = 2 * core::Second;
+
 //! Port parameters.
 //! @remarks
 //!  On receiver, defines a listened port parameters. On sender,
@@ -127,8 +142,24 @@ struct ReceiverSessionConfig {
     packet::channel_mask_t channels;
 
     //! Packet payload type.
+    //! @remarks
+    //!  Sessions use the payload type of the first packet. In the default
+    //!  session parameters, defines the payload type of pre-built sessions.
     unsigned int payload_type;
 
+    //! Jitter queue size, number of packets.
+    //! @remarks
+    //!  Should be a power of two. Packets that are further than this
+    //!  number of seqnums from the oldest queued packet cause the oldest
+    //!  packets to be dropped.
+    size_t jitter_queue_size;
+
+    //! Repair queue size, number of packets.
+    //! @remarks
+    //!  When the queue is full, the oldest repair packet is dropped.
+    //!  0 means no limit.
+    size_t repair_queue_size;
+
     //! FEC reader parameters.
     fec::ReaderConfig fec_reader;
 
@@ -150,7 +181,9 @@ struct ReceiverSessionConfig {
     ReceiverSessionConfig()
         : target_latency(DefaultLatency)
         , channels(DefaultChannelMask)
-        , payload_type(0) {
+        , payload_type(rtp::PayloadType_L16_Stereo)
+        , jitter_queue_size(DefaultJitterQueueSize)
+        , repair_queue_size(DefaultRepairQueueSize) {
         latency_monitor.min_latency = target_latency * DefaultMinLatencyFactor;
         latency_monitor.max_latency = target_latency * DefaultMaxLatencyFactor;
     }
@@ -181,6 +214,33 @@ struct ReceiverCommonConfig {
     //! Insert weird beeps instead of silence on packet loss.
     bool beeping;
 
+    //! Number of sessions to pre-build and keep for reuse, per FEC scheme.
+    //! @remarks
+    //!  Sessions are pre-built when a port is added, for the FEC scheme of the
+    //!  port. Removed sessions are reset and returned to the pool of their FEC
+    //!  scheme unless it's full, so that creating a session doesn't allocate
+    //!  memory. Zero disables the pool.
+    size_t session_pool_size;
+
+    //! Maximum number of incoming packets not yet fetched by receiver.
+    //! @remarks
+    //!  When the limit is reached, new packets are dropped. When more than
+    //!  half of the limit is reached, repair packets are dropped before they
+    //!  are routed to sessions, so that source packets are handled first.
+    //!  0 means no limit.
+    size_t max_queued_packets;
+
+    //! Parse and route packets to sessions when they're written to receiver.
+    //! @remarks
+    //!  By default, packets are only queued when written, and are parsed and
+    //!  routed when the next frame is read. If enabled, this work is done in
+    //!  the writer thread instead, e.g. the network thread, and the reader
+    //!  thread only moves already routed packets to session pipelines.
+    //!  Writers parse packets without locks and pass them to sessions via
+    //!  lock-free queues; they share a short lock with the reader only to
+    //!  look up ports and sessions and to create new sessions.
+    bool route_on_write;
+
     ReceiverCommonConfig()
         : output_sample_rate(DefaultSampleRate)
         , output_channels(DefaultChannelMask)
@@ -188,7 +248,10 @@ struct ReceiverCommonConfig {
         , resampling(false)
         , timing(false)
         , poisoning(false)
-        , beeping(false) {
+        , beeping(false)
+        , session_pool_size(DefaultSessionPoolSize)
+        , max_queued_packets(DefaultMaxQueuedPackets)
+        , route_on_write(false) {
     }
 };
 
@@ -201,6 +264,21 @@ struct ReceiverConfig {
     ReceiverCommonConfig common;
 };
 
+//! Relay parameters.
+struct RelayConfig {
+    //! RTP validator parameters.
+    //! @remarks
+    //!  Only max_sn_jump is used, since relay doesn't inspect payload.
+    rtp::ValidatorConfig rtp_validator;
+
+    //! Stream is forgotten if no packets were received from it during this period.
+    core::nanoseconds_t stream_timeout;
+
+    RelayConfig()
+        : stream_timeout(DefaultRelayStreamTimeout) {
+    }
+};
+
 //! Converter parameters.
 struct ConverterConfig {
     //! Resampler parameters.
@@ -7,15 +7,25 @@
  */
 
 #include "roc_pipeline/receiver.h"
+#include "roc_core/atomic_ops.h"
 #include "roc_core/log.h"
 #include "roc_core/panic.h"
 #include "roc_core/shared_ptr.h"
 #include "roc_packet/address_to_str.h"
 #include "roc_pipeline/port_to_str.h"
+#include "roc_pipeline/port_utils.h"
 
 namespace roc {
 namespace pipeline {
 
+namespace {
+
+enum { RouteBatchSize = 32 };
+
+const core::nanoseconds_t DropLogInterval = 5 * core::Second;
+
+} // namespace
+
 Receiver::Receiver(const ReceiverConfig& config,
                    const fec::CodecMap& codec_map,
                    const rtp::FormatMap& format_map,
@@ -29,12 +39,23 @@ Receiver::Receiver(const ReceiverConfig& config,
     , byte_buffer_pool_(byte_buffer_pool)
     , sample_buffer_pool_(sample_buffer_pool)
     , allocator_(allocator)
+    , port_map_(allocator)
+    , session_map_(allocator)
+    , num_repair_shed_(0)
+    , num_session_dropped_(0)
+    , max_session_jitter_(0)
     , ticker_(config.common.output_sample_rate)
     , audio_reader_(NULL)
     , config_(config)
     , timestamp_(0)
     , num_channels_(packet::num_channels(config.common.output_channels))
-    , active_cond_(control_mutex_) {
+    , num_removed_dropped_(0)
+    , num_reported_dropped_(0)
+    , drop_limiter_(DropLogInterval)
+    , num_queued_(0)
+    , num_ingress_dropped_(0)
+    , active_cond_(control_mutex_)
+    , active_(false) {
     mixer_.reset(new (allocator_)
                      audio::Mixer(sample_buffer_pool, config.common.internal_frame_size),
                  allocator_);
@@ -61,7 +82,12 @@ bool Receiver::valid() {
 bool Receiver::add_port(const PortConfig& config) {
     roc_log(LogInfo, "receiver: adding port %s", port_to_str(config).c_str());
 
-    core::Mutex::Lock lock(control_mutex_);
+    core::Mutex::Lock lock(session_mutex_);
+
+    if (port_map_.find_borrowed(config.address)) {
+        roc_log(LogError, "receiver: can't create port, address is already used");
+        return false;
+    }
 
     core::SharedPtr<ReceiverPort> port =
         new (allocator_) ReceiverPort(config, format_map_, allocator_);
@@ -71,24 +97,50 @@ bool Receiver::add_port(const PortConfig& config) {
         return false;
     }
 
+    if (!port_map_.insert(*port)) {
+        roc_log(LogError, "receiver: can't create port, can't add it to index");
+        return false;
+    }
+
     ports_.push_back(*port);
+
+    prebuild_sessions_(config);
+
     return true;
 }
 
 void Receiver::iterate_ports(void (*fn)(void*, const PortConfig&), void* arg) const {
-    core::Mutex::Lock lock(control_mutex_);
-
-    core::SharedPtr<ReceiverPort> port;
+    core::Mutex::Lock lock(session_mutex_);
 
-    for (port = ports_.front(); port; port = ports_.nextof(*port)) {
+    for (ReceiverPort* port = ports_.front_borrowed(); port;
+         port = ports_.nextof_borrowed(*port)) {
         fn(arg, port->config());
     }
 }
 
 size_t Receiver::num_sessions() const {
-    core::Mutex::Lock lock(control_mutex_);
+    core::Mutex::Lock lock(session_mutex_);
+
+    return sessions_.size() + new_sessions_.size();
+}
+
+size_t Receiver::num_idle_sessions() const {
+    core::Mutex::Lock lock(session_mutex_);
 
-    return sessions_.size();
+    return idle_sessions_.size();
+}
+
+ReceiverStats Receiver::stats() const {
+    core::Mutex::Lock lock(session_mutex_);
+
+    ReceiverStats stats;
+
+    stats.num_ingress_dropped = core::AtomicOps::load_relaxed(num_ingress_dropped_);
+    stats.num_repair_shed = num_repair_shed_;
+    stats.num_session_dropped = num_session_dropped_;
+    stats.max_session_jitter = max_session_jitter_;
+
+    return stats;
 }
 
 size_t Receiver::sample_rate() const {
@@ -100,8 +152,6 @@ bool Receiver::has_clock() const {
 }
 
 sndio::ISource::State Receiver::state() const {
-    core::Mutex::Lock lock(control_mutex_);
-
     return state_();
 }
 
@@ -114,15 +164,53 @@ void Receiver::wait_active() const {
 }
 
 void Receiver::write(const packet::PacketPtr& packet) {
-    core::Mutex::Lock lock(control_mutex_);
+    write_many(&packet, 1);
+}
 
-    const State old_state = state_();
+void Receiver::write_many(const packet::PacketPtr* packets, size_t n_packets) {
+    if (config_.common.route_on_write) {
+        packet::PacketPtr batch[RouteBatchSize];
 
-    packets_.push_back(*packet);
+        size_t n_routed = 0;
 
-    if (old_state != Active) {
-        active_cond_.broadcast();
+        for (size_t n = 0; n < n_packets;) {
+            size_t n_batch = 0;
+
+            for (; n < n_packets && n_batch < RouteBatchSize; n++) {
+                if (admit_packet_()) {
+                    batch[n_batch++] = packets[n];
+                }
+            }
+
+            n_routed += route_packets_(batch, n_batch);
+        }
+
+        // a routed packet belongs to an attached or a new session, and
+        // update_state_() sees both under the same lock
+        if (n_routed != 0) {
+            activate_();
+        }
+
+        return;
     }
+
+    size_t n_pushed = 0;
+
+    for (size_t n = 0; n < n_packets; n++) {
+        if (admit_packet_()) {
+            packets_.push_back(*packets[n]);
+            n_pushed++;
+        }
+    }
+
+    if (n_pushed == 0) {
+        return;
+    }
+
+    // pairs with the fence in update_state_()
+    core::AtomicOps::fence_seq_cst();
+
+    activate_();
 }
 
 bool Receiver::read(audio::Frame& frame) {
@@ -141,77 +229,287 @@ bool Receiver::read(audio::Frame& frame) {
 }
 
 void Receiver::prepare_() {
-    core::Mutex::Lock lock(control_mutex_);
-
-    const State old_state = state_();
-
     fetch_packets_();
+    attach_sessions_();
+    deliver_packets_();
     update_sessions_();
+    update_state_();
+}
+
+void Receiver::update_state_() {
+    const bool was_active = core::AtomicOps::load_relaxed(active_);
+
+    bool is_active = false;
+
+    {
+        core::Mutex::Lock lock(session_mutex_);
+
+        update_stats_();
+
+        // A writer that adds a session after this check sees the stored
+        // state when it unlocks the mutex, and activates the receiver itself.
+        is_active = sessions_.size() != 0 || new_sessions_.size() != 0;
+        core::AtomicOps::store_release(active_, is_active);
+    }
+
+    if (!is_active) {
+        // A packet may be pushed after fetching by a writer that still sees
+        // the old state and doesn't notify us; either the writer sees the
+        // new state, or we see the packet here.
+        core::AtomicOps::fence_seq_cst();
+
+        if (!packets_.empty()) {
+            is_active = true;
+            core::AtomicOps::store_release(active_, is_active);
+        }
+    }
+
+    if (!was_active && is_active) {
+        core::Mutex::Lock lock(control_mutex_);
 
-    if (old_state != Active && state_() == Active) {
         active_cond_.broadcast();
     }
 }
 
-sndio::ISource::State Receiver::state_() const {
-    if (sessions_.size() != 0) {
-        return Active;
+void Receiver::activate_() {
+    if (core::AtomicOps::load_relaxed(active_)) {
+        return;
     }
 
-    if (packets_.size() != 0) {
+    core::Mutex::Lock lock(control_mutex_);
+
+    if (!core::AtomicOps::load_relaxed(active_)) {
+        core::AtomicOps::store_release(active_, true);
+        active_cond_.broadcast();
+    }
+}
+
+sndio::ISource::State Receiver::state_() const {
+    if (core::AtomicOps::load_acquire(active_)) {
         return Active;
     }
 
     return Inactive;
 }
 
+bool Receiver::admit_packet_() {
+    const size_t max_queued = config_.common.max_queued_packets;
+
+    const size_t num_queued = core::AtomicOps::fetch_add_relaxed(num_queued_, 1);
+
+    if (max_queued != 0 && num_queued >= max_queued) {
+        core::AtomicOps::fetch_sub_relaxed(num_queued_, 1);
+        core::AtomicOps::fetch_add_relaxed(num_ingress_dropped_, 1);
+
+        roc_log(LogDebug, "receiver: too many queued packets, dropping packet: max=%lu",
+                (unsigned long)max_queued);
+        return false;
+    }
+
+    return true;
+}
+
 void Receiver::fetch_packets_() {
+    packet::PacketPtr packets[RouteBatchSize];
+
     for (;;) {
-        packet::PacketPtr packet = packets_.front();
-        if (!packet) {
+        size_t n_packets = 0;
+
+        for (; n_packets < RouteBatchSize; n_packets++) {
+            if (!(packets[n_packets] = packets_.pop_front())) {
+                break;
+            }
+        }
+
+        if (n_packets == 0) {
             break;
         }
 
-        packets_.remove(*packet);
+        route_packets_(packets, n_packets);
 
-        if (!parse_packet_(packet)) {
-            continue;
+        if (n_packets < RouteBatchSize) {
+            break;
         }
+    }
+}
 
-        if (!route_packet_(packet)) {
-            continue;
+size_t Receiver::route_packets_(packet::PacketPtr* packets, size_t n_packets) {
+    roc_panic_if(n_packets > RouteBatchSize);
+
+    ReceiverPort* ports[RouteBatchSize];
+
+    {
+        core::Mutex::Lock lock(session_mutex_);
+
+        for (size_t n = 0; n < n_packets; n++) {
+            ports[n] = find_port_(*packets[n]);
         }
     }
-}
 
-bool Receiver::parse_packet_(const packet::PacketPtr& packet) {
-    core::SharedPtr<ReceiverPort> port;
+    for (size_t n = 0; n < n_packets; n++) {
+        if (!parse_packet_(ports[n], *packets[n])) {
+            core::AtomicOps::fetch_sub_relaxed(num_queued_, 1);
+            packets[n] = NULL;
+        }
+    }
+
+    size_t n_routed = 0;
+    size_t n_unrouted = 0;
+
+    {
+        core::Mutex::Lock lock(session_mutex_);
+
+        for (size_t n = 0; n < n_packets; n++) {
+            if (!packets[n]) {
+                continue;
+            }
+
+            // the packet is counted until the session passes it to its pipeline
+            const size_t backlog = core::AtomicOps::load_relaxed(num_queued_) - 1;
 
-    for (port = ports_.front(); port; port = ports_.nextof(*port)) {
-        if (port->handle(*packet)) {
-            return true;
+            const RouteStatus status = shed_packet_(packets[n], backlog)
+                ? Route_Drop
+                : route_packet_(packets[n]);
+
+            switch (status) {
+            case Route_Ok:
+                n_routed++;
+                packets[n] = NULL;
+                break;
+
+            case Route_Drop:
+                core::AtomicOps::fetch_sub_relaxed(num_queued_, 1);
+                packets[n] = NULL;
+                break;
+
+            case Route_NewSession:
+                n_unrouted++;
+                break;
+            }
         }
     }
 
-    roc_log(LogDebug, "receiver: ignoring packet for unknown port");
+    if (n_unrouted != 0) {
+        n_routed += route_to_new_sessions_(packets, n_packets);
+    }
+
+    return n_routed;
+}
+
+ReceiverPort* Receiver::find_port_(const packet::Packet& packet) {
+    const packet::UDP* udp = packet.udp();
+    if (!udp) {
+        return NULL;
+    }
+
+    return port_map_.find_borrowed(udp->dst_addr);
+}
+
+bool Receiver::parse_packet_(ReceiverPort* port, packet::Packet& packet) {
+    if (!packet.udp()) {
+        roc_log(LogDebug, "receiver: ignoring non-udp packet");
+        return false;
+    }
 
-    return false;
+    if (!port) {
+        roc_log(LogDebug, "receiver: ignoring packet for unknown port");
+        return false;
+    }
+
+    return port->handle(packet);
 }
 
-bool Receiver::route_packet_(const packet::PacketPtr& packet) {
-    core::SharedPtr<ReceiverSession> sess;
+bool Receiver::shed_packet_(const packet::PacketPtr& packet, size_t backlog) {
+    const size_t max_queued = config_.common.max_queued_packets;
+
+    if (max_queued == 0 || backlog <= max_queued / 2) {
+        return false;
+    }
+
+    if (!(packet->flags() & packet::Packet::FlagRepair)) {
+        return false;
+    }
 
-    for (sess = sessions_.front(); sess; sess = sessions_.nextof(*sess)) {
-        if (sess->handle(packet)) {
-            return true;
+    num_repair_shed_++;
+
+    roc_log(LogDebug, "receiver: too many queued packets, dropping repair packet:"
+                      " backlog=%lu max=%lu",
+            (unsigned long)backlog, (unsigned long)max_queued);
+
+    return true;
+}
+
+Receiver::RouteStatus Receiver::route_packet_(const packet::PacketPtr& packet) {
+    if (const packet::UDP* udp = packet->udp()) {
+        if (ReceiverSession* sess = session_map_.find_borrowed(udp->src_addr)) {
+            return sess->handle(packet) ? Route_Ok : Route_Drop;
         }
     }
 
     if (!can_create_session_(packet)) {
-        return false;
+        return Route_Drop;
+    }
+
+    core::SharedPtr<ReceiverSession> sess =
+        reuse_session_(make_session_config_(packet), packet->udp()->src_addr);
+
+    if (!sess) {
+        return Route_NewSession;
+    }
+
+    return add_session_(*sess, packet) ? Route_Ok : Route_Drop;
+}
+
+size_t Receiver::route_to_new_sessions_(packet::PacketPtr* packets, size_t n_packets) {
+    core::SharedPtr<ReceiverSession> sessions[RouteBatchSize];
+
+    // Building a session allocates and initializes its whole pipeline, so it's
+    // done without the lock, which the reader thread takes for every frame.
+    for (size_t n = 0; n < n_packets; n++) {
+        if (!packets[n]) {
+            continue;
+        }
+
+        // packets from one sender share one session
+        for (size_t m = 0; m < n && !sessions[n]; m++) {
+            if (sessions[m] && sessions[m]->key() == packets[n]->udp()->src_addr) {
+                sessions[n] = sessions[m];
+            }
+        }
+
+        if (!sessions[n]) {
+            sessions[n] = build_session_(packets[n]);
+        }
+    }
+
+    size_t n_routed = 0;
+
+    core::Mutex::Lock lock(session_mutex_);
+
+    for (size_t n = 0; n < n_packets; n++) {
+        if (!packets[n]) {
+            continue;
+        }
+
+        bool routed = false;
+
+        // another writer may have added a session for this sender meanwhile,
+        // then the session built here is destroyed after unlocking
+        if (ReceiverSession* sess =
+                session_map_.find_borrowed(packets[n]->udp()->src_addr)) {
+            routed = sess->handle(packets[n]);
+        } else if (sessions[n]) {
+            routed = add_session_(*sessions[n], packets[n]);
+        }
+
+        if (routed) {
+            n_routed++;
+        } else {
+            core::AtomicOps::fetch_sub_relaxed(num_queued_, 1);
+        }
     }
 
-    return create_session_(packet);
+    return n_routed;
 }
 
 bool Receiver::can_create_session_(const packet::PacketPtr& packet) {
@@ -220,10 +518,6 @@ bool Receiver::can_create_session_(const packet::PacketPtr& packet) {
         return false;
     }
 
-    return true;
-}
-
-bool Receiver::create_session_(const packet::PacketPtr& packet) {
     if (!packet->udp()) {
         roc_log(LogError, "receiver: can't create session, unexpected non-udp packet");
         return false;
@@ -234,31 +528,41 @@ bool Receiver::create_session_(const packet::PacketPtr& packet) {
         return false;
     }
 
-    const ReceiverSessionConfig sess_config = make_session_config_(packet);
-
-    const packet::Address src_address = packet->udp()->src_addr;
-    const packet::Address dst_address = packet->udp()->dst_addr;
-
-    roc_log(LogInfo, "receiver: creating session: src_addr=%s dst_addr=%s",
-            packet::address_to_str(src_address).c_str(),
-            packet::address_to_str(dst_address).c_str());
+    return true;
+}
 
-    core::SharedPtr<ReceiverSession> sess = new (allocator_)
-        ReceiverSession(sess_config, config_.common, src_address, codec_map_, format_map_,
-                        packet_pool_, byte_buffer_pool_, sample_buffer_pool_, allocator_);
+core::SharedPtr<ReceiverSession>
+Receiver::build_session_(const packet::PacketPtr& packet) {
+    core::SharedPtr<ReceiverSession> sess = new (allocator_) ReceiverSession(
+        make_session_config_(packet), config_.common, packet->udp()->src_addr,
+        codec_map_, format_map_, packet_pool_, byte_buffer_pool_, sample_buffer_pool_,
+        allocator_);
 
     if (!sess || !sess->valid()) {
         roc_log(LogError, "receiver: can't create session, initialization failed");
-        return false;
+        return NULL;
     }
 
-    if (!sess->handle(packet)) {
+    return sess;
+}
+
+bool Receiver::add_session_(ReceiverSession& sess, const packet::PacketPtr& packet) {
+    roc_log(LogInfo, "receiver: creating session: src_addr=%s dst_addr=%s",
+            packet::address_to_str(packet->udp()->src_addr).c_str(),
+            packet::address_to_str(packet->udp()->dst_addr).c_str());
+
+    if (!sess.handle(packet)) {
         roc_log(LogError, "receiver: can't create session, can't handle first packet");
         return false;
     }
 
-    mixer_->add(sess->reader());
-    sessions_.push_back(*sess);
+    if (!session_map_.insert(sess)) {
+        roc_log(LogError, "receiver: can't create session, can't add it to index");
+        return false;
+    }
+
+    // the session is attached to the mixer in the reader thread
+    new_sessions_.push_back(sess);
 
     return true;
 }
@@ -267,21 +571,195 @@ void Receiver::remove_session_(ReceiverSession& sess) {
     roc_log(LogInfo, "receiver: removing session");
 
     mixer_->remove(sess.reader());
-    sessions_.remove(sess);
+
+    // keep session alive while moving it to the pool
+    core::SharedPtr<ReceiverSession> sess_ptr = &sess;
+
+    {
+        core::Mutex::Lock lock(session_mutex_);
+
+        // writers route packets under the lock, so after this no packets
+        // are added to the session queue
+        session_map_.remove(sess);
+        sessions_.remove(sess);
+    }
+
+    num_removed_dropped_ += sess.num_dropped_packets();
+
+    const size_t n_dropped = sess.drop_packets();
+    if (n_dropped != 0) {
+        core::AtomicOps::fetch_sub_relaxed(num_queued_, n_dropped);
+    }
+
+    sess.reset();
+
+    core::Mutex::Lock lock(session_mutex_);
+
+    // idle sessions are pooled separately for every payload type and FEC scheme,
+    // so that sessions of one port don't occupy the pool of another port
+    if (num_matching_idle_sessions_(sess) < config_.common.session_pool_size) {
+        idle_sessions_.push_back(sess);
+    }
+}
+
+core::SharedPtr<ReceiverSession>
+Receiver::reuse_session_(const ReceiverSessionConfig& sess_config,
+                         const packet::Address& src_address) {
+    for (ReceiverSession* sess = idle_sessions_.front_borrowed(); sess;
+         sess = idle_sessions_.nextof_borrowed(*sess)) {
+        if (!sess->matches(sess_config)) {
+            continue;
+        }
+
+        core::SharedPtr<ReceiverSession> sess_ptr = sess;
+
+        idle_sessions_.remove(*sess);
+        sess->set_src_address(src_address);
+
+        roc_log(LogDebug, "receiver: reusing idle session: num_idle=%lu",
+                (unsigned long)idle_sessions_.size());
+
+        return sess_ptr;
+    }
+
+    return NULL;
+}
+
+void Receiver::prebuild_sessions_(const PortConfig& port_config) {
+    ReceiverSessionConfig sess_config = config_.default_session;
+    sess_config.fec_decoder.scheme = port_fec_scheme(port_config.protocol);
+
+    if (!format_map_.format(sess_config.payload_type)) {
+        roc_log(LogDebug,
+                "receiver: not pre-building sessions, unknown payload type: pt=%u",
+                sess_config.payload_type);
+        return;
+    }
+
+    const size_t num_idle = idle_sessions_.size();
+
+    for (size_t n = num_matching_idle_sessions_(sess_config);
+         n < config_.common.session_pool_size; n++) {
+        core::SharedPtr<ReceiverSession> sess = new (allocator_) ReceiverSession(
+            sess_config, config_.common, packet::Address(), codec_map_, format_map_,
+            packet_pool_, byte_buffer_pool_, sample_buffer_pool_, allocator_);
+
+        if (!sess || !sess->valid()) {
+            roc_log(LogError, "receiver: can't pre-build session, initialization failed");
+            break;
+        }
+
+        idle_sessions_.push_back(*sess);
+    }
+
+    if (idle_sessions_.size() != num_idle) {
+        roc_log(LogDebug, "receiver: pre-built sessions: num_built=%lu num_idle=%lu",
+                (unsigned long)(idle_sessions_.size() - num_idle),
+                (unsigned long)idle_sessions_.size());
+    }
+}
+
+size_t
+Receiver::num_matching_idle_sessions_(const ReceiverSessionConfig& sess_config) const {
+    size_t n_sessions = 0;
+
+    for (ReceiverSession* sess = idle_sessions_.front_borrowed(); sess;
+         sess = idle_sessions_.nextof_borrowed(*sess)) {
+        if (sess->matches(sess_config)) {
+            n_sessions++;
+        }
+    }
+
+    return n_sessions;
+}
+
+size_t Receiver::num_matching_idle_sessions_(const ReceiverSession& sess) const {
+    size_t n_sessions = 0;
+
+    for (ReceiverSession* idle = idle_sessions_.front_borrowed(); idle;
+         idle = idle_sessions_.nextof_borrowed(*idle)) {
+        if (idle->matches(sess)) {
+            n_sessions++;
+        }
+    }
+
+    return n_sessions;
+}
+
+void Receiver::attach_sessions_() {
+    core::Mutex::Lock lock(session_mutex_);
+
+    while (ReceiverSession* sess = new_sessions_.front_borrowed()) {
+        // keep session alive while moving it between lists
+        core::SharedPtr<ReceiverSession> sess_ptr = sess;
+
+        new_sessions_.remove(*sess);
+
+        mixer_->add(sess->reader());
+        sessions_.push_back(*sess);
+    }
+}
+
+void Receiver::deliver_packets_() {
+    for (ReceiverSession* sess = sessions_.front_borrowed(); sess;
+         sess = sessions_.nextof_borrowed(*sess)) {
+        const size_t n_packets = sess->deliver_packets();
+        if (n_packets != 0) {
+            core::AtomicOps::fetch_sub_relaxed(num_queued_, n_packets);
+        }
+    }
 }
 
 void Receiver::update_sessions_() {
-    core::SharedPtr<ReceiverSession> curr, next;
+    ReceiverSession* next = NULL;
 
-    for (curr = sessions_.front(); curr; curr = next) {
-        next = sessions_.nextof(*curr);
+    for (ReceiverSession* curr = sessions_.front_borrowed(); curr; curr = next) {
+        next = sessions_.nextof_borrowed(*curr);
 
         if (!curr->update(timestamp_)) {
+            // may destroy curr
             remove_session_(*curr);
         }
     }
 }
 
+void Receiver::update_stats_() {
+    num_session_dropped_ = num_removed_dropped_;
+    max_session_jitter_ = 0;
+
+    for (ReceiverSession* sess = sessions_.front_borrowed(); sess;
+         sess = sessions_.nextof_borrowed(*sess)) {
+        num_session_dropped_ += sess->num_dropped_packets();
+        if (sess->jitter() > max_session_jitter_) {
+            max_session_jitter_ = sess->jitter();
+        }
+    }
+
+    report_drops_();
+}
+
+void Receiver::report_drops_() {
+    const size_t num_ingress_dropped =
+        core::AtomicOps::load_relaxed(num_ingress_dropped_);
+
+    const size_t num_dropped =
+        num_ingress_dropped + num_repair_shed_ + num_session_dropped_;
+
+    if (num_dropped == num_reported_dropped_ || !drop_limiter_.allow()) {
+        return;
+    }
+
+    roc_log(LogInfo,
+            "receiver: dropped %lu packets since last report, totals: ingress_dropped=%lu"
+            " repair_shed=%lu session_dropped=%lu max_queued=%lu",
+            (unsigned long)(num_dropped - num_reported_dropped_),
+            (unsigned long)num_ingress_dropped, (unsigned long)num_repair_shed_,
+            (unsigned long)num_session_dropped_,
+            (unsigned long)config_.common.max_queued_packets);
+
+    num_reported_dropped_ = num_dropped;
+}
+
 ReceiverSessionConfig
 Receiver::make_session_config_(const packet::PacketPtr& packet) const {
     ReceiverSessionConfig sess_config = config_.default_session;
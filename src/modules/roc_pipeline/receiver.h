@@ -15,12 +15,19 @@
 #include "roc_audio/ireader.h"
 #include "roc_audio/mixer.h"
 #include "roc_audio/poison_reader.h"
+#include "roc_core/alignment.h"
+#include "roc_core/attributes.h"
 #include "roc_core/buffer_pool.h"
 #include "roc_core/cond.h"
+#include "roc_core/hashmap.h"
 #include "roc_core/iallocator.h"
 #include "roc_core/list.h"
+#include "roc_core/mpsc_queue.h"
 #include "roc_core/mutex.h"
 #include "roc_core/noncopyable.h"
+#include "roc_core/rate_limiter.h"
+#include "roc_core/shared_ptr.h"
+#include "roc_core/time.h"
 #include "roc_core/unique_ptr.h"
 #include "roc_fec/codec_map.h"
 #include "roc_packet/ireader.h"
@@ -35,6 +42,32 @@
 namespace roc {
 namespace pipeline {
 
+//! Receiver statistics.
+struct ReceiverStats {
+    //! Number of packets dropped because too many incoming packets were queued.
+    size_t num_ingress_dropped;
+
+    //! Number of repair packets dropped to handle an incoming packets backlog.
+    size_t num_repair_shed;
+
+    //! Number of packets dropped because session queues were full.
+    size_t num_session_dropped;
+
+    //! Maximum interarrival jitter among active sessions, in nanoseconds.
+    //! @remarks
+    //!  Measured from kernel arrival timestamps, so it doesn't include the
+    //!  scheduling delays of the receiver. Zero if timestamps are not enabled
+    //!  in the transceiver config or are not supported.
+    core::nanoseconds_t max_session_jitter;
+
+    ReceiverStats()
+        : num_ingress_dropped(0)
+        , num_repair_shed(0)
+        , num_session_dropped(0)
+        , max_session_jitter(0) {
+    }
+};
+
 //! Receiver pipeline.
 class Receiver : public sndio::ISource,
                  public packet::IWriter,
@@ -61,6 +94,14 @@ public:
     //! Get number of alive sessions.
     size_t num_sessions() const;
 
+    //! Get number of idle sessions in the session pool.
+    size_t num_idle_sessions() const;
+
+    //! Get numbers of dropped packets.
+    //! @remarks
+    //!  Session statistics are updated every time a frame is read.
+    ReceiverStats stats() const;
+
     //! Get current receiver state.
     virtual State state() const;
 
@@ -74,27 +115,72 @@ public:
     virtual bool has_clock() const;
 
     //! Write packet.
+    //! @remarks
+    //!  May be called from several threads concurrently, e.g. from network
+    //!  threads of several event loops.
     virtual void write(const packet::PacketPtr&);
 
+    //! Write multiple packets.
+    //! @remarks
+    //!  Same as calling write() for every packet, but takes locks once per
+    //!  batch of packets and wakes up the reader only once per call. May be
+    //!  called from several threads concurrently.
+    virtual void write_many(const packet::PacketPtr* packets, size_t n_packets);
+
     //! Read frame.
     virtual bool read(audio::Frame&);
 
 private:
+    enum RouteStatus {
+        // packet was passed to a session
+        Route_Ok,
+
+        // packet was dropped
+        Route_Drop,
+
+        // packet needs a new session, which is built without the lock
+        Route_NewSession
+    };
+
     State state_() const;
 
     void prepare_();
+    void update_state_();
+
+    void activate_();
+
+    bool admit_packet_();
 
     void fetch_packets_();
+    size_t route_packets_(packet::PacketPtr* packets, size_t n_packets);
 
-    bool parse_packet_(const packet::PacketPtr& packet);
-    bool route_packet_(const packet::PacketPtr& packet);
+    ReceiverPort* find_port_(const packet::Packet& packet);
+
+    bool parse_packet_(ReceiverPort* port, packet::Packet& packet);
+    bool shed_packet_(const packet::PacketPtr& packet, size_t backlog);
+    RouteStatus route_packet_(const packet::PacketPtr& packet);
+    size_t route_to_new_sessions_(packet::PacketPtr* packets, size_t n_packets);
 
     bool can_create_session_(const packet::PacketPtr& packet);
 
-    bool create_session_(const packet::PacketPtr& packet);
+    core::SharedPtr<ReceiverSession> build_session_(const packet::PacketPtr& packet);
+    bool add_session_(ReceiverSession& sess, const packet::PacketPtr& packet);
     void remove_session_(ReceiverSession& sess);
 
+    core::SharedPtr<ReceiverSession>
+    reuse_session_(const ReceiverSessionConfig& sess_config,
+                   const packet::Address& src_address);
+
+    void prebuild_sessions_(const PortConfig& port_config);
+
+    size_t num_matching_idle_sessions_(const ReceiverSessionConfig& sess_config) const;
+    size_t num_matching_idle_sessions_(const ReceiverSession& sess) const;
+
+    void attach_sessions_();
+    void deliver_packets_();
     void update_sessions_();
+    void update_stats_();
+    void report_drops_();
 
     ReceiverSessionConfig make_session_config_(const packet::PacketPtr& packet) const;
 
@@ -106,10 +192,26 @@ private:
     core::BufferPool<audio::sample_t>& sample_buffer_pool_;
     core::IAllocator& allocator_;
 
+    // The fields below are guarded by session_mutex_. Ports are never
+    // removed, so a port found under the lock may be used without it.
     core::List<ReceiverPort> ports_;
+
+    // ports indexed by destination address
+    core::Hashmap<ReceiverPort> port_map_;
+
+    // attached sessions, modified only by the reader thread
     core::List<ReceiverSession> sessions_;
 
-    core::List<packet::Packet> packets_;
+    // sessions created by writers, not yet attached to the mixer
+    core::List<ReceiverSession> new_sessions_;
+    core::List<ReceiverSession> idle_sessions_;
+
+    // active and new sessions indexed by source address
+    core::Hashmap<ReceiverSession> session_map_;
+
+    size_t num_repair_shed_;
+    size_t num_session_dropped_;
+    core::nanoseconds_t max_session_jitter_;
 
     core::Ticker ticker_;
 
@@ -123,9 +225,34 @@ private:
     packet::timestamp_t timestamp_;
     size_t num_channels_;
 
-    core::Mutex control_mutex_;
+    // packets dropped by removed sessions, used only by the reader thread
+    size_t num_removed_dropped_;
+
+    // total number of dropped packets when they were last logged
+    size_t num_reported_dropped_;
+    core::RateLimiter drop_limiter_;
+
     core::Mutex pipeline_mutex_;
+
+    // The fields below are modified by the network thread for every packet,
+    // keep them on different cache lines than the fields around them. The
+    // receiver is allocated without cache line alignment, so explicit padding
+    // is used instead of aligned members.
+    char pad1_[core::CacheLineSize] ROC_ATTR_UNUSED;
+
+    size_t num_queued_;
+    size_t num_ingress_dropped_;
+
+    core::MpscQueue<packet::Packet> packets_;
+
+    char pad2_[core::CacheLineSize] ROC_ATTR_UNUSED;
+
+    core::Mutex session_mutex_;
+
+    core::Mutex control_mutex_;
     core::Cond active_cond_;
+
+    bool active_;
 };
 
 } // namespace pipeline
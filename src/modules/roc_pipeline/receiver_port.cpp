@@ -40,7 +40,8 @@ ReceiverPort::ReceiverPort(const PortConfig& config,
     case Proto_RTP_LDPC_Source:
         fec_parser_.reset(
             new (allocator)
-                fec::Parser<fec::LDPC_Source_PayloadID, fec::Source, fec::Footer>(parser),
+                fec::Parser<fec::LDPC_Source_PayloadID, fec::Source, fec::Footer,
+                            rtp::Parser>(rtp_parser_.get()),
             allocator);
         if (!fec_parser_) {
             return;
@@ -60,7 +61,8 @@ ReceiverPort::ReceiverPort(const PortConfig& config,
     case Proto_RTP_RSm8_Source:
         fec_parser_.reset(
             new (allocator)
-                fec::Parser<fec::RSm8_PayloadID, fec::Source, fec::Footer>(parser),
+                fec::Parser<fec::RSm8_PayloadID, fec::Source, fec::Footer, rtp::Parser>(
+                    rtp_parser_.get()),
             allocator);
         if (!fec_parser_) {
             return;
@@ -94,6 +96,19 @@ const PortConfig& ReceiverPort::config() const {
     return config_;
 }
 
+const packet::Address& ReceiverPort::key() const {
+    return config_.address;
+}
+
+core::hashsum_t ReceiverPort::key_hash(const packet::Address& address) {
+    return address.hash();
+}
+
+bool ReceiverPort::key_equal(const packet::Address& address1,
+                             const packet::Address& address2) {
+    return address1 == address2;
+}
+
 bool ReceiverPort::handle(packet::Packet& packet) {
     roc_panic_if(!valid());
 
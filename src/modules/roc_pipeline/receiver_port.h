@@ -12,10 +12,13 @@
 #ifndef ROC_PIPELINE_RECEIVER_PORT_H_
 #define ROC_PIPELINE_RECEIVER_PORT_H_
 
+#include "roc_core/hashmap_node.h"
+#include "roc_core/hashsum.h"
 #include "roc_core/iallocator.h"
 #include "roc_core/list_node.h"
 #include "roc_core/refcnt.h"
 #include "roc_core/unique_ptr.h"
+#include "roc_packet/address.h"
 #include "roc_packet/iparser.h"
 #include "roc_pipeline/config.h"
 #include "roc_rtp/format_map.h"
@@ -27,7 +30,9 @@ namespace pipeline {
 //! Receiver port pipeline.
 //! @remarks
 //!  Created at the receiver side for every listened port.
-class ReceiverPort : public core::RefCnt<ReceiverPort>, public core::ListNode {
+class ReceiverPort : public core::RefCnt<ReceiverPort>,
+                     public core::ListNode,
+                     public core::HashmapNode {
 public:
     //! Initialize.
     ReceiverPort(const PortConfig& config,
@@ -40,6 +45,18 @@ public:
     //! Get port config.
     const PortConfig& config() const;
 
+    //! Get port address.
+    //! @remarks
+    //!  Used as the key when the port is indexed in a hashmap.
+    const packet::Address& key() const;
+
+    //! Compute hash of a port key.
+    static core::hashsum_t key_hash(const packet::Address& address);
+
+    //! Compare two port keys.
+    static bool key_equal(const packet::Address& address1,
+                          const packet::Address& address2);
+
     //! Try to handle packet on this port.
     //! @returns
     //!  true if the packet is dedicated for this port
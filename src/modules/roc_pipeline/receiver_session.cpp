@@ -13,6 +13,12 @@
 namespace roc {
 namespace pipeline {
 
+namespace {
+
+enum { DeliverBatchSize = 16 };
+
+} // namespace
+
 ReceiverSession::ReceiverSession(const ReceiverSessionConfig& session_config,
                                  const ReceiverCommonConfig& common_config,
                                  const packet::Address& src_address,
@@ -23,6 +29,8 @@ ReceiverSession::ReceiverSession(const ReceiverSessionConfig& session_config,
                                  core::BufferPool<audio::sample_t>& sample_buffer_pool,
                                  core::IAllocator& allocator)
     : src_address_(src_address)
+    , payload_type_(session_config.payload_type)
+    , fec_scheme_(session_config.fec_decoder.scheme)
     , allocator_(allocator)
     , audio_reader_(NULL) {
     const rtp::Format* format = format_map.format(session_config.payload_type);
@@ -35,13 +43,22 @@ ReceiverSession::ReceiverSession(const ReceiverSessionConfig& session_config,
         return;
     }
 
-    source_queue_.reset(new (allocator_) packet::SortedQueue(0), allocator_);
-    if (!source_queue_) {
+    source_queue_.reset(new (allocator_) packet::JitterQueue(
+                            allocator_, session_config.jitter_queue_size),
+                        allocator_);
+    if (!source_queue_ || !source_queue_->valid()) {
         return;
     }
 
     packet::IWriter* pwriter = source_queue_.get();
 
+    jitter_meter_.reset(new (allocator_) rtp::JitterMeter(*pwriter, format->sample_rate),
+                        allocator_);
+    if (!jitter_meter_) {
+        return;
+    }
+    pwriter = jitter_meter_.get();
+
     if (!queue_router_->add_route(*pwriter, packet::Packet::FlagAudio)) {
         return;
     }
@@ -66,7 +83,10 @@ ReceiverSession::ReceiverSession(const ReceiverSessionConfig& session_config,
     preader = validator_.get();
 
     if (session_config.fec_decoder.scheme != packet::FEC_None) {
-        repair_queue_.reset(new (allocator_) packet::SortedQueue(0), allocator_);
+        // repair packets have no RTP header, and fec::Reader sorts them anyway
+        repair_queue_.reset(new (allocator_)
+                                packet::Queue(session_config.repair_queue_size),
+                            allocator_);
         if (!repair_queue_) {
             return;
         }
@@ -185,6 +205,66 @@ bool ReceiverSession::valid() const {
     return audio_reader_;
 }
 
+bool ReceiverSession::matches(const ReceiverSessionConfig& session_config) const {
+    return session_config.payload_type == payload_type_
+        && session_config.fec_decoder.scheme == fec_scheme_;
+}
+
+bool ReceiverSession::matches(const ReceiverSession& other) const {
+    return other.payload_type_ == payload_type_ && other.fec_scheme_ == fec_scheme_;
+}
+
+void ReceiverSession::reset() {
+    roc_panic_if(!valid());
+
+    drop_packets();
+
+    queue_router_->reset();
+
+    jitter_meter_->reset();
+    source_queue_->reset();
+    if (repair_queue_) {
+        repair_queue_->reset();
+    }
+
+    delayed_reader_->reset();
+    validator_->reset();
+
+    if (fec_reader_) {
+        fec_reader_->reset();
+        fec_validator_->reset();
+    }
+
+    depacketizer_->reset();
+
+    if (watchdog_) {
+        watchdog_->reset();
+    }
+
+    // latency monitor sets the initial scaling, so it goes after resampler
+    if (resampler_) {
+        resampler_->reset();
+    }
+    latency_monitor_->reset();
+}
+
+void ReceiverSession::set_src_address(const packet::Address& src_address) {
+    src_address_ = src_address;
+}
+
+const packet::Address& ReceiverSession::key() const {
+    return src_address_;
+}
+
+core::hashsum_t ReceiverSession::key_hash(const packet::Address& src_address) {
+    return src_address.hash();
+}
+
+bool ReceiverSession::key_equal(const packet::Address& src_address1,
+                                const packet::Address& src_address2) {
+    return src_address1 == src_address2;
+}
+
 bool ReceiverSession::handle(const packet::PacketPtr& packet) {
     roc_panic_if(!valid());
 
@@ -197,10 +277,51 @@ bool ReceiverSession::handle(const packet::PacketPtr& packet) {
         return false;
     }
 
-    queue_router_->write(packet);
+    pending_packets_.push_back(*packet);
     return true;
 }
 
+size_t ReceiverSession::deliver_packets() {
+    roc_panic_if(!valid());
+
+    packet::PacketPtr packets[DeliverBatchSize];
+
+    size_t n_delivered = 0;
+
+    for (;;) {
+        size_t n_packets = 0;
+
+        for (; n_packets < DeliverBatchSize; n_packets++) {
+            if (!(packets[n_packets] = pending_packets_.pop_front())) {
+                break;
+            }
+        }
+
+        if (n_packets == 0) {
+            break;
+        }
+
+        queue_router_->write_many(packets, n_packets);
+        n_delivered += n_packets;
+
+        if (n_packets < DeliverBatchSize) {
+            break;
+        }
+    }
+
+    return n_delivered;
+}
+
+size_t ReceiverSession::drop_packets() {
+    size_t n_dropped = 0;
+
+    while (pending_packets_.pop_front()) {
+        n_dropped++;
+    }
+
+    return n_dropped;
+}
+
 bool ReceiverSession::update(packet::timestamp_t time) {
     roc_panic_if(!valid());
 
@@ -219,6 +340,23 @@ bool ReceiverSession::update(packet::timestamp_t time) {
     return true;
 }
 
+size_t ReceiverSession::num_dropped_packets() const {
+    roc_panic_if(!valid());
+
+    size_t num_dropped = source_queue_->num_dropped();
+    if (repair_queue_) {
+        num_dropped += repair_queue_->num_dropped();
+    }
+
+    return num_dropped;
+}
+
+core::nanoseconds_t ReceiverSession::jitter() const {
+    roc_panic_if(!valid());
+
+    return jitter_meter_->jitter();
+}
+
 audio::IReader& ReceiverSession::reader() {
     roc_panic_if(!valid());
 
@@ -20,8 +20,11 @@
 #include "roc_audio/resampler_reader.h"
 #include "roc_audio/watchdog.h"
 #include "roc_core/buffer_pool.h"
+#include "roc_core/hashmap_node.h"
+#include "roc_core/hashsum.h"
 #include "roc_core/iallocator.h"
 #include "roc_core/list_node.h"
+#include "roc_core/mpsc_queue.h"
 #include "roc_core/refcnt.h"
 #include "roc_core/unique_ptr.h"
 #include "roc_fec/codec_map.h"
@@ -31,12 +34,14 @@
 #include "roc_packet/delayed_reader.h"
 #include "roc_packet/iparser.h"
 #include "roc_packet/ireader.h"
+#include "roc_packet/jitter_queue.h"
 #include "roc_packet/packet.h"
 #include "roc_packet/packet_pool.h"
+#include "roc_packet/queue.h"
 #include "roc_packet/router.h"
-#include "roc_packet/sorted_queue.h"
 #include "roc_pipeline/config.h"
 #include "roc_rtp/format_map.h"
+#include "roc_rtp/jitter_meter.h"
 #include "roc_rtp/parser.h"
 #include "roc_rtp/validator.h"
 
@@ -46,7 +51,9 @@ namespace pipeline {
 //! Receiver session pipeline.
 //! @remarks
 //!  Created at the receiver side for every connected sender.
-class ReceiverSession : public core::RefCnt<ReceiverSession>, public core::ListNode {
+class ReceiverSession : public core::RefCnt<ReceiverSession>,
+                        public core::ListNode,
+                        public core::HashmapNode {
 public:
     //! Initialize.
     ReceiverSession(const ReceiverSessionConfig& session_config,
@@ -62,16 +69,69 @@ public:
     //! Check if the session pipeline was succefully constructed.
     bool valid() const;
 
+    //! Check if the session pipeline was built for given parameters.
+    //! @remarks
+    //!  An idle session can be reused for a new sender if its payload type and
+    //!  FEC scheme match.
+    bool matches(const ReceiverSessionConfig& session_config) const;
+
+    //! Check if two session pipelines were built for the same parameters.
+    bool matches(const ReceiverSession& other) const;
+
+    //! Reset session pipeline to initial state.
+    //! @remarks
+    //!  Drops all queued packets and resets every pipeline stage, but keeps
+    //!  allocated objects and memory, so the session can be reused.
+    void reset();
+
+    //! Set address of the sender of this session.
+    void set_src_address(const packet::Address& src_address);
+
+    //! Get address of the sender of this session.
+    //! @remarks
+    //!  Used as the key when the session is indexed in a hashmap.
+    const packet::Address& key() const;
+
+    //! Compute hash of a session key.
+    static core::hashsum_t key_hash(const packet::Address& src_address);
+
+    //! Compare two session keys.
+    static bool key_equal(const packet::Address& src_address1,
+                          const packet::Address& src_address2);
+
     //! Try to route a packet to this session.
     //! @returns
     //!  true if the packet is dedicated for this session
+    //! @remarks
+    //!  The packet is added to a lock-free queue until deliver_packets() is
+    //!  called, so handle() may be called from other threads concurrently
+    //!  with the thread that reads the session.
     bool handle(const packet::PacketPtr& packet);
 
+    //! Pass packets queued by handle() to session pipeline.
+    //! @returns
+    //!  number of passed packets.
+    size_t deliver_packets();
+
+    //! Drop packets queued by handle().
+    //! @returns
+    //!  number of dropped packets.
+    size_t drop_packets();
+
     //! Update session.
     //! @returns
     //!  false if the session is terminated
     bool update(packet::timestamp_t time);
 
+    //! Get number of packets dropped because session queues were full.
+    size_t num_dropped_packets() const;
+
+    //! Get RFC 3550 interarrival jitter of session packets, in nanoseconds.
+    //! @remarks
+    //!  Zero if packets don't have arrival timestamps, e.g. because they were
+    //!  not requested from the kernel.
+    core::nanoseconds_t jitter() const;
+
     //! Get audio reader.
     audio::IReader& reader();
 
@@ -80,16 +140,22 @@ private:
 
     void destroy();
 
-    const packet::Address src_address_;
+    packet::Address src_address_;
+
+    const unsigned int payload_type_;
+    const packet::FECScheme fec_scheme_;
 
     core::IAllocator& allocator_;
 
     audio::IReader* audio_reader_;
 
+    core::MpscQueue<packet::Packet> pending_packets_;
+
     core::UniquePtr<packet::Router> queue_router_;
 
-    core::UniquePtr<packet::SortedQueue> source_queue_;
-    core::UniquePtr<packet::SortedQueue> repair_queue_;
+    core::UniquePtr<rtp::JitterMeter> jitter_meter_;
+    core::UniquePtr<packet::JitterQueue> source_queue_;
+    core::UniquePtr<packet::Queue> repair_queue_;
 
     core::UniquePtr<packet::DelayedReader> delayed_reader_;
     core::UniquePtr<rtp::Validator> validator_;
@@ -0,0 +1,309 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_pipeline/relay.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+#include "roc_core/shared_ptr.h"
+#include "roc_packet/address_to_str.h"
+#include "roc_pipeline/port_to_str.h"
+
+namespace roc {
+namespace pipeline {
+
+namespace {
+
+enum { ForwardBatchSize = 32, MaxForwardedPackets = 128 };
+
+// Write packets using as few write_many() calls as possible, preserving the
+// order of packets written to every writer.
+void write_grouped(packet::IWriter** writers,
+                   packet::PacketPtr* packets,
+                   size_t n_packets) {
+    packet::PacketPtr group[MaxForwardedPackets];
+
+    for (size_t n = 0; n < n_packets; n++) {
+        packet::IWriter* writer = writers[n];
+        if (!writer) {
+            continue;
+        }
+
+        size_t n_group = 0;
+
+        for (size_t m = n; m < n_packets; m++) {
+            if (writers[m] != writer) {
+                continue;
+            }
+
+            group[n_group++] = packets[m];
+
+            writers[m] = NULL;
+            packets[m] = NULL;
+        }
+
+        writer->write_many(group, n_group);
+
+        for (size_t m = 0; m < n_group; m++) {
+            group[m] = NULL;
+        }
+    }
+}
+
+} // namespace
+
+Relay::Relay(const RelayConfig& config,
+             const rtp::FormatMap& format_map,
+             packet::PacketPool& packet_pool,
+             core::IAllocator& allocator)
+    : format_map_(format_map)
+    , packet_pool_(packet_pool)
+    , allocator_(allocator)
+    , config_(config)
+    , port_map_(allocator)
+    , stream_map_(allocator)
+    , last_expire_time_(0) {
+}
+
+bool Relay::add_port(const PortConfig& config) {
+    roc_log(LogInfo, "relay: adding port %s", port_to_str(config).c_str());
+
+    core::Mutex::Lock lock(mutex_);
+
+    if (port_map_.find_borrowed(config.address)) {
+        roc_log(LogError, "relay: can't create port, address is already used");
+        return false;
+    }
+
+    core::SharedPtr<RelayPort> port =
+        new (allocator_) RelayPort(config, format_map_, allocator_);
+
+    if (!port || !port->valid()) {
+        roc_log(LogError, "relay: can't create port, initialization failed");
+        return false;
+    }
+
+    if (!port_map_.insert(*port)) {
+        roc_log(LogError, "relay: can't create port, can't add it to index");
+        return false;
+    }
+
+    ports_.push_back(*port);
+
+    return true;
+}
+
+bool Relay::add_destination(const packet::Address& port_address,
+                            const packet::Address& dst_address,
+                            packet::IWriter& writer) {
+    roc_log(LogInfo, "relay: adding destination: port=%s dst=%s",
+            packet::address_to_str(port_address).c_str(),
+            packet::address_to_str(dst_address).c_str());
+
+    core::Mutex::Lock lock(mutex_);
+
+    RelayPort* port = port_map_.find_borrowed(port_address);
+    if (!port) {
+        roc_log(LogError, "relay: can't add destination, unknown port");
+        return false;
+    }
+
+    return port->add_destination(dst_address, writer);
+}
+
+size_t Relay::num_streams() const {
+    core::Mutex::Lock lock(mutex_);
+
+    return streams_.size();
+}
+
+RelayStats Relay::stats() const {
+    core::Mutex::Lock lock(mutex_);
+
+    return stats_;
+}
+
+void Relay::write(const packet::PacketPtr& packet) {
+    write_many(&packet, 1);
+}
+
+void Relay::write_many(const packet::PacketPtr* packets, size_t n_packets) {
+    for (size_t n = 0; n < n_packets; n++) {
+        if (!packets[n]) {
+            roc_panic("relay: unexpected null packet");
+        }
+    }
+
+    const core::nanoseconds_t now = core::timestamp();
+
+    while (n_packets != 0) {
+        const size_t n_batch = std::min(n_packets, (size_t)ForwardBatchSize);
+
+        forward_batch_(packets, n_batch, now);
+
+        packets += n_batch;
+        n_packets -= n_batch;
+    }
+}
+
+// Packets are validated and forwarded packets are created under the lock,
+// but they're written to destinations without it, so that a slow destination
+// writer doesn't block other threads writing to the relay. Ports are never
+// removed, so they may be used after the lock is released.
+void Relay::forward_batch_(const packet::PacketPtr* packets,
+                           size_t n_packets,
+                           core::nanoseconds_t now) {
+    RelayPort* ports[ForwardBatchSize];
+
+    packet::IWriter* writers[MaxForwardedPackets];
+    packet::PacketPtr forwarded[MaxForwardedPackets];
+
+    {
+        core::Mutex::Lock lock(mutex_);
+
+        for (size_t n = 0; n < n_packets; n++) {
+            stats_.num_received++;
+
+            if (!(ports[n] = handle_packet_(packets[n], now))) {
+                stats_.num_dropped++;
+            }
+        }
+
+        if (now - last_expire_time_ >= config_.stream_timeout) {
+            remove_expired_streams_(now);
+            last_expire_time_ = now;
+        }
+    }
+
+    size_t pkt_index = 0;
+    size_t dst_index = 0;
+
+    while (pkt_index < n_packets) {
+        size_t n_forwarded = 0;
+
+        {
+            core::Mutex::Lock lock(mutex_);
+
+            n_forwarded = prepare_forwarded_(packets, ports, n_packets, pkt_index,
+                                             dst_index, writers, forwarded);
+        }
+
+        write_grouped(writers, forwarded, n_forwarded);
+    }
+}
+
+size_t Relay::prepare_forwarded_(const packet::PacketPtr* packets,
+                                 RelayPort* const* ports,
+                                 size_t n_packets,
+                                 size_t& pkt_index,
+                                 size_t& dst_index,
+                                 packet::IWriter** writers,
+                                 packet::PacketPtr* forwarded) {
+    size_t n_forwarded = 0;
+
+    while (pkt_index < n_packets && n_forwarded < MaxForwardedPackets) {
+        RelayPort* port = ports[pkt_index];
+
+        if (!port || dst_index == port->num_destinations()) {
+            pkt_index++;
+            dst_index = 0;
+            continue;
+        }
+
+        packet::PacketPtr pp =
+            port->forward(*packets[pkt_index], dst_index, packet_pool_);
+        if (!pp) {
+            pkt_index++;
+            dst_index = 0;
+            continue;
+        }
+
+        writers[n_forwarded] = &port->destination_writer(dst_index);
+        forwarded[n_forwarded] = pp;
+
+        n_forwarded++;
+        dst_index++;
+    }
+
+    stats_.num_forwarded += n_forwarded;
+
+    return n_forwarded;
+}
+
+RelayPort* Relay::handle_packet_(const packet::PacketPtr& packet,
+                                 core::nanoseconds_t now) {
+    const packet::UDP* udp = packet->udp();
+    if (!udp) {
+        roc_log(LogDebug, "relay: ignoring non-udp packet");
+        return NULL;
+    }
+
+    RelayPort* port = port_map_.find_borrowed(udp->dst_addr);
+    if (!port) {
+        roc_log(LogDebug, "relay: ignoring packet for unknown port");
+        return NULL;
+    }
+
+    if (!port->handle(*packet)) {
+        return NULL;
+    }
+
+    RelayStream* stream = stream_map_.find_borrowed(udp->src_addr);
+
+    if (!stream) {
+        if (!packet->rtp()) {
+            roc_log(LogDebug, "relay: ignoring repair packet for unknown stream");
+            return NULL;
+        }
+
+        roc_log(LogInfo, "relay: creating stream: src_addr=%s",
+                packet::address_to_str(udp->src_addr).c_str());
+
+        core::SharedPtr<RelayStream> stream_ptr =
+            new (allocator_) RelayStream(config_, udp->src_addr, allocator_);
+
+        if (!stream_ptr) {
+            roc_log(LogError, "relay: can't create stream, allocation failed");
+            return NULL;
+        }
+
+        if (!stream_map_.insert(*stream_ptr)) {
+            roc_log(LogError, "relay: can't create stream, can't add it to index");
+            return NULL;
+        }
+
+        streams_.push_back(*stream_ptr);
+        stream = stream_ptr.get();
+    }
+
+    if (!stream->validate(*packet, now)) {
+        return NULL;
+    }
+
+    return port;
+}
+
+void Relay::remove_expired_streams_(core::nanoseconds_t now) {
+    RelayStream* next_stream;
+
+    for (RelayStream* stream = streams_.front_borrowed(); stream; stream = next_stream) {
+        next_stream = streams_.nextof_borrowed(*stream);
+
+        if (!stream->expired(now)) {
+            continue;
+        }
+
+        roc_log(LogInfo, "relay: removing stream: src_addr=%s",
+                packet::address_to_str(stream->key()).c_str());
+
+        stream_map_.remove(*stream);
+        streams_.remove(*stream);
+    }
+}
+
+} // namespace pipeline
+} // namespace roc
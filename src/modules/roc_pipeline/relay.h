@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_pipeline/relay.h
+//! @brief Relay pipeline.
+
+#ifndef ROC_PIPELINE_RELAY_H_
+#define ROC_PIPELINE_RELAY_H_
+
+#include "roc_core/hashmap.h"
+#include "roc_core/iallocator.h"
+#include "roc_core/list.h"
+#include "roc_core/mutex.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/time.h"
+#include "roc_packet/address.h"
+#include "roc_packet/iwriter.h"
+#include "roc_packet/packet_pool.h"
+#include "roc_pipeline/config.h"
+#include "roc_pipeline/relay_port.h"
+#include "roc_pipeline/relay_stream.h"
+#include "roc_rtp/format_map.h"
+
+namespace roc {
+namespace pipeline {
+
+//! Relay statistics.
+struct RelayStats {
+    //! Number of packets written to relay.
+    size_t num_received;
+
+    //! Number of packets sent to destinations.
+    //! @remarks
+    //!  A packet forwarded to N destinations is counted N times.
+    size_t num_forwarded;
+
+    //! Number of packets dropped because they were not parsed or validated.
+    size_t num_dropped;
+
+    RelayStats()
+        : num_received(0)
+        , num_forwarded(0)
+        , num_dropped(0) {
+    }
+};
+
+//! Relay pipeline.
+//!
+//! Receives source and repair packets and forwards them to one or several
+//! destinations without decoding audio or FEC. Packets are parsed only to
+//! perform light RTP validation; forwarded packets share the buffer of the
+//! received packet, so the payload is never copied or modified.
+//!
+//! Every listened port has its own list of destinations. Typically, a source
+//! port is forwarded to source ports of destinations, and a repair port is
+//! forwarded to repair ports of destinations, so that every destination can
+//! repair lost packets by itself.
+class Relay : public packet::IWriter, public core::NonCopyable<> {
+public:
+    //! Initialize.
+    Relay(const RelayConfig& config,
+          const rtp::FormatMap& format_map,
+          packet::PacketPool& packet_pool,
+          core::IAllocator& allocator);
+
+    //! Add listened port.
+    bool add_port(const PortConfig& config);
+
+    //! Add destination for listened port.
+    //! @remarks
+    //!  Packets received on port with @p port_address will be sent to
+    //!  @p dst_address using @p writer.
+    bool add_destination(const packet::Address& port_address,
+                         const packet::Address& dst_address,
+                         packet::IWriter& writer);
+
+    //! Get number of known streams.
+    size_t num_streams() const;
+
+    //! Get relay statistics.
+    RelayStats stats() const;
+
+    //! Write packet.
+    //! @remarks
+    //!  Forwards packet to destinations of the port it was received on.
+    virtual void write(const packet::PacketPtr& packet);
+
+    //! Write multiple packets.
+    //! @remarks
+    //!  Same as calling write() for every packet, but validates packets in
+    //!  batches under a single lock. Forwarded packets are written to
+    //!  destinations outside of the lock, using a single write_many() call
+    //!  per destination writer and batch.
+    virtual void write_many(const packet::PacketPtr* packets, size_t n_packets);
+
+private:
+    void forward_batch_(const packet::PacketPtr* packets,
+                        size_t n_packets,
+                        core::nanoseconds_t now);
+
+    size_t prepare_forwarded_(const packet::PacketPtr* packets,
+                              RelayPort* const* ports,
+                              size_t n_packets,
+                              size_t& pkt_index,
+                              size_t& dst_index,
+                              packet::IWriter** writers,
+                              packet::PacketPtr* forwarded);
+
+    RelayPort* handle_packet_(const packet::PacketPtr& packet, core::nanoseconds_t now);
+    void remove_expired_streams_(core::nanoseconds_t now);
+
+    const rtp::FormatMap& format_map_;
+
+    packet::PacketPool& packet_pool_;
+    core::IAllocator& allocator_;
+
+    RelayConfig config_;
+
+    core::List<RelayPort> ports_;
+    core::Hashmap<RelayPort> port_map_;
+
+    core::List<RelayStream> streams_;
+    core::Hashmap<RelayStream> stream_map_;
+
+    core::nanoseconds_t last_expire_time_;
+
+    RelayStats stats_;
+
+    core::Mutex mutex_;
+};
+
+} // namespace pipeline
+} // namespace roc
+
+#endif // ROC_PIPELINE_RELAY_H_
@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_pipeline/relay_port.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace pipeline {
+
+RelayPort::RelayPort(const PortConfig& config,
+                     const rtp::FormatMap& format_map,
+                     core::IAllocator& allocator)
+    : allocator_(allocator)
+    , destinations_(allocator) {
+    port_ = new (allocator) ReceiverPort(config, format_map, allocator);
+}
+
+void RelayPort::destroy() {
+    allocator_.destroy(*this);
+}
+
+bool RelayPort::valid() const {
+    return port_ && port_->valid();
+}
+
+const PortConfig& RelayPort::config() const {
+    roc_panic_if(!valid());
+
+    return port_->config();
+}
+
+const packet::Address& RelayPort::key() const {
+    return config().address;
+}
+
+core::hashsum_t RelayPort::key_hash(const packet::Address& address) {
+    return address.hash();
+}
+
+bool RelayPort::key_equal(const packet::Address& address1,
+                          const packet::Address& address2) {
+    return address1 == address2;
+}
+
+bool RelayPort::add_destination(const packet::Address& dst_address,
+                                packet::IWriter& writer) {
+    roc_panic_if(!valid());
+
+    if (!destinations_.grow(destinations_.size() + 1)) {
+        roc_log(LogError, "relay port: can't allocate destination");
+        return false;
+    }
+
+    Destination dst;
+    dst.address = dst_address;
+    dst.writer = &writer;
+
+    destinations_.push_back(dst);
+
+    return true;
+}
+
+size_t RelayPort::num_destinations() const {
+    return destinations_.size();
+}
+
+bool RelayPort::handle(packet::Packet& packet) {
+    roc_panic_if(!valid());
+
+    return port_->handle(packet);
+}
+
+packet::IWriter& RelayPort::destination_writer(size_t dst_index) const {
+    roc_panic_if(!valid());
+
+    return *destinations_[dst_index].writer;
+}
+
+packet::PacketPtr RelayPort::forward(const packet::Packet& packet,
+                                     size_t dst_index,
+                                     packet::PacketPool& packet_pool) const {
+    roc_panic_if(!valid());
+
+    packet::PacketPtr pp = new (packet_pool) packet::Packet(packet_pool);
+    if (!pp) {
+        roc_log(LogError, "relay port: can't allocate packet");
+        return NULL;
+    }
+
+    pp->add_flags(packet::Packet::FlagUDP | packet::Packet::FlagComposed);
+
+    pp->udp()->src_addr = config().address;
+    pp->udp()->dst_addr = destinations_[dst_index].address;
+
+    pp->set_data(packet.data());
+
+    return pp;
+}
+
+} // namespace pipeline
+} // namespace roc
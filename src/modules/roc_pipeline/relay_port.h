@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_pipeline/relay_port.h
+//! @brief Relay port pipeline.
+
+#ifndef ROC_PIPELINE_RELAY_PORT_H_
+#define ROC_PIPELINE_RELAY_PORT_H_
+
+#include "roc_core/array.h"
+#include "roc_core/hashmap_node.h"
+#include "roc_core/hashsum.h"
+#include "roc_core/iallocator.h"
+#include "roc_core/list_node.h"
+#include "roc_core/refcnt.h"
+#include "roc_core/shared_ptr.h"
+#include "roc_packet/address.h"
+#include "roc_packet/iwriter.h"
+#include "roc_packet/packet.h"
+#include "roc_packet/packet_pool.h"
+#include "roc_pipeline/config.h"
+#include "roc_pipeline/receiver_port.h"
+#include "roc_rtp/format_map.h"
+
+namespace roc {
+namespace pipeline {
+
+//! Relay port pipeline.
+//! @remarks
+//!  Created at the relay side for every listened port. Parses incoming
+//!  packets in the same way as receiver port and forwards them to the
+//!  destinations added to this port.
+class RelayPort : public core::RefCnt<RelayPort>,
+                  public core::ListNode,
+                  public core::HashmapNode {
+public:
+    //! Initialize.
+    RelayPort(const PortConfig& config,
+              const rtp::FormatMap& format_map,
+              core::IAllocator& allocator);
+
+    //! Check if the port pipeline was succefully constructed.
+    bool valid() const;
+
+    //! Get port config.
+    const PortConfig& config() const;
+
+    //! Get port address.
+    //! @remarks
+    //!  Used as the key when the port is indexed in a hashmap.
+    const packet::Address& key() const;
+
+    //! Compute hash of a port key.
+    static core::hashsum_t key_hash(const packet::Address& address);
+
+    //! Compare two port keys.
+    static bool key_equal(const packet::Address& address1,
+                          const packet::Address& address2);
+
+    //! Add destination.
+    //! @remarks
+    //!  Packets received on this port will be sent to @p dst_address using
+    //!  @p writer, which is typically a UDP sender port.
+    bool add_destination(const packet::Address& dst_address, packet::IWriter& writer);
+
+    //! Get number of destinations.
+    size_t num_destinations() const;
+
+    //! Try to handle packet on this port.
+    //! @returns
+    //!  true if the packet is dedicated for this port
+    bool handle(packet::Packet& packet);
+
+    //! Get writer of destination.
+    packet::IWriter& destination_writer(size_t dst_index) const;
+
+    //! Create packet to be forwarded to destination.
+    //! @remarks
+    //!  Creates a new packet addressed to destination @p dst_index, which
+    //!  shares the buffer of @p packet, so its data is never copied. The
+    //!  packet should be written to destination_writer().
+    //! @returns
+    //!  NULL if the packet can't be allocated.
+    packet::PacketPtr forward(const packet::Packet& packet,
+                              size_t dst_index,
+                              packet::PacketPool& packet_pool) const;
+
+private:
+    friend class core::RefCnt<RelayPort>;
+
+    void destroy();
+
+    struct Destination {
+        packet::Address address;
+        packet::IWriter* writer;
+
+        Destination()
+            : writer(NULL) {
+        }
+    };
+
+    core::IAllocator& allocator_;
+
+    core::SharedPtr<ReceiverPort> port_;
+
+    core::Array<Destination> destinations_;
+};
+
+} // namespace pipeline
+} // namespace roc
+
+#endif // ROC_PIPELINE_RELAY_PORT_H_
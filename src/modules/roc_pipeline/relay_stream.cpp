@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_pipeline/relay_stream.h"
+#include "roc_core/log.h"
+
+namespace roc {
+namespace pipeline {
+
+RelayStream::RelayStream(const RelayConfig& config,
+                         const packet::Address& src_address,
+                         core::IAllocator& allocator)
+    : allocator_(allocator)
+    , config_(config)
+    , src_address_(src_address)
+    , source_(0)
+    , seqnum_(0)
+    , has_seqnum_(false)
+    , seqnum_window_(0)
+    , last_time_(0) {
+}
+
+void RelayStream::destroy() {
+    allocator_.destroy(*this);
+}
+
+const packet::Address& RelayStream::key() const {
+    return src_address_;
+}
+
+core::hashsum_t RelayStream::key_hash(const packet::Address& src_address) {
+    return src_address.hash();
+}
+
+bool RelayStream::key_equal(const packet::Address& src_address1,
+                            const packet::Address& src_address2) {
+    return src_address1 == src_address2;
+}
+
+bool RelayStream::validate(const packet::Packet& packet, core::nanoseconds_t now) {
+    const packet::RTP* rtp = packet.rtp();
+
+    if (!rtp) {
+        // repair packets have no RTP header and are forwarded as is
+        last_time_ = now;
+        return true;
+    }
+
+    if (!has_seqnum_ || rtp->source != source_) {
+        roc_log(LogDebug, "relay stream: starting new stream: source=%lu seqnum=%lu",
+                (unsigned long)rtp->source, (unsigned long)rtp->seqnum);
+
+        source_ = rtp->source;
+        seqnum_ = rtp->seqnum;
+        has_seqnum_ = true;
+        seqnum_window_ = 1;
+
+        last_time_ = now;
+        return true;
+    }
+
+    const packet::seqnum_diff_t sn_dist = packet::seqnum_diff(rtp->seqnum, seqnum_);
+
+    if ((size_t)(sn_dist < 0 ? -sn_dist : sn_dist) > config_.rtp_validator.max_sn_jump) {
+        roc_log(LogDebug,
+                "relay stream: too long seqnum jump: prev=%lu next=%lu dist=%ld",
+                (unsigned long)seqnum_, (unsigned long)rtp->seqnum, (long)sn_dist);
+        return false;
+    }
+
+    if (sn_dist > 0) {
+        // move window forward, so that bit 0 corresponds to the new seqnum
+        if (sn_dist < WindowSize) {
+            seqnum_window_ = (seqnum_window_ << sn_dist) | 1;
+        } else {
+            seqnum_window_ = 1;
+        }
+        seqnum_ = rtp->seqnum;
+    } else if (-sn_dist < WindowSize) {
+        const uint64_t bit = uint64_t(1) << -sn_dist;
+
+        if (seqnum_window_ & bit) {
+            roc_log(LogDebug, "relay stream: dropping duplicate packet: seqnum=%lu",
+                    (unsigned long)rtp->seqnum);
+            return false;
+        }
+
+        seqnum_window_ |= bit;
+    }
+
+    last_time_ = now;
+    return true;
+}
+
+bool RelayStream::expired(core::nanoseconds_t now) const {
+    return now - last_time_ >= config_.stream_timeout;
+}
+
+} // namespace pipeline
+} // namespace roc
@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_pipeline/relay_stream.h
+//! @brief Relay stream state.
+
+#ifndef ROC_PIPELINE_RELAY_STREAM_H_
+#define ROC_PIPELINE_RELAY_STREAM_H_
+
+#include "roc_core/hashmap_node.h"
+#include "roc_core/hashsum.h"
+#include "roc_core/iallocator.h"
+#include "roc_core/list_node.h"
+#include "roc_core/refcnt.h"
+#include "roc_core/stddefs.h"
+#include "roc_core/time.h"
+#include "roc_packet/address.h"
+#include "roc_packet/packet.h"
+#include "roc_packet/units.h"
+#include "roc_pipeline/config.h"
+
+namespace roc {
+namespace pipeline {
+
+//! Relay stream state.
+//! @remarks
+//!  Created at the relay side for every sender. Keeps just enough state
+//!  to validate RTP packets of the sender without inspecting their payload.
+class RelayStream : public core::RefCnt<RelayStream>,
+                    public core::ListNode,
+                    public core::HashmapNode {
+public:
+    //! Initialize.
+    RelayStream(const RelayConfig& config,
+                const packet::Address& src_address,
+                core::IAllocator& allocator);
+
+    //! Get address of the sender of this stream.
+    //! @remarks
+    //!  Used as the key when the stream is indexed in a hashmap.
+    const packet::Address& key() const;
+
+    //! Compute hash of a stream key.
+    static core::hashsum_t key_hash(const packet::Address& src_address);
+
+    //! Compare two stream keys.
+    static bool key_equal(const packet::Address& src_address1,
+                          const packet::Address& src_address2);
+
+    //! Check if the packet should be forwarded.
+    //! @remarks
+    //!  A packet with a new SSRC starts a new stream. Within a stream, a packet
+    //!  with too long seqnum jump is rejected, and so is a packet with a seqnum
+    //!  that was already seen among the last WindowSize seqnums. Older packets
+    //!  can't be checked and are accepted. Repair packets are always accepted.
+    bool validate(const packet::Packet& packet, core::nanoseconds_t now);
+
+    //! Check if the stream didn't receive packets for too long.
+    bool expired(core::nanoseconds_t now) const;
+
+    //! Number of latest seqnums checked for duplicates.
+    enum { WindowSize = 64 };
+
+private:
+    friend class core::RefCnt<RelayStream>;
+
+    void destroy();
+
+    core::IAllocator& allocator_;
+
+    const RelayConfig& config_;
+
+    const packet::Address src_address_;
+
+    packet::source_t source_;
+    packet::seqnum_t seqnum_;
+    bool has_seqnum_;
+
+    // bit N is set if seqnum (seqnum_ - N) was seen
+    uint64_t seqnum_window_;
+
+    core::nanoseconds_t last_time_;
+};
+
+} // namespace pipeline
+} // namespace roc
+
+#endif // ROC_PIPELINE_RELAY_STREAM_H_
@@ -39,8 +39,8 @@ SenderPort::SenderPort(const PortConfig& config,
     case Proto_RTP_LDPC_Source:
         fec_composer_.reset(
             new (allocator)
-                fec::Composer<fec::LDPC_Source_PayloadID, fec::Source, fec::Footer>(
-                    composer),
+                fec::Composer<fec::LDPC_Source_PayloadID, fec::Source, fec::Footer,
+                              rtp::Composer>(rtp_composer_.get()),
             allocator);
         if (!fec_composer_) {
             return;
@@ -61,7 +61,8 @@ SenderPort::SenderPort(const PortConfig& config,
     case Proto_RTP_RSm8_Source:
         fec_composer_.reset(
             new (allocator)
-                fec::Composer<fec::RSm8_PayloadID, fec::Source, fec::Footer>(composer),
+                fec::Composer<fec::RSm8_PayloadID, fec::Source, fec::Footer,
+                              rtp::Composer>(rtp_composer_.get()),
             allocator);
         if (!fec_composer_) {
             return;
@@ -47,9 +47,9 @@ bool Composer::align(core::Slice<uint8_t>& buffer,
 }
 
 bool Composer::prepare(packet::Packet& packet,
-                       core::Slice<uint8_t>& buffer,
+                       core::SliceView<uint8_t>& buffer,
                        size_t payload_size) {
-    core::Slice<uint8_t> header = buffer.range(0, 0);
+    core::SliceView<uint8_t> header = buffer.range(0, 0);
 
     if (header.capacity() < sizeof(Header)) {
         roc_log(LogDebug,
@@ -59,7 +59,7 @@ bool Composer::prepare(packet::Packet& packet,
     }
     header.resize(sizeof(Header));
 
-    core::Slice<uint8_t> payload = header.range(header.size(), header.size());
+    core::SliceView<uint8_t> payload = header.range(header.size(), header.size());
 
     if (inner_composer_ == NULL) {
         if (payload.capacity() < payload_size) {
@@ -31,8 +31,9 @@ public:
     align(core::Slice<uint8_t>& buffer, size_t header_size, size_t payload_alignment);
 
     //! Prepare buffer for composing a packet.
-    virtual bool
-    prepare(packet::Packet& packet, core::Slice<uint8_t>& buffer, size_t payload_size);
+    virtual bool prepare(packet::Packet& packet,
+                         core::SliceView<uint8_t>& buffer,
+                         size_t payload_size);
 
     //! Pad packet.
     virtual bool pad(packet::Packet& packet, size_t padding_size);
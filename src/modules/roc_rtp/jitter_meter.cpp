@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_rtp/jitter_meter.h"
+#include "roc_core/log.h"
+
+namespace roc {
+namespace rtp {
+
+namespace {
+
+const core::nanoseconds_t LogInterval = 5 * core::Second;
+
+} // namespace
+
+JitterMeter::JitterMeter(packet::IWriter& writer, size_t sample_rate)
+    : writer_(writer)
+    , sample_rate_(sample_rate)
+    , has_prev_(false)
+    , prev_source_(0)
+    , prev_timestamp_(0)
+    , prev_arrival_(0)
+    , jitter_(0)
+    , rate_limiter_(LogInterval) {
+}
+
+void JitterMeter::write(const packet::PacketPtr& packet) {
+    update_(*packet);
+
+    writer_.write(packet);
+}
+
+void JitterMeter::write_many(const packet::PacketPtr* packets, size_t n_packets) {
+    for (size_t n = 0; n < n_packets; n++) {
+        update_(*packets[n]);
+    }
+
+    writer_.write_many(packets, n_packets);
+}
+
+core::nanoseconds_t JitterMeter::jitter() const {
+    return jitter_;
+}
+
+void JitterMeter::reset() {
+    has_prev_ = false;
+    prev_source_ = 0;
+    prev_timestamp_ = 0;
+    prev_arrival_ = 0;
+    jitter_ = 0;
+}
+
+void JitterMeter::update_(const packet::Packet& packet) {
+    const packet::RTP* rtp = packet.rtp();
+    const packet::UDP* udp = packet.udp();
+
+    if (!rtp || !udp || udp->receive_timestamp == 0) {
+        return;
+    }
+
+    if (has_prev_ && rtp->source == prev_source_) {
+        // difference between the arrival interval and the sending interval
+        // of two consecutive packets, see RFC 3550 section 6.4.1 and A.8
+        core::nanoseconds_t d = (udp->receive_timestamp - prev_arrival_)
+            - packet::timestamp_to_ns(
+                packet::timestamp_diff(rtp->timestamp, prev_timestamp_), sample_rate_);
+        if (d < 0) {
+            d = -d;
+        }
+
+        jitter_ += (d - jitter_) / 16;
+
+        if (rate_limiter_.allow()) {
+            roc_log(LogDebug, "rtp jitter meter: jitter=%.3fms",
+                    double(jitter_) / core::Millisecond);
+        }
+    }
+
+    has_prev_ = true;
+    prev_source_ = rtp->source;
+    prev_timestamp_ = rtp->timestamp;
+    prev_arrival_ = udp->receive_timestamp;
+}
+
+} // namespace rtp
+} // namespace roc
@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_rtp/jitter_meter.h
+//! @brief RTP interarrival jitter meter.
+
+#ifndef ROC_RTP_JITTER_METER_H_
+#define ROC_RTP_JITTER_METER_H_
+
+#include "roc_core/noncopyable.h"
+#include "roc_core/rate_limiter.h"
+#include "roc_core/time.h"
+#include "roc_packet/iwriter.h"
+#include "roc_packet/units.h"
+
+namespace roc {
+namespace rtp {
+
+//! RTP interarrival jitter meter.
+//! @remarks
+//!  Estimates interarrival jitter as defined in RFC 3550 from the kernel
+//!  arrival timestamps of UDP packets and the timestamps of RTP packets,
+//!  and passes packets to the underlying writer unchanged.
+//!
+//!  Packets without arrival timestamp are not taken into account. Arrival
+//!  timestamps are taken by the kernel, so the estimation isn't affected
+//!  by the scheduling delays of the receiver.
+class JitterMeter : public packet::IWriter, public core::NonCopyable<> {
+public:
+    //! Initialize.
+    //!
+    //! @b Parameters
+    //!  - @p writer is output packet writer
+    //!  - @p sample_rate defines session sample rate
+    JitterMeter(packet::IWriter& writer, size_t sample_rate);
+
+    //! Write packet.
+    //! @remarks
+    //!  Updates jitter estimation and passes packet to the underlying writer.
+    virtual void write(const packet::PacketPtr& packet);
+
+    //! Write multiple packets.
+    //! @remarks
+    //!  Updates jitter estimation and passes the whole batch to the underlying
+    //!  writer using a single write_many() call.
+    virtual void write_many(const packet::PacketPtr* packets, size_t n_packets);
+
+    //! Get current jitter estimation, in nanoseconds.
+    //! @remarks
+    //!  Returns zero until at least two timestamped packets are written.
+    core::nanoseconds_t jitter() const;
+
+    //! Reset to initial state.
+    //! @remarks
+    //!  Forgets the previous packet and the jitter estimation.
+    void reset();
+
+private:
+    void update_(const packet::Packet& packet);
+
+    packet::IWriter& writer_;
+
+    const size_t sample_rate_;
+
+    bool has_prev_;
+    packet::source_t prev_source_;
+    packet::timestamp_t prev_timestamp_;
+    core::nanoseconds_t prev_arrival_;
+
+    core::nanoseconds_t jitter_;
+
+    core::RateLimiter rate_limiter_;
+};
+
+} // namespace rtp
+} // namespace roc
+
+#endif // ROC_RTP_JITTER_METER_H_
@@ -18,7 +18,7 @@ Parser::Parser(const FormatMap& format_map, packet::IParser* inner_parser)
     , inner_parser_(inner_parser) {
 }
 
-bool Parser::parse(packet::Packet& packet, const core::Slice<uint8_t>& buffer) {
+bool Parser::parse(packet::Packet& packet, const core::SliceView<uint8_t>& buffer) {
     if (buffer.size() < sizeof(Header)) {
         roc_log(LogDebug, "rtp parser: bad packet, size < %d (rtp header)",
                 (int)sizeof(Header));
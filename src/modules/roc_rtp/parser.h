@@ -32,7 +32,7 @@ public:
     Parser(const FormatMap& format_map, packet::IParser* inner_parser);
 
     //! Parse packet from buffer.
-    virtual bool parse(packet::Packet& packet, const core::Slice<uint8_t>& buffer);
+    virtual bool parse(packet::Packet& packet, const core::SliceView<uint8_t>& buffer);
 
 private:
     const FormatMap& format_map_;
@@ -26,10 +26,39 @@ packet::PacketPtr Validator::read() {
         return NULL;
     }
 
+    if (!validate_(next_packet)) {
+        return NULL;
+    }
+
+    return next_packet;
+}
+
+size_t Validator::read_many(packet::PacketPtr* packets, size_t max_packets) {
+    const size_t n_read = reader_.read_many(packets, max_packets);
+
+    size_t n_valid = 0;
+
+    for (size_t n = 0; n < n_read; n++) {
+        if (validate_(packets[n])) {
+            if (n_valid != n) {
+                packets[n_valid] = packets[n];
+            }
+            n_valid++;
+        }
+    }
+
+    for (size_t n = n_valid; n < n_read; n++) {
+        packets[n] = NULL;
+    }
+
+    return n_valid;
+}
+
+bool Validator::validate_(const packet::PacketPtr& next_packet) {
     const packet::RTP* next_rtp = next_packet->rtp();
     if (!next_rtp) {
         roc_log(LogDebug, "rtp validator: unexpected non-RTP packet");
-        return NULL;
+        return false;
     }
 
     const packet::RTP* prev_rtp = NULL;
@@ -38,14 +67,18 @@ packet::PacketPtr Validator::read() {
     }
 
     if (prev_rtp && !check_(*prev_rtp, *next_rtp)) {
-        return NULL;
+        return false;
     }
 
     if (!prev_rtp || prev_rtp->compare(*next_rtp) < 0) {
         prev_packet_ = next_packet;
     }
 
-    return next_packet;
+    return true;
+}
+
+void Validator::reset() {
+    prev_packet_ = NULL;
 }
 
 bool Validator::check_(const packet::RTP& prev, const packet::RTP& next) const {
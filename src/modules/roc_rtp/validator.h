@@ -50,7 +50,20 @@ public:
     //!  is valid, return it. Otherwise, returns NULL.
     virtual packet::PacketPtr read();
 
+    //! Read multiple packets.
+    //! @remarks
+    //!  Reads a batch of packets from the underlying reader and keeps only
+    //!  valid ones. Like read(), may return zero even if the underlying reader
+    //!  has more packets, when all packets in the batch are invalid.
+    virtual size_t read_many(packet::PacketPtr* packets, size_t max_packets);
+
+    //! Reset to initial state.
+    //! @remarks
+    //!  Forgets the previous packet.
+    void reset();
+
 private:
+    bool validate_(const packet::PacketPtr& next_packet);
     bool check_(const packet::RTP& prev, const packet::RTP& next) const;
 
     packet::IReader& reader_;
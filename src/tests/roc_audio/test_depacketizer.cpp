@@ -509,5 +509,38 @@ TEST(depacketizer, timestamp) {
     }
 }
 
+TEST(depacketizer, reset) {
+    enum { FirstTimestamp = 1000, SecondTimestamp = 500000 };
+
+    audio::PCMEncoder encoder(pcm_funcs);
+    audio::PCMDecoder decoder(pcm_funcs);
+
+    packet::Queue queue;
+    Depacketizer dp(queue, decoder, ChMask, false);
+
+    queue.write(new_packet(encoder, FirstTimestamp, 0.1f));
+    queue.write(new_packet(encoder, FirstTimestamp + SamplesPerPacket, 0.1f));
+
+    expect_output(dp, SamplesPerPacket / 2, 0.1f);
+
+    CHECK(dp.started());
+    UNSIGNED_LONGS_EQUAL(FirstTimestamp + SamplesPerPacket / 2, dp.timestamp());
+
+    dp.reset();
+
+    CHECK(!dp.started());
+    UNSIGNED_LONGS_EQUAL(0, dp.timestamp());
+
+    while (queue.read()) {
+    }
+
+    queue.write(new_packet(encoder, SecondTimestamp, 0.2f));
+
+    expect_output(dp, SamplesPerPacket, 0.2f);
+
+    CHECK(dp.started());
+    UNSIGNED_LONGS_EQUAL(SecondTimestamp + SamplesPerPacket, dp.timestamp());
+}
+
 } // namespace audio
 } // namespace roc
@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/alignment.h"
+#include "roc_core/arena_allocator.h"
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace core {
+
+namespace {
+
+enum { RegionSize = 64 * 1024, NumBlocks = 100, BlockSize = 100 };
+
+} // namespace
+
+TEST_GROUP(arena_allocator) {};
+
+TEST(arena_allocator, allocate_deallocate) {
+    ArenaAllocator allocator(RegionSize, false);
+
+    LONGS_EQUAL(0, allocator.num_allocations());
+    LONGS_EQUAL(0, allocator.num_regions());
+
+    void* blocks[NumBlocks];
+
+    for (size_t n = 0; n < NumBlocks; n++) {
+        blocks[n] = allocator.allocate(BlockSize);
+        CHECK(blocks[n]);
+
+        LONGS_EQUAL(0, (size_t)blocks[n] % sizeof(MaxAlign));
+        memset(blocks[n], (int)n, BlockSize);
+
+        LONGS_EQUAL(n + 1, allocator.num_allocations());
+    }
+
+    LONGS_EQUAL(1, allocator.num_regions());
+
+    for (size_t n = 0; n < NumBlocks; n++) {
+        for (size_t i = 0; i < BlockSize; i++) {
+            LONGS_EQUAL(n, ((unsigned char*)blocks[n])[i]);
+        }
+        allocator.deallocate(blocks[n]);
+    }
+
+    LONGS_EQUAL(0, allocator.num_allocations());
+    LONGS_EQUAL(1, allocator.num_regions());
+}
+
+TEST(arena_allocator, rewind_current_region) {
+    ArenaAllocator allocator(RegionSize, false);
+
+    void* first = allocator.allocate(BlockSize);
+    CHECK(first);
+
+    allocator.deallocate(first);
+
+    void* second = allocator.allocate(BlockSize);
+    POINTERS_EQUAL(first, second);
+
+    allocator.deallocate(second);
+}
+
+TEST(arena_allocator, release_region) {
+    ArenaAllocator allocator(RegionSize, false);
+
+    void* first = allocator.allocate(RegionSize / 2);
+    CHECK(first);
+
+    void* second = allocator.allocate(RegionSize / 2);
+    CHECK(second);
+
+    LONGS_EQUAL(2, allocator.num_regions());
+
+    allocator.deallocate(first);
+
+    LONGS_EQUAL(1, allocator.num_regions());
+
+    allocator.deallocate(second);
+
+    LONGS_EQUAL(1, allocator.num_regions());
+}
+
+TEST(arena_allocator, dedicated_region) {
+    ArenaAllocator allocator(RegionSize, false);
+
+    void* small = allocator.allocate(BlockSize);
+    CHECK(small);
+
+    void* large = allocator.allocate(RegionSize * 2);
+    CHECK(large);
+    memset(large, 0, RegionSize * 2);
+
+    LONGS_EQUAL(2, allocator.num_regions());
+
+    void* next = allocator.allocate(BlockSize);
+    CHECK(next);
+
+    LONGS_EQUAL(2, allocator.num_regions());
+
+    allocator.deallocate(large);
+
+    LONGS_EQUAL(1, allocator.num_regions());
+
+    allocator.deallocate(small);
+    allocator.deallocate(next);
+
+    LONGS_EQUAL(0, allocator.num_allocations());
+}
+
+TEST(arena_allocator, huge_pages) {
+    ArenaAllocator allocator(RegionSize, true);
+
+    void* blocks[NumBlocks];
+
+    for (size_t n = 0; n < NumBlocks; n++) {
+        blocks[n] = allocator.allocate(BlockSize);
+        CHECK(blocks[n]);
+        memset(blocks[n], (int)n, BlockSize);
+    }
+
+    LONGS_EQUAL(1, allocator.num_regions());
+
+    for (size_t n = 0; n < NumBlocks; n++) {
+        allocator.deallocate(blocks[n]);
+    }
+
+    LONGS_EQUAL(0, allocator.num_allocations());
+}
+
+} // namespace core
+} // namespace roc
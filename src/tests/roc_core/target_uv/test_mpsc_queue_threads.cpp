@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/mpsc_queue.h"
+#include "roc_core/thread.h"
+
+namespace roc {
+namespace core {
+
+namespace {
+
+enum { NumThreads = 4, NumObjects = 20000 };
+
+struct Object : MpscQueueNode {
+    size_t thread;
+    size_t seqnum;
+};
+
+typedef MpscQueue<Object, NoOwnership> TestQueue;
+
+class Producer : public Thread {
+public:
+    Producer()
+        : queue_(NULL)
+        , id_(0) {
+    }
+
+    ~Producer() {
+    }
+
+    void init(TestQueue& queue, size_t id) {
+        queue_ = &queue;
+        id_ = id;
+    }
+
+private:
+    virtual void run() {
+        for (size_t n = 0; n < NumObjects; n++) {
+            objects_[n].thread = id_;
+            objects_[n].seqnum = n;
+            queue_->push_back(objects_[n]);
+        }
+    }
+
+    TestQueue* queue_;
+    size_t id_;
+
+    Object objects_[NumObjects];
+};
+
+} // namespace
+
+TEST_GROUP(mpsc_queue_threads) {};
+
+TEST(mpsc_queue_threads, many_producers) {
+    TestQueue queue;
+
+    Producer producers[NumThreads];
+
+    for (size_t t = 0; t < NumThreads; t++) {
+        producers[t].init(queue, t);
+    }
+
+    for (size_t t = 0; t < NumThreads; t++) {
+        CHECK(producers[t].start());
+    }
+
+    size_t next_seqnum[NumThreads] = {};
+    size_t num_popped = 0;
+
+    while (num_popped < NumThreads * NumObjects) {
+        Object* obj = queue.pop_front();
+        if (!obj) {
+            continue;
+        }
+
+        CHECK(obj->thread < NumThreads);
+        LONGS_EQUAL(next_seqnum[obj->thread], obj->seqnum);
+
+        next_seqnum[obj->thread]++;
+        num_popped++;
+    }
+
+    for (size_t t = 0; t < NumThreads; t++) {
+        producers[t].join();
+    }
+
+    CHECK(queue.empty());
+    CHECK(!queue.pop_front());
+}
+
+} // namespace core
+} // namespace roc
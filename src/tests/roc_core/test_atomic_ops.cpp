@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/atomic_ops.h"
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace core {
+
+TEST_GROUP(atomic_ops) {};
+
+TEST(atomic_ops, load_store) {
+    long v = 0;
+
+    AtomicOps::store_relaxed(v, 1);
+    LONGS_EQUAL(1, AtomicOps::load_relaxed(v));
+
+    AtomicOps::store_release(v, 2);
+    LONGS_EQUAL(2, AtomicOps::load_acquire(v));
+
+    AtomicOps::store_seq_cst(v, 3);
+    LONGS_EQUAL(3, AtomicOps::load_seq_cst(v));
+}
+
+TEST(atomic_ops, fetch_add_sub) {
+    long v = 0;
+
+    LONGS_EQUAL(0, AtomicOps::fetch_add_relaxed(v, 1));
+    LONGS_EQUAL(1, AtomicOps::fetch_add_acq_rel(v, 2));
+    LONGS_EQUAL(3, AtomicOps::fetch_add_seq_cst(v, 3));
+    LONGS_EQUAL(6, v);
+
+    LONGS_EQUAL(6, AtomicOps::fetch_sub_relaxed(v, 1));
+    LONGS_EQUAL(5, AtomicOps::fetch_sub_release(v, 2));
+    LONGS_EQUAL(3, AtomicOps::fetch_sub_acq_rel(v, 1));
+    LONGS_EQUAL(2, AtomicOps::fetch_sub_seq_cst(v, 2));
+    LONGS_EQUAL(0, v);
+}
+
+TEST(atomic_ops, exchange) {
+    long v = 1;
+
+    LONGS_EQUAL(1, AtomicOps::exchange_acq_rel(v, 2));
+    LONGS_EQUAL(2, v);
+}
+
+TEST(atomic_ops, compare_exchange) {
+    long v = 1;
+    long exp = 2;
+
+    CHECK(!AtomicOps::compare_exchange_acq_rel(v, exp, 3));
+    LONGS_EQUAL(1, v);
+    LONGS_EQUAL(1, exp);
+
+    CHECK(AtomicOps::compare_exchange_acq_rel(v, exp, 3));
+    LONGS_EQUAL(3, v);
+    LONGS_EQUAL(1, exp);
+}
+
+TEST(atomic_ops, pointers) {
+    int a = 0;
+    int b = 0;
+
+    int* p = NULL;
+
+    AtomicOps::store_release(p, &a);
+    POINTERS_EQUAL(&a, AtomicOps::load_acquire(p));
+
+    int* exp = &a;
+    CHECK(AtomicOps::compare_exchange_acq_rel(p, exp, &b));
+    POINTERS_EQUAL(&b, AtomicOps::load_relaxed(p));
+}
+
+} // namespace core
+} // namespace roc
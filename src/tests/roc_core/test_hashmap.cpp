@@ -0,0 +1,234 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/hashmap.h"
+#include "roc_core/hashsum.h"
+#include "roc_core/heap_allocator.h"
+#include "roc_core/list.h"
+#include "roc_core/refcnt.h"
+#include "roc_core/shared_ptr.h"
+
+namespace roc {
+namespace core {
+
+namespace {
+
+enum { NumObjects = 100 };
+
+struct Object : RefCnt<Object>, ListNode, HashmapNode {
+    size_t id;
+
+    Object()
+        : id(0) {
+    }
+
+    size_t key() const {
+        return id;
+    }
+
+    static hashsum_t key_hash(size_t id) {
+        return hashsum_mem(&id, sizeof(id));
+    }
+
+    static bool key_equal(size_t id1, size_t id2) {
+        return id1 == id2;
+    }
+
+    void destroy() {
+    }
+};
+
+// all keys collide
+struct CollidingObject : HashmapNode {
+    size_t id;
+
+    size_t key() const {
+        return id;
+    }
+
+    static hashsum_t key_hash(size_t) {
+        return 0;
+    }
+
+    static bool key_equal(size_t id1, size_t id2) {
+        return id1 == id2;
+    }
+};
+
+typedef Hashmap<Object, NoOwnership> TestHashmap;
+typedef Hashmap<Object, RefCntOwnership> TestRefCntHashmap;
+
+HeapAllocator allocator;
+
+} // namespace
+
+TEST_GROUP(hashmap) {};
+
+TEST(hashmap, empty) {
+    TestHashmap hashmap(allocator);
+
+    LONGS_EQUAL(0, hashmap.size());
+    CHECK(!hashmap.find((size_t)1));
+}
+
+TEST(hashmap, insert_find_remove) {
+    Object obj;
+    obj.id = 42;
+
+    TestHashmap hashmap(allocator);
+
+    CHECK(!hashmap.contains(obj));
+
+    CHECK(hashmap.insert(obj));
+
+    LONGS_EQUAL(1, hashmap.size());
+    CHECK(hashmap.contains(obj));
+
+    POINTERS_EQUAL(&obj, hashmap.find((size_t)42));
+    POINTERS_EQUAL(&obj, hashmap.find_borrowed((size_t)42));
+    CHECK(!hashmap.find((size_t)43));
+
+    hashmap.remove(obj);
+
+    LONGS_EQUAL(0, hashmap.size());
+    CHECK(!hashmap.contains(obj));
+    CHECK(!hashmap.find((size_t)42));
+}
+
+TEST(hashmap, many_objects) {
+    Object objects[NumObjects];
+
+    TestHashmap hashmap(allocator);
+
+    for (size_t n = 0; n < NumObjects; n++) {
+        objects[n].id = n * 1000;
+        CHECK(hashmap.insert(objects[n]));
+        LONGS_EQUAL(n + 1, hashmap.size());
+    }
+
+    for (size_t n = 0; n < NumObjects; n++) {
+        POINTERS_EQUAL(&objects[n], hashmap.find(n * 1000));
+        CHECK(!hashmap.find(n * 1000 + 1));
+    }
+
+    for (size_t n = 0; n < NumObjects; n += 2) {
+        hashmap.remove(objects[n]);
+    }
+
+    LONGS_EQUAL(NumObjects / 2, hashmap.size());
+
+    for (size_t n = 0; n < NumObjects; n++) {
+        if (n % 2 == 0) {
+            CHECK(!hashmap.find(n * 1000));
+            CHECK(!hashmap.contains(objects[n]));
+        } else {
+            POINTERS_EQUAL(&objects[n], hashmap.find(n * 1000));
+        }
+    }
+
+    for (size_t n = 1; n < NumObjects; n += 2) {
+        hashmap.remove(objects[n]);
+    }
+
+    LONGS_EQUAL(0, hashmap.size());
+}
+
+TEST(hashmap, collisions) {
+    CollidingObject objects[NumObjects];
+
+    Hashmap<CollidingObject, NoOwnership> hashmap(allocator);
+
+    for (size_t n = 0; n < NumObjects; n++) {
+        objects[n].id = n;
+        CHECK(hashmap.insert(objects[n]));
+    }
+
+    for (size_t n = 0; n < NumObjects; n++) {
+        POINTERS_EQUAL(&objects[n], hashmap.find(n));
+    }
+
+    hashmap.remove(objects[NumObjects / 2]);
+    hashmap.remove(objects[0]);
+    hashmap.remove(objects[NumObjects - 1]);
+
+    LONGS_EQUAL(NumObjects - 3, hashmap.size());
+
+    CHECK(!hashmap.find((size_t)NumObjects / 2));
+    CHECK(!hashmap.find((size_t)0));
+    CHECK(!hashmap.find((size_t)NumObjects - 1));
+
+    for (size_t n = 1; n < NumObjects - 1; n++) {
+        if (n != NumObjects / 2) {
+            POINTERS_EQUAL(&objects[n], hashmap.find(n));
+            hashmap.remove(objects[n]);
+        }
+    }
+
+    LONGS_EQUAL(0, hashmap.size());
+}
+
+TEST(hashmap, list_and_hashmap) {
+    Object obj;
+    obj.id = 1;
+
+    List<Object, NoOwnership> list;
+    TestHashmap hashmap(allocator);
+
+    list.push_back(obj);
+    CHECK(hashmap.insert(obj));
+
+    POINTERS_EQUAL(&obj, list.front());
+    POINTERS_EQUAL(&obj, hashmap.find((size_t)1));
+
+    list.remove(obj);
+    POINTERS_EQUAL(&obj, hashmap.find((size_t)1));
+
+    hashmap.remove(obj);
+}
+
+TEST(hashmap, refcnt_ownership) {
+    Object obj;
+    obj.id = 1;
+
+    LONGS_EQUAL(0, obj.getref());
+
+    {
+        TestRefCntHashmap hashmap(allocator);
+
+        CHECK(hashmap.insert(obj));
+        LONGS_EQUAL(1, obj.getref());
+
+        {
+            SharedPtr<Object> ptr = hashmap.find((size_t)1);
+            CHECK(ptr);
+            LONGS_EQUAL(2, obj.getref());
+        }
+
+        LONGS_EQUAL(1, obj.getref());
+    }
+
+    LONGS_EQUAL(0, obj.getref());
+}
+
+TEST(hashmap, hashsum) {
+    const char a[] = "foobar";
+    const char b[] = "foobaz";
+
+    CHECK(hashsum_mem(a, sizeof(a)) == hashsum_mem(a, sizeof(a)));
+    CHECK(hashsum_mem(a, sizeof(a)) != hashsum_mem(b, sizeof(b)));
+
+    hashsum_t hash = hashsum_mem(a, 3);
+    hashsum_add(hash, a + 3, sizeof(a) - 3);
+
+    CHECK(hash == hashsum_mem(a, sizeof(a)));
+}
+
+} // namespace core
+} // namespace roc
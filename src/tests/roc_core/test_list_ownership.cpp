@@ -107,5 +107,37 @@ TEST(list_ownership, pointers) {
     LONGS_EQUAL(2, list.back()->getref());
 }
 
+TEST(list_ownership, borrowed_pointers) {
+    Object obj1;
+    Object obj2;
+
+    TestList list;
+
+    list.push_back(obj1);
+    list.push_back(obj2);
+
+    POINTERS_EQUAL(&obj1, list.front_borrowed());
+    POINTERS_EQUAL(&obj2, list.back_borrowed());
+    POINTERS_EQUAL(&obj2, list.nextof_borrowed(obj1));
+    POINTERS_EQUAL(NULL, list.nextof_borrowed(obj2));
+
+    LONGS_EQUAL(1, obj1.getref());
+    LONGS_EQUAL(1, obj2.getref());
+
+    size_t n = 0;
+    for (Object* obj = list.front_borrowed(); obj; obj = list.nextof_borrowed(*obj)) {
+        LONGS_EQUAL(1, obj->getref());
+        n++;
+    }
+    LONGS_EQUAL(2, n);
+}
+
+TEST(list_ownership, borrowed_empty) {
+    TestList list;
+
+    POINTERS_EQUAL(NULL, list.front_borrowed());
+    POINTERS_EQUAL(NULL, list.back_borrowed());
+}
+
 } // namespace core
 } // namespace roc
@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/list.h"
+#include "roc_core/mpsc_queue.h"
+#include "roc_core/refcnt.h"
+#include "roc_core/shared_ptr.h"
+
+namespace roc {
+namespace core {
+
+namespace {
+
+enum { NumObjects = 10 };
+
+struct Object : RefCnt<Object>, ListNode, MpscQueueNode {
+    void destroy() {
+    }
+};
+
+typedef MpscQueue<Object, NoOwnership> TestQueue;
+typedef MpscQueue<Object, RefCntOwnership> TestRefCntQueue;
+
+} // namespace
+
+TEST_GROUP(mpsc_queue) {};
+
+TEST(mpsc_queue, empty) {
+    TestQueue queue;
+
+    CHECK(queue.empty());
+    CHECK(!queue.pop_front());
+    CHECK(queue.empty());
+}
+
+TEST(mpsc_queue, push_pop_one) {
+    Object obj;
+
+    TestQueue queue;
+
+    queue.push_back(obj);
+    CHECK(!queue.empty());
+
+    POINTERS_EQUAL(&obj, queue.pop_front());
+    CHECK(queue.empty());
+
+    CHECK(!queue.pop_front());
+}
+
+TEST(mpsc_queue, push_pop_many) {
+    Object objects[NumObjects];
+
+    TestQueue queue;
+
+    for (size_t n = 0; n < NumObjects; n++) {
+        queue.push_back(objects[n]);
+    }
+
+    for (size_t n = 0; n < NumObjects; n++) {
+        CHECK(!queue.empty());
+        POINTERS_EQUAL(&objects[n], queue.pop_front());
+    }
+
+    CHECK(queue.empty());
+    CHECK(!queue.pop_front());
+}
+
+TEST(mpsc_queue, interleaved) {
+    Object objects[NumObjects];
+
+    TestQueue queue;
+
+    for (size_t n = 0; n < NumObjects; n++) {
+        queue.push_back(objects[n]);
+        queue.push_back(objects[(n + 1) % NumObjects]);
+
+        POINTERS_EQUAL(&objects[n], queue.pop_front());
+        POINTERS_EQUAL(&objects[(n + 1) % NumObjects], queue.pop_front());
+
+        CHECK(queue.empty());
+    }
+}
+
+TEST(mpsc_queue, reuse_element) {
+    Object obj;
+
+    TestQueue queue1;
+    TestQueue queue2;
+
+    queue1.push_back(obj);
+    POINTERS_EQUAL(&obj, queue1.pop_front());
+
+    queue2.push_back(obj);
+    POINTERS_EQUAL(&obj, queue2.pop_front());
+
+    queue1.push_back(obj);
+    POINTERS_EQUAL(&obj, queue1.pop_front());
+}
+
+TEST(mpsc_queue, list_and_queue) {
+    Object obj;
+
+    List<Object, NoOwnership> list;
+    TestQueue queue;
+
+    list.push_back(obj);
+    queue.push_back(obj);
+
+    POINTERS_EQUAL(&obj, queue.pop_front());
+    POINTERS_EQUAL(&obj, list.front());
+
+    list.remove(obj);
+}
+
+TEST(mpsc_queue, ownership) {
+    Object obj1;
+    Object obj2;
+
+    {
+        TestRefCntQueue queue;
+
+        queue.push_back(obj1);
+        queue.push_back(obj2);
+
+        LONGS_EQUAL(1, obj1.getref());
+        LONGS_EQUAL(1, obj2.getref());
+
+        {
+            SharedPtr<Object> ptr = queue.pop_front();
+            CHECK(ptr.get() == &obj1);
+
+            LONGS_EQUAL(1, obj1.getref());
+        }
+
+        LONGS_EQUAL(0, obj1.getref());
+        LONGS_EQUAL(1, obj2.getref());
+    }
+
+    LONGS_EQUAL(0, obj2.getref());
+}
+
+} // namespace core
+} // namespace roc
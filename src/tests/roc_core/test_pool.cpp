@@ -8,6 +8,7 @@
 
 #include <CppUTest/TestHarness.h>
 
+#include "roc_core/alignment.h"
 #include "roc_core/heap_allocator.h"
 #include "roc_core/noncopyable.h"
 #include "roc_core/pool.h"
@@ -112,5 +113,129 @@ TEST(pool, new_destroy_many) {
     LONGS_EQUAL(0, allocator.num_allocations());
 }
 
+TEST(pool, trim) {
+    {
+        Pool<Object> pool(allocator, sizeof(Object), true);
+
+        Object* objects[1 + 2 + 4] = {};
+
+        for (size_t n = 0; n < 1 + 2 + 4; n++) {
+            objects[n] = new (pool) Object;
+            CHECK(objects[n]);
+        }
+
+        LONGS_EQUAL(3, allocator.num_allocations());
+
+        LONGS_EQUAL(0, pool.trim());
+        LONGS_EQUAL(3, allocator.num_allocations());
+
+        // free second chunk
+        pool.destroy(*objects[1]);
+        pool.destroy(*objects[2]);
+
+        // partially free third chunk
+        pool.destroy(*objects[3]);
+
+        // objects were not free during the whole interval
+        LONGS_EQUAL(0, pool.trim());
+        LONGS_EQUAL(3, allocator.num_allocations());
+
+        LONGS_EQUAL(2, pool.trim());
+        LONGS_EQUAL(2, allocator.num_allocations());
+
+        // free first and third chunks
+        pool.destroy(*objects[0]);
+        for (size_t n = 4; n < 1 + 2 + 4; n++) {
+            pool.destroy(*objects[n]);
+        }
+
+        // only first chunk was free during the whole interval
+        LONGS_EQUAL(1, pool.trim());
+        LONGS_EQUAL(1, allocator.num_allocations());
+
+        // last chunk is kept
+        LONGS_EQUAL(0, pool.trim());
+        LONGS_EQUAL(1, allocator.num_allocations());
+        LONGS_EQUAL(0, Object::n_objects);
+
+        // pool is still usable after trimming
+        Object* object = new (pool) Object;
+        CHECK(object);
+
+        LONGS_EQUAL(1, allocator.num_allocations());
+
+        pool.destroy(*object);
+    }
+
+    LONGS_EQUAL(0, allocator.num_allocations());
+}
+
+TEST(pool, trim_hysteresis) {
+    {
+        Pool<Object> pool(allocator, sizeof(Object), true);
+
+        Object* objects[1 + 2 + 4] = {};
+
+        for (size_t iter = 0; iter < 5; iter++) {
+            for (size_t n = 0; n < 1 + 2 + 4; n++) {
+                objects[n] = new (pool) Object;
+                CHECK(objects[n]);
+            }
+
+            for (size_t n = 0; n < 1 + 2 + 4; n++) {
+                pool.destroy(*objects[n]);
+            }
+
+            // pool was drained during every interval
+            LONGS_EQUAL(0, pool.trim());
+            LONGS_EQUAL(3, allocator.num_allocations());
+        }
+
+        // pool stays idle during the whole interval
+        LONGS_EQUAL(1 + 2, pool.trim());
+        LONGS_EQUAL(1, allocator.num_allocations());
+    }
+
+    LONGS_EQUAL(0, allocator.num_allocations());
+}
+
+TEST(pool, cache_line_alignment) {
+    {
+        Pool<Object> pool(allocator, sizeof(Object), true, CacheLineSize);
+
+        Object* objects[1 + 2 + 4] = {};
+
+        for (size_t n = 0; n < 1 + 2 + 4; n++) {
+            objects[n] = new (pool) Object;
+            CHECK(objects[n]);
+
+            LONGS_EQUAL(0, (size_t)objects[n] % CacheLineSize);
+            memset(objects[n]->padding, 0xff, sizeof(objects[n]->padding));
+        }
+
+        const size_t num_lines = cache_line_align(sizeof(Object)) / CacheLineSize;
+
+        for (size_t n = 0; n < 1 + 2 + 4; n++) {
+            for (size_t m = 0; m < 1 + 2 + 4; m++) {
+                if (m == n) {
+                    continue;
+                }
+                const size_t line_n = (size_t)objects[n] / CacheLineSize;
+                const size_t line_m = (size_t)objects[m] / CacheLineSize;
+                CHECK(line_m + num_lines <= line_n || line_n + num_lines <= line_m);
+            }
+        }
+
+        for (size_t n = 0; n < 1 + 2 + 4; n++) {
+            pool.destroy(*objects[n]);
+        }
+
+        LONGS_EQUAL(0, pool.trim());
+        LONGS_EQUAL(1 + 2, pool.trim());
+    }
+
+    LONGS_EQUAL(0, allocator.num_allocations());
+}
+
 } // namespace core
 } // namespace roc
@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/buffer.h"
+#include "roc_core/buffer_pool.h"
+#include "roc_core/heap_allocator.h"
+#include "roc_core/slice.h"
+#include "roc_core/slice_view.h"
+
+namespace roc {
+namespace core {
+
+namespace {
+
+enum { BufSz = 100 };
+
+HeapAllocator allocator;
+BufferPool<char> buffer_pool(allocator, BufSz, true);
+
+} // namespace
+
+TEST_GROUP(slice) {};
+
+TEST(slice, slice_range) {
+    Buffer<char>* buffer = new (buffer_pool) Buffer<char>(buffer_pool);
+
+    Slice<char> slice(buffer);
+
+    LONGS_EQUAL(1, buffer->getref());
+    LONGS_EQUAL(BufSz, slice.size());
+    LONGS_EQUAL(BufSz, slice.capacity());
+
+    {
+        Slice<char> part = slice.range(10, 20);
+
+        LONGS_EQUAL(2, buffer->getref());
+        LONGS_EQUAL(10, part.size());
+        LONGS_EQUAL(BufSz - 10, part.capacity());
+        POINTERS_EQUAL(buffer->data() + 10, part.data());
+    }
+
+    LONGS_EQUAL(1, buffer->getref());
+}
+
+TEST(slice, view_range) {
+    Buffer<char>* buffer = new (buffer_pool) Buffer<char>(buffer_pool);
+
+    Slice<char> slice(buffer);
+
+    SliceView<char> view = slice;
+    SliceView<char> part = view.range(10, 20);
+    SliceView<char> subpart = part.range(5, 5);
+
+    LONGS_EQUAL(1, buffer->getref());
+
+    LONGS_EQUAL(BufSz, view.size());
+    POINTERS_EQUAL(buffer->data(), view.data());
+
+    LONGS_EQUAL(10, part.size());
+    LONGS_EQUAL(BufSz - 10, part.capacity());
+    POINTERS_EQUAL(buffer->data() + 10, part.data());
+
+    CHECK(subpart);
+    LONGS_EQUAL(0, subpart.size());
+    LONGS_EQUAL(BufSz - 15, subpart.capacity());
+
+    subpart.resize(20);
+    LONGS_EQUAL(20, subpart.size());
+    POINTERS_EQUAL(buffer->data() + 15, subpart.data());
+
+    LONGS_EQUAL(1, buffer->getref());
+}
+
+TEST(slice, view_to_slice) {
+    Buffer<char>* buffer = new (buffer_pool) Buffer<char>(buffer_pool);
+
+    SliceView<char> part;
+
+    {
+        Slice<char> slice(buffer);
+        part = slice.range(10, 20);
+
+        LONGS_EQUAL(1, buffer->getref());
+
+        Slice<char> part_slice(part);
+
+        LONGS_EQUAL(2, buffer->getref());
+        LONGS_EQUAL(10, part_slice.size());
+        POINTERS_EQUAL(buffer->data() + 10, part_slice.data());
+    }
+}
+
+TEST(slice, resize_through_view) {
+    Buffer<char>* buffer = new (buffer_pool) Buffer<char>(buffer_pool);
+
+    Slice<char> slice(buffer);
+    slice.resize(0);
+
+    SliceView<char>& view = slice;
+    view.resize(30);
+
+    LONGS_EQUAL(30, slice.size());
+    LONGS_EQUAL(1, buffer->getref());
+}
+
+TEST(slice, empty) {
+    Slice<char> slice;
+    SliceView<char> view;
+
+    CHECK(!slice);
+    CHECK(!view);
+
+    LONGS_EQUAL(0, slice.size());
+    LONGS_EQUAL(0, view.size());
+
+    LONGS_EQUAL(0, slice.capacity());
+    LONGS_EQUAL(0, view.capacity());
+
+    Slice<char> view_slice(view);
+    CHECK(!view_slice);
+}
+
+} // namespace core
+} // namespace roc
@@ -115,7 +115,7 @@ void fill_packet(packet::Packet& packet, bool is_rtp) {
     packet.fec()->source_block_length = Test_fec_sbl;
     packet.fec()->block_length = Test_fec_nes;
 
-    core::Slice<uint8_t> packet_payload;
+    core::SliceView<uint8_t> packet_payload;
     if (is_rtp) {
         packet_payload = packet.rtp()->payload;
     } else {
@@ -149,7 +149,7 @@ void check_packet(packet::Packet& packet,
     UNSIGNED_LONGS_EQUAL(Test_fec_sbl, packet.fec()->source_block_length);
     UNSIGNED_LONGS_EQUAL(block_length, packet.fec()->block_length);
 
-    core::Slice<uint8_t> packet_payload;
+    core::SliceView<uint8_t> packet_payload;
     if (is_rtp) {
         packet_payload = packet.rtp()->payload;
     } else {
@@ -255,6 +255,27 @@ TEST(composer_parser, rtp_ldpc_source) {
     test_all(test);
 }
 
+TEST(composer_parser, rtp_ldpc_source_static) {
+    rtp::Composer rtp_composer(NULL);
+    Composer<LDPC_Source_PayloadID, Source, Footer, rtp::Composer> ldpc_composer(
+        &rtp_composer);
+
+    rtp::FormatMap rtp_format_map;
+    rtp::Parser rtp_parser(rtp_format_map, NULL);
+    Parser<LDPC_Source_PayloadID, Source, Footer, rtp::Parser> ldpc_parser(&rtp_parser);
+
+    PacketTest test;
+    test.composer = &ldpc_composer;
+    test.parser = &ldpc_parser;
+    test.scheme = packet::FEC_LDPC_Staircase;
+    test.is_rtp = true;
+    test.block_length = 0;
+    test.reference = Ref_rtp_ldpc_source;
+    test.reference_size = sizeof(Ref_rtp_ldpc_source);
+
+    test_all(test);
+}
+
 TEST(composer_parser, ldpc_repair) {
     Composer<LDPC_Repair_PayloadID, Repair, Header> ldpc_composer(NULL);
     Parser<LDPC_Repair_PayloadID, Repair, Header> ldpc_parser(NULL);
@@ -291,6 +312,26 @@ TEST(composer_parser, rtp_rsm8_source) {
     test_all(test);
 }
 
+TEST(composer_parser, rtp_rsm8_source_static) {
+    rtp::Composer rtp_composer(NULL);
+    Composer<RSm8_PayloadID, Source, Footer, rtp::Composer> rsm8_composer(&rtp_composer);
+
+    rtp::FormatMap rtp_format_map;
+    rtp::Parser rtp_parser(rtp_format_map, NULL);
+    Parser<RSm8_PayloadID, Source, Footer, rtp::Parser> rsm8_parser(&rtp_parser);
+
+    PacketTest test;
+    test.composer = &rsm8_composer;
+    test.parser = &rsm8_parser;
+    test.scheme = packet::FEC_ReedSolomon_M8;
+    test.is_rtp = true;
+    test.block_length = 255;
+    test.reference = Ref_rtp_rsm8_source;
+    test.reference_size = sizeof(Ref_rtp_rsm8_source);
+
+    test_all(test);
+}
+
 TEST(composer_parser, rsm8_repair) {
     Composer<RSm8_PayloadID, Repair, Header> rsm8_composer(NULL);
     Parser<RSm8_PayloadID, Repair, Header> rsm8_parser(NULL);
@@ -26,6 +26,86 @@ TEST(context, open_close) {
     LONGS_EQUAL(0, roc_context_close(context));
 }
 
+TEST(context, open_close_arena) {
+    roc_context_config config;
+    memset(&config, 0, sizeof(config));
+
+    config.allocator = ROC_ALLOCATOR_ARENA;
+
+    roc_context* context = roc_context_open(&config);
+    CHECK(context);
+
+    LONGS_EQUAL(0, roc_context_close(context));
+}
+
+TEST(context, open_close_arena_huge_pages) {
+    roc_context_config config;
+    memset(&config, 0, sizeof(config));
+
+    config.allocator = ROC_ALLOCATOR_ARENA_HUGE_PAGES;
+
+    roc_context* context = roc_context_open(&config);
+    CHECK(context);
+
+    LONGS_EQUAL(0, roc_context_close(context));
+}
+
+TEST(context, open_close_network_threads) {
+    roc_context_config config;
+    memset(&config, 0, sizeof(config));
+
+    config.num_network_threads = 4;
+    config.num_receiver_shards = 2;
+
+    roc_context* context = roc_context_open(&config);
+    CHECK(context);
+
+    LONGS_EQUAL(0, roc_context_close(context));
+}
+
+TEST(context, open_close_direct_send) {
+    roc_context_config config;
+    memset(&config, 0, sizeof(config));
+
+    config.direct_send = 1;
+
+    roc_context* context = roc_context_open(&config);
+    CHECK(context);
+
+    LONGS_EQUAL(0, roc_context_close(context));
+}
+
+TEST(context, open_close_receive_timestamps) {
+    roc_context_config config;
+    memset(&config, 0, sizeof(config));
+
+    config.receive_timestamps = 1;
+
+    roc_context* context = roc_context_open(&config);
+    CHECK(context);
+
+    LONGS_EQUAL(0, roc_context_close(context));
+}
+
+TEST(context, open_bad_receiver_shards) {
+    roc_context_config config;
+    memset(&config, 0, sizeof(config));
+
+    config.num_network_threads = 2;
+    config.num_receiver_shards = 3;
+
+    CHECK(!roc_context_open(&config));
+}
+
+TEST(context, open_bad_allocator) {
+    roc_context_config config;
+    memset(&config, 0, sizeof(config));
+
+    config.allocator = (roc_allocator)100;
+
+    CHECK(!roc_context_open(&config));
+}
+
 TEST(context, close_null) {
     LONGS_EQUAL(-1, roc_context_close(NULL));
 }
@@ -21,6 +21,7 @@
 #include "roc_netio/transceiver.h"
 #include "roc_packet/address.h"
 #include "roc_packet/address_to_str.h"
+#include "roc_packet/jitter_queue.h"
 #include "roc_packet/packet_pool.h"
 #include "roc_packet/queue.h"
 
@@ -67,6 +68,11 @@ public:
         CHECK(ctx_);
     }
 
+    Context(const roc_context_config& config) {
+        ctx_ = roc_context_open(&config);
+        CHECK(ctx_);
+    }
+
     ~Context() {
         CHECK(roc_context_close(ctx_) == 0);
     }
@@ -258,7 +264,7 @@ public:
           const roc_address* dst_repair_addr,
           size_t n_source_packets,
           size_t n_repair_packets)
-        : trx_(packet_pool, byte_buffer_pool, allocator)
+        : trx_(netio::TransceiverConfig(), packet_pool, byte_buffer_pool, allocator)
         , n_source_packets_(n_source_packets)
         , n_repair_packets_(n_repair_packets)
         , pos_(0) {
@@ -423,6 +429,125 @@ TEST(sender_receiver, bare_rtp) {
     sender.join();
 }
 
+TEST(sender_receiver, bare_rtp_network_threads) {
+    enum { Flags = 0 };
+
+    init_config(Flags);
+
+    roc_context_config context_conf;
+    memset(&context_conf, 0, sizeof(context_conf));
+
+    context_conf.num_network_threads = 3;
+    context_conf.num_receiver_shards = 2;
+
+    Context context(context_conf);
+
+    Receiver receiver(context, receiver_conf, samples, TotalSamples, FrameSamples, Flags);
+
+    Sender sender(context, sender_conf, receiver.source_addr(), receiver.repair_addr(),
+                  samples, TotalSamples, FrameSamples, Flags);
+
+    sender.start();
+    receiver.run();
+    sender.join();
+}
+
+TEST(sender_receiver, bare_rtp_direct_send) {
+    enum { Flags = 0 };
+
+    init_config(Flags);
+
+    roc_context_config context_conf;
+    memset(&context_conf, 0, sizeof(context_conf));
+
+    context_conf.direct_send = 1;
+
+    Context context(context_conf);
+
+    Receiver receiver(context, receiver_conf, samples, TotalSamples, FrameSamples, Flags);
+
+    Sender sender(context, sender_conf, receiver.source_addr(), receiver.repair_addr(),
+                  samples, TotalSamples, FrameSamples, Flags);
+
+    sender.start();
+    receiver.run();
+    sender.join();
+}
+
+TEST(sender_receiver, bare_rtp_receive_timestamps) {
+    enum { Flags = 0 };
+
+    init_config(Flags);
+
+    roc_context_config context_conf;
+    memset(&context_conf, 0, sizeof(context_conf));
+
+    context_conf.receive_timestamps = 1;
+
+    Context context(context_conf);
+
+    Receiver receiver(context, receiver_conf, samples, TotalSamples, FrameSamples, Flags);
+
+    Sender sender(context, sender_conf, receiver.source_addr(), receiver.repair_addr(),
+                  samples, TotalSamples, FrameSamples, Flags);
+
+    sender.start();
+    receiver.run();
+    sender.join();
+}
+
+TEST(sender_receiver, bare_rtp_route_on_write) {
+    enum { Flags = 0 };
+
+    init_config(Flags);
+
+    receiver_conf.route_on_write = 1;
+
+    Context context;
+
+    Receiver receiver(context, receiver_conf, samples, TotalSamples, FrameSamples, Flags);
+
+    Sender sender(context, sender_conf, receiver.source_addr(), receiver.repair_addr(),
+                  samples, TotalSamples, FrameSamples, Flags);
+
+    sender.start();
+    receiver.run();
+    sender.join();
+}
+
+TEST(sender_receiver, bare_rtp_queue_sizes) {
+    enum { Flags = 0 };
+
+    init_config(Flags);
+
+    receiver_conf.max_queued_packets = 256;
+    receiver_conf.jitter_queue_size = 128;
+    receiver_conf.repair_queue_size = 64;
+
+    Context context;
+
+    Receiver receiver(context, receiver_conf, samples, TotalSamples, FrameSamples, Flags);
+
+    Sender sender(context, sender_conf, receiver.source_addr(), receiver.repair_addr(),
+                  samples, TotalSamples, FrameSamples, Flags);
+
+    sender.start();
+    receiver.run();
+    sender.join();
+}
+
+TEST(sender_receiver, bad_jitter_queue_size) {
+    init_config(0);
+
+    Context context;
+
+    receiver_conf.jitter_queue_size = 100;
+    CHECK(!roc_receiver_open(context.get(), &receiver_conf));
+
+    receiver_conf.jitter_queue_size = packet::JitterQueue::MaxCapacity * 2;
+    CHECK(!roc_receiver_open(context.get(), &receiver_conf));
+}
+
 #ifdef ROC_TARGET_OPENFEC
 TEST(sender_receiver, fec_without_losses) {
     enum { Flags = FlagFEC };
@@ -11,6 +11,7 @@
 #include "roc_core/buffer_pool.h"
 #include "roc_core/heap_allocator.h"
 #include "roc_netio/transceiver.h"
+#include "roc_netio/udp_receiver_port.h"
 #include "roc_packet/address.h"
 #include "roc_packet/concurrent_queue.h"
 #include "roc_packet/packet_pool.h"
@@ -34,10 +35,12 @@ packet::Address make_address(const char* ip, int port) {
 
 } // namespace
 
-TEST_GROUP(transceiver) {};
+TEST_GROUP(transceiver) {
+    TransceiverConfig config;
+};
 
 TEST(transceiver, init) {
-    Transceiver trx(packet_pool, buffer_pool, allocator);
+    Transceiver trx(config, packet_pool, buffer_pool, allocator);
 
     CHECK(trx.valid());
 }
@@ -45,7 +48,7 @@ TEST(transceiver, init) {
 TEST(transceiver, bind_any) {
     packet::ConcurrentQueue queue;
 
-    Transceiver trx(packet_pool, buffer_pool, allocator);
+    Transceiver trx(config, packet_pool, buffer_pool, allocator);
 
     CHECK(trx.valid());
 
@@ -62,7 +65,7 @@ TEST(transceiver, bind_any) {
 TEST(transceiver, bind_lo) {
     packet::ConcurrentQueue queue;
 
-    Transceiver trx(packet_pool, buffer_pool, allocator);
+    Transceiver trx(config, packet_pool, buffer_pool, allocator);
 
     CHECK(trx.valid());
 
@@ -79,7 +82,7 @@ TEST(transceiver, bind_lo) {
 TEST(transceiver, bind_addrinuse) {
     packet::ConcurrentQueue queue;
 
-    Transceiver trx1(packet_pool, buffer_pool, allocator);
+    Transceiver trx1(config, packet_pool, buffer_pool, allocator);
     CHECK(trx1.valid());
 
     packet::Address tx_addr = make_address("127.0.0.1", 0);
@@ -88,7 +91,7 @@ TEST(transceiver, bind_addrinuse) {
     CHECK(trx1.add_udp_sender(tx_addr));
     CHECK(trx1.add_udp_receiver(rx_addr, queue));
 
-    Transceiver trx2(packet_pool, buffer_pool, allocator);
+    Transceiver trx2(config, packet_pool, buffer_pool, allocator);
     CHECK(trx2.valid());
 
     CHECK(!trx2.add_udp_sender(tx_addr));
@@ -98,7 +101,7 @@ TEST(transceiver, bind_addrinuse) {
 TEST(transceiver, add) {
     packet::ConcurrentQueue queue;
 
-    Transceiver trx(packet_pool, buffer_pool, allocator);
+    Transceiver trx(config, packet_pool, buffer_pool, allocator);
 
     CHECK(trx.valid());
 
@@ -112,7 +115,7 @@ TEST(transceiver, add) {
 TEST(transceiver, add_remove) {
     packet::ConcurrentQueue queue;
 
-    Transceiver trx(packet_pool, buffer_pool, allocator);
+    Transceiver trx(config, packet_pool, buffer_pool, allocator);
 
     CHECK(trx.valid());
 
@@ -135,7 +138,7 @@ TEST(transceiver, add_remove) {
 }
 
 TEST(transceiver, add_remove_add) {
-    Transceiver trx(packet_pool, buffer_pool, allocator);
+    Transceiver trx(config, packet_pool, buffer_pool, allocator);
 
     CHECK(trx.valid());
 
@@ -149,7 +152,7 @@ TEST(transceiver, add_remove_add) {
 TEST(transceiver, add_duplicate) {
     packet::ConcurrentQueue queue;
 
-    Transceiver trx(packet_pool, buffer_pool, allocator);
+    Transceiver trx(config, packet_pool, buffer_pool, allocator);
 
     CHECK(trx.valid());
 
@@ -181,5 +184,71 @@ TEST(transceiver, add_duplicate) {
     UNSIGNED_LONGS_EQUAL(0, trx.num_ports());
 }
 
+TEST(transceiver, many_loops) {
+    enum { NumLoops = 4, NumPorts = 8 };
+
+    packet::ConcurrentQueue queue;
+
+    config.num_loops = NumLoops;
+
+    Transceiver trx(config, packet_pool, buffer_pool, allocator);
+
+    CHECK(trx.valid());
+    UNSIGNED_LONGS_EQUAL(NumLoops, trx.num_loops());
+
+    packet::Address addrs[NumPorts];
+
+    for (size_t n = 0; n < NumPorts; n++) {
+        addrs[n] = make_address("127.0.0.1", 0);
+
+        if (n % 2 == 0) {
+            CHECK(trx.add_udp_sender(addrs[n]));
+        } else {
+            CHECK(trx.add_udp_receiver(addrs[n], queue));
+        }
+
+        UNSIGNED_LONGS_EQUAL(n + 1, trx.num_ports());
+    }
+
+    for (size_t n = 0; n < NumPorts; n++) {
+        CHECK(!trx.add_udp_receiver(addrs[n], queue));
+    }
+
+    for (size_t n = 0; n < NumPorts; n++) {
+        trx.remove_port(addrs[n]);
+        UNSIGNED_LONGS_EQUAL(NumPorts - n - 1, trx.num_ports());
+    }
+}
+
+TEST(transceiver, receiver_shards) {
+    enum { NumLoops = 4 };
+
+    packet::ConcurrentQueue queue;
+
+    config.num_loops = NumLoops;
+    config.num_receiver_shards = NumLoops;
+
+    Transceiver trx(config, packet_pool, buffer_pool, allocator);
+
+    CHECK(trx.valid());
+
+    const size_t num_sockets = UDPReceiverPort::reuseport_supported() ? NumLoops : 1;
+
+    packet::Address rx_addr = make_address("127.0.0.1", 0);
+
+    CHECK(trx.add_udp_receiver(rx_addr, queue));
+    UNSIGNED_LONGS_EQUAL(num_sockets, trx.num_ports());
+
+    CHECK(!trx.add_udp_receiver(rx_addr, queue));
+    CHECK(!trx.add_udp_sender(rx_addr));
+    UNSIGNED_LONGS_EQUAL(num_sockets, trx.num_ports());
+
+    trx.remove_port(rx_addr);
+    UNSIGNED_LONGS_EQUAL(0, trx.num_ports());
+
+    CHECK(trx.add_udp_receiver(rx_addr, queue));
+    UNSIGNED_LONGS_EQUAL(num_sockets, trx.num_ports());
+}
+
 } // namespace netio
 } // namespace roc
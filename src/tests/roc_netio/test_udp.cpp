@@ -10,6 +10,8 @@
 
 #include "roc_core/buffer_pool.h"
 #include "roc_core/heap_allocator.h"
+#include "roc_core/thread.h"
+#include "roc_core/unique_ptr.h"
 #include "roc_netio/transceiver.h"
 #include "roc_packet/address.h"
 #include "roc_packet/concurrent_queue.h"
@@ -20,33 +22,67 @@ namespace netio {
 
 namespace {
 
-enum { NumIterations = 20, NumPackets = 10, BufferSize = 125 };
+enum {
+    NumIterations = 20,
+    NumPackets = 10,
+    PacketSize = 125,
+    MaxBufSize = 500
+};
 
 core::HeapAllocator allocator;
-core::BufferPool<uint8_t> buffer_pool(allocator, BufferSize, true);
+core::BufferPool<uint8_t> buffer_pool(allocator, MaxBufSize, true);
 packet::PacketPool packet_pool(allocator, true);
 
+class WriterThread : public core::Thread {
+public:
+    WriterThread(packet::IWriter& writer)
+        : writer_(writer)
+        , n_packets_(0) {
+    }
+
+    void add(const packet::PacketPtr& pp) {
+        CHECK(n_packets_ < NumPackets);
+        packets_[n_packets_++] = pp;
+    }
+
+private:
+    virtual void run() {
+        for (size_t n = 0; n < n_packets_; n++) {
+            writer_.write(packets_[n]);
+        }
+    }
+
+    packet::IWriter& writer_;
+
+    packet::PacketPtr packets_[NumPackets];
+    size_t n_packets_;
+};
+
 } // namespace
 
 TEST_GROUP(udp) {
+    TransceiverConfig config;
+
     packet::Address new_address() {
         packet::Address addr;
         CHECK(addr.set_ipv4("127.0.0.1", 0));
         return addr;
     }
 
-    core::Slice<uint8_t> new_buffer(int value) {
+    core::Slice<uint8_t> new_buffer(int value, size_t size = PacketSize) {
         core::Slice<uint8_t> buf = new (buffer_pool) core::Buffer<uint8_t>(buffer_pool);
         CHECK(buf);
-        buf.resize(BufferSize);
-        for (int n = 0; n < BufferSize; n++) {
+        buf.resize(size);
+        for (size_t n = 0; n < size; n++) {
             buf.data()[n] = uint8_t((value + n) & 0xff);
         }
         return buf;
     }
 
-    packet::PacketPtr
-    new_packet(packet::Address tx_addr, packet::Address rx_addr, int value) {
+    packet::PacketPtr new_packet(packet::Address tx_addr,
+                                 packet::Address rx_addr,
+                                 int value,
+                                 size_t size = PacketSize) {
         packet::PacketPtr pp = new (packet_pool) packet::Packet(packet_pool);
         CHECK(pp);
 
@@ -55,7 +91,7 @@ TEST_GROUP(udp) {
         pp->udp()->src_addr = tx_addr;
         pp->udp()->dst_addr = rx_addr;
 
-        pp->set_data(new_buffer(value));
+        pp->set_data(new_buffer(value, size));
 
         return pp;
     }
@@ -63,7 +99,8 @@ TEST_GROUP(udp) {
     void check_packet(const packet::PacketPtr& pp,
                       packet::Address tx_addr,
                       packet::Address rx_addr,
-                      int value) {
+                      int value,
+                      size_t size = PacketSize) {
         CHECK(pp);
 
         CHECK(pp->udp());
@@ -72,7 +109,7 @@ TEST_GROUP(udp) {
         CHECK(pp->udp()->src_addr == tx_addr);
         CHECK(pp->udp()->dst_addr == rx_addr);
 
-        core::Slice<uint8_t> expected = new_buffer(value);
+        core::Slice<uint8_t> expected = new_buffer(value, size);
 
         UNSIGNED_LONGS_EQUAL(expected.size(), pp->data().size());
         CHECK(memcmp(pp->data().data(), expected.data(), expected.size()) == 0);
@@ -85,7 +122,7 @@ TEST(udp, one_sender_one_receiver_single_thread) {
     packet::Address tx_addr = new_address();
     packet::Address rx_addr = new_address();
 
-    Transceiver trx(packet_pool, buffer_pool, allocator);
+    Transceiver trx(config, packet_pool, buffer_pool, allocator);
     CHECK(trx.valid());
 
     packet::IWriter* tx_sender = trx.add_udp_sender(tx_addr);
@@ -98,7 +135,11 @@ TEST(udp, one_sender_one_receiver_single_thread) {
             tx_sender->write(new_packet(tx_addr, rx_addr, p));
         }
         for (int p = 0; p < NumPackets; p++) {
-            check_packet(rx_queue.read(), tx_addr, rx_addr, p);
+            packet::PacketPtr pp = rx_queue.read();
+            check_packet(pp, tx_addr, rx_addr, p);
+
+            // timestamps are not requested by default
+            CHECK(pp->udp()->receive_timestamp == 0);
         }
     }
 }
@@ -109,13 +150,101 @@ TEST(udp, one_sender_one_receiver_separate_threads) {
     packet::Address tx_addr = new_address();
     packet::Address rx_addr = new_address();
 
-    Transceiver tx(packet_pool, buffer_pool, allocator);
+    Transceiver tx(config, packet_pool, buffer_pool, allocator);
+    CHECK(tx.valid());
+
+    packet::IWriter* tx_sender = tx.add_udp_sender(tx_addr);
+    CHECK(tx_sender);
+
+    Transceiver rx(config, packet_pool, buffer_pool, allocator);
+    CHECK(rx.valid());
+
+    CHECK(rx.add_udp_receiver(rx_addr, rx_queue));
+
+    for (int i = 0; i < NumIterations; i++) {
+        for (int p = 0; p < NumPackets; p++) {
+            tx_sender->write(new_packet(tx_addr, rx_addr, p));
+        }
+        for (int p = 0; p < NumPackets; p++) {
+            check_packet(rx_queue.read(), tx_addr, rx_addr, p);
+        }
+    }
+}
+
+TEST(udp, one_sender_concurrent_writers) {
+    enum { NumWriters = 4 };
+
+    packet::ConcurrentQueue rx_queue;
+
+    packet::Address tx_addr = new_address();
+    packet::Address rx_addr = new_address();
+
+    Transceiver tx(config, packet_pool, buffer_pool, allocator);
+    CHECK(tx.valid());
+
+    packet::IWriter* tx_sender = tx.add_udp_sender(tx_addr);
+    CHECK(tx_sender);
+
+    Transceiver rx(config, packet_pool, buffer_pool, allocator);
+    CHECK(rx.valid());
+    CHECK(rx.add_udp_receiver(rx_addr, rx_queue));
+
+    for (int i = 0; i < NumIterations; i++) {
+        core::UniquePtr<WriterThread> writers[NumWriters];
+
+        for (int w = 0; w < NumWriters; w++) {
+            writers[w].reset(new (allocator) WriterThread(*tx_sender), allocator);
+            CHECK(writers[w]);
+
+            for (int p = 0; p < NumPackets; p++) {
+                writers[w]->add(new_packet(tx_addr, rx_addr, w * NumPackets + p));
+            }
+        }
+
+        for (int w = 0; w < NumWriters; w++) {
+            CHECK(writers[w]->start());
+        }
+
+        for (int w = 0; w < NumWriters; w++) {
+            writers[w]->join();
+        }
+
+        // packets of different writers may be interleaved, but packets of
+        // every writer should be sent in order
+        int next_value[NumWriters] = {};
+
+        for (int p = 0; p < NumPackets * NumWriters; p++) {
+            packet::PacketPtr pp = rx_queue.read();
+            CHECK(pp);
+            CHECK(pp->data());
+
+            const int w = pp->data().data()[0] / NumPackets;
+            CHECK(w < NumWriters);
+
+            check_packet(pp, tx_addr, rx_addr, w * NumPackets + next_value[w]++);
+        }
+
+        for (int w = 0; w < NumWriters; w++) {
+            LONGS_EQUAL(NumPackets, next_value[w]);
+        }
+    }
+}
+
+TEST(udp, one_sender_one_receiver_direct_send) {
+    packet::ConcurrentQueue rx_queue;
+
+    packet::Address tx_addr = new_address();
+    packet::Address rx_addr = new_address();
+
+    config.direct_send = true;
+
+    Transceiver tx(config, packet_pool, buffer_pool, allocator);
     CHECK(tx.valid());
 
     packet::IWriter* tx_sender = tx.add_udp_sender(tx_addr);
     CHECK(tx_sender);
 
-    Transceiver rx(packet_pool, buffer_pool, allocator);
+    Transceiver rx(config, packet_pool, buffer_pool, allocator);
     CHECK(rx.valid());
 
     CHECK(rx.add_udp_receiver(rx_addr, rx_queue));
@@ -130,6 +259,125 @@ TEST(udp, one_sender_one_receiver_separate_threads) {
     }
 }
 
+TEST(udp, one_sender_mixed_burst) {
+    enum { BurstSize = 48, NumSizes = 4 };
+
+    // consecutive packets of the same size and destination are coalesced
+    // into a single gso datagram, and the runs here end at both boundaries
+    const size_t sizes[NumSizes] = { 100, 300, 100, 48 };
+
+    packet::Address tx_addr = new_address();
+    packet::Address rx_addr1 = new_address();
+    packet::Address rx_addr2 = new_address();
+
+    for (int direct_send = 0; direct_send <= 1; direct_send++) {
+        packet::ConcurrentQueue rx_queue1;
+        packet::ConcurrentQueue rx_queue2;
+
+        config.direct_send = (direct_send != 0);
+
+        Transceiver tx(config, packet_pool, buffer_pool, allocator);
+        CHECK(tx.valid());
+
+        packet::IWriter* tx_sender = tx.add_udp_sender(tx_addr);
+        CHECK(tx_sender);
+
+        Transceiver rx(config, packet_pool, buffer_pool, allocator);
+        CHECK(rx.valid());
+
+        CHECK(rx.add_udp_receiver(rx_addr1, rx_queue1));
+        CHECK(rx.add_udp_receiver(rx_addr2, rx_queue2));
+
+        for (int i = 0; i < NumIterations; i++) {
+            packet::PacketPtr packets[BurstSize];
+
+            for (int p = 0; p < BurstSize; p++) {
+                packets[p] = new_packet(tx_addr, (p / 5) % 2 ? rx_addr2 : rx_addr1, p,
+                                        sizes[(p / 3) % NumSizes]);
+            }
+
+            tx_sender->write_many(packets, BurstSize);
+
+            for (int p = 0; p < BurstSize; p++) {
+                if ((p / 5) % 2) {
+                    check_packet(rx_queue2.read(), tx_addr, rx_addr2, p,
+                                 sizes[(p / 3) % NumSizes]);
+                } else {
+                    check_packet(rx_queue1.read(), tx_addr, rx_addr1, p,
+                                 sizes[(p / 3) % NumSizes]);
+                }
+            }
+        }
+    }
+}
+
+TEST(udp, one_sender_one_receiver_timestamps) {
+    packet::ConcurrentQueue rx_queue;
+
+    packet::Address tx_addr = new_address();
+    packet::Address rx_addr = new_address();
+
+    config.receive_timestamps = true;
+
+    Transceiver trx(config, packet_pool, buffer_pool, allocator);
+    CHECK(trx.valid());
+
+    packet::IWriter* tx_sender = trx.add_udp_sender(tx_addr);
+    CHECK(tx_sender);
+
+    CHECK(trx.add_udp_receiver(rx_addr, rx_queue));
+
+    core::nanoseconds_t prev_timestamp = 0;
+
+    for (int i = 0; i < NumIterations; i++) {
+        for (int p = 0; p < NumPackets; p++) {
+            tx_sender->write(new_packet(tx_addr, rx_addr, p));
+        }
+        for (int p = 0; p < NumPackets; p++) {
+            packet::PacketPtr pp = rx_queue.read();
+            check_packet(pp, tx_addr, rx_addr, p);
+
+            const core::nanoseconds_t timestamp = pp->udp()->receive_timestamp;
+#ifdef __linux__
+            CHECK(timestamp != 0);
+#endif
+            if (timestamp != 0) {
+                CHECK(timestamp >= prev_timestamp);
+                prev_timestamp = timestamp;
+            }
+        }
+    }
+}
+
+TEST(udp, one_sender_one_receiver_max_size) {
+    packet::ConcurrentQueue rx_queue;
+
+    packet::Address tx_addr = new_address();
+    packet::Address rx_addr = new_address();
+
+    // the largest packet that fits into a pool buffer
+    const size_t max_size = MaxBufSize - Transceiver::buffer_overhead();
+
+    config.receive_timestamps = true;
+
+    Transceiver trx(config, packet_pool, buffer_pool, allocator);
+    CHECK(trx.valid());
+
+    packet::IWriter* tx_sender = trx.add_udp_sender(tx_addr);
+    CHECK(tx_sender);
+
+    CHECK(trx.add_udp_receiver(rx_addr, rx_queue));
+
+    for (int i = 0; i < NumIterations; i++) {
+        for (int p = 0; p < NumPackets; p++) {
+            tx_sender->write(new_packet(tx_addr, rx_addr, p, max_size));
+        }
+        for (int p = 0; p < NumPackets; p++) {
+            check_packet(rx_queue.read(), tx_addr, rx_addr, p, max_size);
+        }
+    }
+}
+
 TEST(udp, one_sender_multiple_receivers) {
     packet::ConcurrentQueue rx_queue1;
     packet::ConcurrentQueue rx_queue2;
@@ -141,17 +389,17 @@ TEST(udp, one_sender_multiple_receivers) {
     packet::Address rx_addr2 = new_address();
     packet::Address rx_addr3 = new_address();
 
-    Transceiver tx(packet_pool, buffer_pool, allocator);
+    Transceiver tx(config, packet_pool, buffer_pool, allocator);
     CHECK(tx.valid());
 
     packet::IWriter* tx_sender = tx.add_udp_sender(tx_addr);
     CHECK(tx_sender);
 
-    Transceiver rx1(packet_pool, buffer_pool, allocator);
+    Transceiver rx1(config, packet_pool, buffer_pool, allocator);
     CHECK(rx1.valid());
     CHECK(rx1.add_udp_receiver(rx_addr1, rx_queue1));
 
-    Transceiver rx23(packet_pool, buffer_pool, allocator);
+    Transceiver rx23(config, packet_pool, buffer_pool, allocator);
     CHECK(rx23.valid());
     CHECK(rx23.add_udp_receiver(rx_addr2, rx_queue2));
     CHECK(rx23.add_udp_receiver(rx_addr3, rx_queue3));
@@ -179,13 +427,13 @@ TEST(udp, multiple_senders_one_receiver) {
 
     packet::Address rx_addr = new_address();
 
-    Transceiver tx1(packet_pool, buffer_pool, allocator);
+    Transceiver tx1(config, packet_pool, buffer_pool, allocator);
     CHECK(tx1.valid());
 
     packet::IWriter* tx_sender1 = tx1.add_udp_sender(tx_addr1);
     CHECK(tx_sender1);
 
-    Transceiver tx23(packet_pool, buffer_pool, allocator);
+    Transceiver tx23(config, packet_pool, buffer_pool, allocator);
     CHECK(tx23.valid());
 
     packet::IWriter* tx_sender2 = tx23.add_udp_sender(tx_addr2);
@@ -194,7 +442,7 @@ TEST(udp, multiple_senders_one_receiver) {
     packet::IWriter* tx_sender3 = tx23.add_udp_sender(tx_addr3);
     CHECK(tx_sender3);
 
-    Transceiver rx(packet_pool, buffer_pool, allocator);
+    Transceiver rx(config, packet_pool, buffer_pool, allocator);
     CHECK(rx.valid());
     CHECK(rx.add_udp_receiver(rx_addr, rx_queue));
 
@@ -220,5 +468,65 @@ TEST(udp, multiple_senders_one_receiver) {
     }
 }
 
+TEST(udp, multiple_senders_sharded_receiver) {
+    enum { NumLoops = 4, NumSenders = 3 };
+
+    // shards write to the queue from several loop threads concurrently
+    packet::ConcurrentQueue rx_queue;
+
+    packet::Address tx_addr[NumSenders];
+    for (size_t s = 0; s < NumSenders; s++) {
+        tx_addr[s] = new_address();
+    }
+
+    packet::Address rx_addr = new_address();
+
+    Transceiver tx(config, packet_pool, buffer_pool, allocator);
+    CHECK(tx.valid());
+
+    packet::IWriter* tx_sender[NumSenders];
+    for (size_t s = 0; s < NumSenders; s++) {
+        tx_sender[s] = tx.add_udp_sender(tx_addr[s]);
+        CHECK(tx_sender[s]);
+    }
+
+    config.num_loops = NumLoops;
+    config.num_receiver_shards = NumLoops;
+
+    Transceiver rx(config, packet_pool, buffer_pool, allocator);
+    CHECK(rx.valid());
+    CHECK(rx.add_udp_receiver(rx_addr, rx_queue));
+
+    for (int i = 0; i < NumIterations; i++) {
+        for (int p = 0; p < NumPackets; p++) {
+            for (size_t s = 0; s < NumSenders; s++) {
+                tx_sender[s]->write(new_packet(tx_addr[s], rx_addr, p));
+            }
+        }
+
+        // packets of different senders may be reordered, but packets of
+        // every sender should be received in order
+        int next_value[NumSenders] = {};
+
+        for (int p = 0; p < NumPackets * NumSenders; p++) {
+            packet::PacketPtr pp = rx_queue.read();
+            CHECK(pp);
+            CHECK(pp->udp());
+
+            size_t s = 0;
+            while (s < NumSenders && pp->udp()->src_addr != tx_addr[s]) {
+                s++;
+            }
+            CHECK(s < NumSenders);
+
+            check_packet(pp, tx_addr[s], rx_addr, next_value[s]++);
+        }
+
+        for (size_t s = 0; s < NumSenders; s++) {
+            LONGS_EQUAL(NumPackets, next_value[s]);
+        }
+    }
+}
+
 } // namespace netio
 } // namespace roc
@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include <stdio.h>
+
+#include "roc_core/heap_allocator.h"
+#include "roc_core/panic.h"
+#include "roc_core/time.h"
+#include "roc_packet/jitter_queue.h"
+#include "roc_packet/packet_pool.h"
+#include "roc_packet/sorted_queue.h"
+
+namespace roc {
+namespace packet {
+
+namespace {
+
+enum { NumPackets = 2000000, QueueDepth = 64, JitterQueueSize = 1024, MaxReorder = 32 };
+
+core::HeapAllocator allocator;
+PacketPool packet_pool(allocator, false);
+
+unsigned next_random(unsigned& state) {
+    state = state * 1103515245 + 12345;
+    return (state >> 16) & 0x7fff;
+}
+
+PacketPtr new_packet(seqnum_t sn) {
+    PacketPtr pp = new (packet_pool) Packet(packet_pool);
+    roc_panic_if(!pp);
+
+    pp->add_flags(Packet::FlagRTP);
+    pp->rtp()->seqnum = sn;
+
+    return pp;
+}
+
+// Writes packets in groups of @p reorder consecutive seqnums, shuffling every
+// group, and reads packets so that the queue keeps a fixed depth, like the
+// receiver session does. Returns nanoseconds per packet, including packet
+// allocation.
+double run_bench(IWriter& writer, IReader& reader, size_t reorder) {
+    seqnum_t group[MaxReorder];
+    unsigned rnd = 1;
+    size_t n_queued = 0;
+
+    const core::nanoseconds_t start = core::timestamp();
+
+    for (size_t n = 0; n < NumPackets; n += reorder) {
+        for (size_t i = 0; i < reorder; i++) {
+            group[i] = seqnum_t(n + i);
+        }
+
+        for (size_t i = reorder - 1; i > 0; i--) {
+            const size_t j = next_random(rnd) % (i + 1);
+            const seqnum_t sn = group[i];
+            group[i] = group[j];
+            group[j] = sn;
+        }
+
+        for (size_t i = 0; i < reorder; i++) {
+            writer.write(new_packet(group[i]));
+        }
+        n_queued += reorder;
+
+        for (; n_queued > QueueDepth; n_queued--) {
+            roc_panic_if(!reader.read());
+        }
+    }
+
+    while (reader.read()) {
+    }
+
+    return double(core::timestamp() - start) / NumPackets;
+}
+
+} // namespace
+
+// Compares the cost of reordering packets in SortedQueue, which inserts every
+// packet into a sorted list, and JitterQueue, which puts it into a slot indexed
+// by its seqnum.
+//
+// Not run by default; use "roc-test-packet -ri -g bench_jitter_queue".
+TEST_GROUP(bench_jitter_queue) {};
+
+IGNORE_TEST(bench_jitter_queue, reorder) {
+    const size_t reorders[] = { 1, 8, MaxReorder };
+
+    UT_PRINT("reorder  SortedQueue  JitterQueue (ns/packet)");
+
+    for (size_t n = 0; n < sizeof(reorders) / sizeof(reorders[0]); n++) {
+        SortedQueue sorted_queue(0);
+        const double sorted_ns = run_bench(sorted_queue, sorted_queue, reorders[n]);
+
+        JitterQueue jitter_queue(allocator, JitterQueueSize);
+        CHECK(jitter_queue.valid());
+        const double jitter_ns = run_bench(jitter_queue, jitter_queue, reorders[n]);
+
+        char report[128];
+        snprintf(report, sizeof(report), "%-7lu  %-11.1f  %.1f",
+                 (unsigned long)reorders[n], sorted_ns, jitter_ns);
+        UT_PRINT(report);
+    }
+}
+
+} // namespace packet
+} // namespace roc
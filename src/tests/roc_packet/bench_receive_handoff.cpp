@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#include "roc_core/buffer_pool.h"
+#include "roc_core/heap_allocator.h"
+#include "roc_core/mpsc_queue.h"
+#include "roc_core/panic.h"
+#include "roc_core/thread.h"
+#include "roc_core/time.h"
+#include "roc_packet/packet_pool.h"
+
+namespace roc {
+namespace packet {
+
+namespace {
+
+enum { NumPackets = 2000000, WindowSize = 64, PayloadSize = 200, MaxBufSize = 500 };
+
+core::HeapAllocator allocator;
+core::BufferPool<uint8_t> buffer_pool(allocator, MaxBufSize, false);
+PacketPool packet_pool(allocator, false);
+
+// Does what the network thread does for every received datagram: allocates
+// a packet and a buffer, fills them, and hands the packet to another thread.
+class NetworkThread : public core::Thread {
+public:
+    explicit NetworkThread(core::MpscQueue<Packet>& queue)
+        : queue_(queue) {
+    }
+
+private:
+    virtual void run() {
+        for (size_t n = 0; n < NumPackets; n++) {
+            core::Slice<uint8_t> buf =
+                new (buffer_pool) core::Buffer<uint8_t>(buffer_pool);
+            roc_panic_if(!buf);
+            buf.resize(PayloadSize);
+            memset(buf.data(), int(n & 0xff), PayloadSize);
+
+            PacketPtr pp = new (packet_pool) Packet(packet_pool);
+            roc_panic_if(!pp);
+            pp->add_flags(Packet::FlagUDP | Packet::FlagRTP);
+            pp->rtp()->seqnum = seqnum_t(n);
+            pp->rtp()->timestamp = timestamp_t(n * 100);
+            pp->set_data(buf);
+
+            queue_.push_back(*pp);
+        }
+    }
+
+    core::MpscQueue<Packet>& queue_;
+};
+
+} // namespace
+
+// Measures the cost of passing received packets from the network thread to
+// the pipeline thread, including false sharing between the two threads on
+// packet headers, reference counters, and queue fields.
+//
+// Not run by default; use "roc-test-packet -ri -g bench_receive_handoff".
+TEST_GROUP(bench_receive_handoff) {};
+
+IGNORE_TEST(bench_receive_handoff, mpsc_queue) {
+    core::MpscQueue<Packet> queue;
+    NetworkThread thread(queue);
+
+    // The pipeline keeps recent packets in the session queues for a while
+    // and releases them in the order they arrived.
+    PacketPtr window[WindowSize];
+    unsigned long sum = 0;
+
+    const core::nanoseconds_t start = core::timestamp();
+
+    CHECK(thread.start());
+
+    for (size_t n = 0; n < NumPackets;) {
+        PacketPtr pp = queue.pop_front();
+        if (!pp) {
+            continue;
+        }
+        sum += pp->rtp()->seqnum + pp->rtp()->timestamp + pp->data().data()[0];
+        window[n % WindowSize] = pp;
+        n++;
+    }
+
+    thread.join();
+
+    const core::nanoseconds_t elapsed = core::timestamp() - start;
+
+    for (size_t n = 0; n < WindowSize; n++) {
+        window[n] = NULL;
+    }
+
+    char report[128];
+    snprintf(report, sizeof(report),
+             "receive handoff: sizeof(Packet) %lu, %.1f ns/packet (checksum %lu)\n",
+             (unsigned long)sizeof(Packet), double(elapsed) / NumPackets, sum);
+    UT_PRINT(report);
+}
+
+} // namespace packet
+} // namespace roc
@@ -99,6 +99,10 @@ TEST(address, eq_ipv4) {
     CHECK(!(addr1 != addr2));
     CHECK(addr1 != addr3);
     CHECK(addr1 != addr4);
+
+    CHECK(addr1.hash() == addr2.hash());
+    CHECK(addr1.hash() != addr3.hash());
+    CHECK(addr1.hash() != addr4.hash());
 }
 
 TEST(address, eq_ipv6) {
@@ -125,6 +129,10 @@ TEST(address, eq_ipv6) {
     CHECK(!(addr1 != addr2));
     CHECK(addr1 != addr3);
     CHECK(addr1 != addr4);
+
+    CHECK(addr1.hash() == addr2.hash());
+    CHECK(addr1.hash() != addr3.hash());
+    CHECK(addr1.hash() != addr4.hash());
 }
 
 TEST(address, multicast_ipv4) {
@@ -17,6 +17,8 @@ namespace packet {
 
 namespace {
 
+enum { NumPackets = 8 };
+
 core::HeapAllocator allocator;
 PacketPool pool(allocator, true);
 
@@ -43,5 +45,69 @@ TEST(concurrent_queue, write_read) {
     CHECK(queue.read() == p2);
 }
 
+TEST(concurrent_queue, write_read_many) {
+    ConcurrentQueue queue;
+
+    PacketPtr wr_packets[NumPackets];
+    for (size_t n = 0; n < NumPackets; n++) {
+        wr_packets[n] = new_packet();
+    }
+
+    queue.write_many(wr_packets, 3);
+    queue.write_many(wr_packets + 3, 2);
+
+    PacketPtr rd_packets[NumPackets];
+
+    LONGS_EQUAL(5, queue.read_many(rd_packets, NumPackets));
+
+    for (size_t n = 0; n < 5; n++) {
+        CHECK(rd_packets[n] == wr_packets[n]);
+    }
+
+    queue.write_many(wr_packets + 5, 3);
+
+    LONGS_EQUAL(2, queue.read_many(rd_packets, 2));
+    CHECK(rd_packets[0] == wr_packets[5]);
+    CHECK(rd_packets[1] == wr_packets[6]);
+
+    LONGS_EQUAL(1, queue.read_many(rd_packets, NumPackets));
+    CHECK(rd_packets[0] == wr_packets[7]);
+}
+
+TEST(concurrent_queue, unbounded) {
+    enum { ManyPackets = NumPackets * 100 };
+
+    ConcurrentQueue queue;
+
+    PacketPtr packets[ManyPackets];
+    for (size_t n = 0; n < ManyPackets; n++) {
+        packets[n] = new_packet();
+        queue.write(packets[n]);
+    }
+
+    for (size_t n = 0; n < ManyPackets; n++) {
+        CHECK(queue.read() == packets[n]);
+    }
+}
+
+TEST(concurrent_queue, release_packets) {
+    PacketPtr packet = new_packet();
+
+    {
+        ConcurrentQueue queue;
+
+        queue.write(packet);
+        LONGS_EQUAL(2, packet->getref());
+
+        CHECK(queue.read() == packet);
+        LONGS_EQUAL(1, packet->getref());
+
+        queue.write(packet);
+        LONGS_EQUAL(2, packet->getref());
+    }
+
+    LONGS_EQUAL(1, packet->getref());
+}
+
 } // namespace packet
 } // namespace roc
@@ -140,5 +140,39 @@ TEST(delayed_reader, late_duplicates) {
     CHECK(!dr.read());
 }
 
+TEST(delayed_reader, read_many) {
+    Queue queue;
+    DelayedReader dr(queue, NumSamples * (NumPackets - 1) * NsPerSample, SampleRate);
+
+    PacketPtr packets[NumPackets];
+    PacketPtr result[NumPackets];
+
+    for (seqnum_t n = 0; n < NumPackets; n++) {
+        UNSIGNED_LONGS_EQUAL(0, dr.read_many(result, NumPackets));
+        packets[n] = new_packet(n);
+        queue.write(packets[n]);
+    }
+
+    UNSIGNED_LONGS_EQUAL(NumPackets / 2, dr.read_many(result, NumPackets / 2));
+
+    for (seqnum_t n = 0; n < NumPackets / 2; n++) {
+        CHECK(result[n] == packets[n]);
+    }
+
+    for (seqnum_t n = 0; n < NumPackets / 2; n++) {
+        packets[n] = new_packet(NumPackets + n);
+        queue.write(packets[n]);
+    }
+
+    UNSIGNED_LONGS_EQUAL(NumPackets, dr.read_many(result, NumPackets));
+
+    for (seqnum_t n = 0; n < NumPackets / 2; n++) {
+        CHECK(result[n] == packets[NumPackets / 2 + n]);
+        CHECK(result[NumPackets / 2 + n] == packets[n]);
+    }
+
+    UNSIGNED_LONGS_EQUAL(0, dr.read_many(result, NumPackets));
+}
+
 } // namespace packet
 } // namespace roc
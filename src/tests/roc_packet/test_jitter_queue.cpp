@@ -0,0 +1,339 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/heap_allocator.h"
+#include "roc_packet/jitter_queue.h"
+#include "roc_packet/packet_pool.h"
+
+namespace roc {
+namespace packet {
+
+namespace {
+
+enum { Capacity = 16 };
+
+core::HeapAllocator allocator;
+PacketPool pool(allocator, true);
+
+} // namespace
+
+TEST_GROUP(jitter_queue) {
+    PacketPtr new_packet(seqnum_t sn) {
+        PacketPtr packet = new(pool) Packet(pool);
+        CHECK(packet);
+
+        packet->add_flags(Packet::FlagRTP);
+        packet->rtp()->seqnum = sn;
+
+        return packet;
+    }
+};
+
+TEST(jitter_queue, empty) {
+    JitterQueue queue(allocator, Capacity);
+    CHECK(queue.valid());
+
+    CHECK(!queue.tail());
+    CHECK(!queue.head());
+    CHECK(!queue.latest());
+
+    CHECK(!queue.read());
+
+    LONGS_EQUAL(0, queue.size());
+}
+
+TEST(jitter_queue, two_packets) {
+    JitterQueue queue(allocator, Capacity);
+    CHECK(queue.valid());
+
+    PacketPtr p1 = new_packet(1);
+    PacketPtr p2 = new_packet(2);
+
+    queue.write(p2);
+    queue.write(p1);
+
+    LONGS_EQUAL(2, queue.size());
+
+    CHECK(queue.tail() == p2);
+    CHECK(queue.head() == p1);
+
+    CHECK(queue.read() == p1);
+
+    LONGS_EQUAL(1, queue.size());
+
+    CHECK(queue.tail() == p2);
+    CHECK(queue.head() == p2);
+
+    CHECK(queue.read() == p2);
+
+    LONGS_EQUAL(0, queue.size());
+
+    CHECK(!queue.tail());
+    CHECK(!queue.head());
+
+    CHECK(!queue.read());
+}
+
+TEST(jitter_queue, out_of_order) {
+    JitterQueue queue(allocator, Capacity);
+    CHECK(queue.valid());
+
+    const seqnum_t order[Capacity] = { 3, 1, 0, 2, 7, 5, 4, 6,
+                                       15, 8, 10, 9, 14, 11, 13, 12 };
+
+    PacketPtr packets[Capacity];
+
+    for (size_t n = 0; n < Capacity; n++) {
+        packets[order[n]] = new_packet(order[n]);
+        queue.write(packets[order[n]]);
+    }
+
+    LONGS_EQUAL(Capacity, queue.size());
+
+    CHECK(queue.head() == packets[0]);
+    CHECK(queue.tail() == packets[Capacity - 1]);
+
+    for (size_t n = 0; n < Capacity; n++) {
+        CHECK(queue.read() == packets[n]);
+    }
+
+    CHECK(!queue.read());
+}
+
+TEST(jitter_queue, gaps) {
+    JitterQueue queue(allocator, Capacity);
+    CHECK(queue.valid());
+
+    PacketPtr p1 = new_packet(1);
+    PacketPtr p5 = new_packet(5);
+    PacketPtr p9 = new_packet(9);
+
+    queue.write(p9);
+    queue.write(p1);
+    queue.write(p5);
+
+    LONGS_EQUAL(3, queue.size());
+
+    CHECK(queue.head() == p1);
+    CHECK(queue.tail() == p9);
+
+    CHECK(queue.read() == p1);
+    CHECK(queue.head() == p5);
+
+    CHECK(queue.read() == p5);
+    CHECK(queue.head() == p9);
+
+    CHECK(queue.read() == p9);
+    CHECK(!queue.head());
+
+    LONGS_EQUAL(0, queue.size());
+}
+
+TEST(jitter_queue, duplicates) {
+    JitterQueue queue(allocator, Capacity);
+    CHECK(queue.valid());
+
+    PacketPtr p1 = new_packet(1);
+    PacketPtr p2 = new_packet(2);
+
+    queue.write(p1);
+    queue.write(p2);
+    queue.write(new_packet(1));
+    queue.write(new_packet(2));
+
+    LONGS_EQUAL(2, queue.size());
+    LONGS_EQUAL(0, queue.num_dropped());
+
+    CHECK(queue.read() == p1);
+    CHECK(queue.read() == p2);
+
+    CHECK(!queue.read());
+}
+
+TEST(jitter_queue, late) {
+    JitterQueue queue(allocator, Capacity);
+    CHECK(queue.valid());
+
+    PacketPtr p3 = new_packet(3);
+    PacketPtr p4 = new_packet(4);
+
+    queue.write(p3);
+    CHECK(queue.read() == p3);
+
+    queue.write(new_packet(3));
+    queue.write(new_packet(2));
+    queue.write(p4);
+
+    LONGS_EQUAL(1, queue.size());
+
+    CHECK(queue.read() == p4);
+    CHECK(!queue.read());
+}
+
+TEST(jitter_queue, too_old) {
+    JitterQueue queue(allocator, Capacity);
+    CHECK(queue.valid());
+
+    PacketPtr p10 = new_packet(10);
+    PacketPtr p20 = new_packet(20);
+
+    queue.write(p20);
+    queue.write(p10);
+    queue.write(new_packet(4));
+
+    LONGS_EQUAL(2, queue.size());
+
+    CHECK(queue.read() == p10);
+    CHECK(queue.read() == p20);
+    CHECK(!queue.read());
+}
+
+TEST(jitter_queue, overflow) {
+    JitterQueue queue(allocator, Capacity);
+    CHECK(queue.valid());
+
+    PacketPtr packets[Capacity + 4];
+
+    for (size_t n = 0; n < Capacity + 4; n++) {
+        packets[n] = new_packet(seqnum_t(n));
+        queue.write(packets[n]);
+    }
+
+    LONGS_EQUAL(Capacity, queue.size());
+    LONGS_EQUAL(4, queue.num_dropped());
+
+    CHECK(queue.head() == packets[4]);
+    CHECK(queue.tail() == packets[Capacity + 3]);
+
+    for (size_t n = 4; n < Capacity + 4; n++) {
+        CHECK(queue.read() == packets[n]);
+    }
+
+    CHECK(!queue.read());
+}
+
+TEST(jitter_queue, overflow_jump) {
+    JitterQueue queue(allocator, Capacity);
+    CHECK(queue.valid());
+
+    PacketPtr p1 = new_packet(1);
+    PacketPtr p2 = new_packet(2);
+    PacketPtr p1000 = new_packet(1000);
+
+    queue.write(p1);
+    queue.write(p2);
+    queue.write(p1000);
+
+    LONGS_EQUAL(1, queue.size());
+    LONGS_EQUAL(2, queue.num_dropped());
+
+    CHECK(queue.head() == p1000);
+    CHECK(queue.tail() == p1000);
+
+    CHECK(queue.read() == p1000);
+    CHECK(!queue.read());
+}
+
+TEST(jitter_queue, seqnum_overflow) {
+    JitterQueue queue(allocator, Capacity);
+    CHECK(queue.valid());
+
+    const seqnum_t sn1 = seqnum_t(-1) - 2;
+    const seqnum_t sn2 = seqnum_t(-1);
+    const seqnum_t sn3 = 1;
+
+    PacketPtr p1 = new_packet(sn1);
+    PacketPtr p2 = new_packet(sn2);
+    PacketPtr p3 = new_packet(sn3);
+
+    queue.write(p3);
+    queue.write(p1);
+    queue.write(p2);
+
+    LONGS_EQUAL(3, queue.size());
+
+    CHECK(queue.head() == p1);
+    CHECK(queue.tail() == p3);
+
+    CHECK(queue.read() == p1);
+    CHECK(queue.read() == p2);
+    CHECK(queue.read() == p3);
+
+    CHECK(!queue.read());
+}
+
+TEST(jitter_queue, latest) {
+    JitterQueue queue(allocator, Capacity);
+    CHECK(queue.valid());
+
+    PacketPtr p1 = new_packet(1);
+    PacketPtr p2 = new_packet(2);
+    PacketPtr p3 = new_packet(3);
+
+    queue.write(p2);
+    CHECK(queue.latest() == p2);
+
+    queue.write(p1);
+    CHECK(queue.latest() == p2);
+
+    CHECK(queue.read() == p1);
+    CHECK(queue.read() == p2);
+    CHECK(queue.latest() == p2);
+
+    queue.write(p3);
+    CHECK(queue.latest() == p3);
+}
+
+TEST(jitter_queue, no_rtp) {
+    JitterQueue queue(allocator, Capacity);
+    CHECK(queue.valid());
+
+    PacketPtr packet = new(pool) Packet(pool);
+    CHECK(packet);
+
+    queue.write(packet);
+
+    LONGS_EQUAL(0, queue.size());
+    CHECK(!queue.read());
+}
+
+TEST(jitter_queue, reset) {
+    JitterQueue queue(allocator, Capacity);
+    CHECK(queue.valid());
+
+    PacketPtr p1 = new_packet(1);
+    PacketPtr p2 = new_packet(2);
+    PacketPtr p3 = new_packet(3);
+
+    queue.write(p2);
+    queue.write(p3);
+    CHECK(queue.read() == p2);
+
+    queue.write(new_packet(Capacity + 3));
+    LONGS_EQUAL(1, queue.num_dropped());
+
+    queue.reset();
+
+    LONGS_EQUAL(0, queue.size());
+    LONGS_EQUAL(0, queue.num_dropped());
+
+    CHECK(!queue.head());
+    CHECK(!queue.tail());
+    CHECK(!queue.latest());
+    CHECK(!queue.read());
+
+    queue.write(p1);
+
+    LONGS_EQUAL(1, queue.size());
+    CHECK(queue.read() == p1);
+}
+
+} // namespace packet
+} // namespace roc
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/heap_allocator.h"
+#include "roc_packet/packet_pool.h"
+#include "roc_packet/queue.h"
+
+namespace roc {
+namespace packet {
+
+namespace {
+
+enum { NumPackets = 10, MaxSize = 4 };
+
+core::HeapAllocator allocator;
+PacketPool pool(allocator, true);
+
+} // namespace
+
+TEST_GROUP(queue) {
+    PacketPtr new_packet() {
+        PacketPtr packet = new(pool) Packet(pool);
+        CHECK(packet);
+        return packet;
+    }
+};
+
+TEST(queue, empty) {
+    Queue queue;
+
+    CHECK(!queue.read());
+    LONGS_EQUAL(0, queue.size());
+}
+
+TEST(queue, fifo) {
+    Queue queue;
+
+    PacketPtr packets[NumPackets];
+
+    for (size_t n = 0; n < NumPackets; n++) {
+        packets[n] = new_packet();
+        queue.write(packets[n]);
+    }
+
+    LONGS_EQUAL(NumPackets, queue.size());
+    LONGS_EQUAL(0, queue.num_dropped());
+
+    for (size_t n = 0; n < NumPackets; n++) {
+        CHECK(queue.read() == packets[n]);
+    }
+
+    CHECK(!queue.read());
+}
+
+TEST(queue, max_size) {
+    Queue queue(MaxSize);
+
+    PacketPtr packets[NumPackets];
+
+    for (size_t n = 0; n < NumPackets; n++) {
+        packets[n] = new_packet();
+        queue.write(packets[n]);
+    }
+
+    LONGS_EQUAL(MaxSize, queue.size());
+    LONGS_EQUAL(NumPackets - MaxSize, queue.num_dropped());
+
+    for (size_t n = NumPackets - MaxSize; n < NumPackets; n++) {
+        CHECK(queue.read() == packets[n]);
+    }
+
+    CHECK(!queue.read());
+}
+
+TEST(queue, max_size_write_many) {
+    Queue queue(MaxSize);
+
+    PacketPtr packets[NumPackets];
+
+    for (size_t n = 0; n < NumPackets; n++) {
+        packets[n] = new_packet();
+    }
+
+    queue.write_many(packets, NumPackets);
+
+    LONGS_EQUAL(MaxSize, queue.size());
+    LONGS_EQUAL(NumPackets - MaxSize, queue.num_dropped());
+
+    PacketPtr result[NumPackets];
+    LONGS_EQUAL(MaxSize, queue.read_many(result, NumPackets));
+
+    for (size_t n = 0; n < MaxSize; n++) {
+        CHECK(result[n] == packets[NumPackets - MaxSize + n]);
+    }
+}
+
+TEST(queue, reset) {
+    Queue queue(MaxSize);
+
+    for (size_t n = 0; n < NumPackets; n++) {
+        queue.write(new_packet());
+    }
+
+    queue.reset();
+
+    LONGS_EQUAL(0, queue.size());
+    LONGS_EQUAL(0, queue.num_dropped());
+    CHECK(!queue.read());
+}
+
+} // namespace packet
+} // namespace roc
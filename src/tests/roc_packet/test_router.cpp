@@ -9,6 +9,7 @@
 #include <CppUTest/TestHarness.h>
 
 #include "roc_core/heap_allocator.h"
+#include "roc_core/helpers.h"
 #include "roc_packet/packet_pool.h"
 #include "roc_packet/queue.h"
 #include "roc_packet/router.h"
@@ -184,5 +185,59 @@ TEST(router, different_routes_different_sources) {
     UNSIGNED_LONGS_EQUAL(1, queue_f.size());
 }
 
+TEST(router, reset) {
+    Router router(allocator, MaxRoutes);
+
+    CHECK(router.valid());
+
+    Queue queue;
+    CHECK(router.add_route(queue, Packet::FlagAudio));
+
+    router.write(new_packet(11, Packet::FlagAudio));
+    UNSIGNED_LONGS_EQUAL(1, queue.size());
+
+    router.reset();
+
+    router.write(new_packet(22, Packet::FlagAudio));
+    UNSIGNED_LONGS_EQUAL(2, queue.size());
+
+    router.write(new_packet(11, Packet::FlagAudio));
+    UNSIGNED_LONGS_EQUAL(2, queue.size());
+}
+
+TEST(router, write_many) {
+    Router router(allocator, MaxRoutes);
+
+    CHECK(router.valid());
+
+    Queue queue_a;
+    CHECK(router.add_route(queue_a, Packet::FlagAudio));
+
+    Queue queue_f;
+    CHECK(router.add_route(queue_f, Packet::FlagFEC));
+
+    PacketPtr packets[] = {
+        new_packet(11, Packet::FlagAudio), new_packet(11, Packet::FlagAudio),
+        new_packet(22, Packet::FlagFEC),   new_packet(11, Packet::FlagAudio),
+        new_packet(22, Packet::FlagFEC),   new_packet(33, Packet::FlagAudio),
+    };
+
+    router.write_many(packets, ROC_ARRAY_SIZE(packets));
+
+    UNSIGNED_LONGS_EQUAL(3, queue_a.size());
+    UNSIGNED_LONGS_EQUAL(2, queue_f.size());
+
+    CHECK(queue_a.read() == packets[0]);
+    CHECK(queue_a.read() == packets[1]);
+    CHECK(queue_a.read() == packets[3]);
+    CHECK(!queue_a.read());
+
+    CHECK(queue_f.read() == packets[2]);
+    CHECK(queue_f.read() == packets[4]);
+    CHECK(!queue_f.read());
+
+    LONGS_EQUAL(1, packets[5]->getref());
+}
+
 } // namespace packet
 } // namespace roc
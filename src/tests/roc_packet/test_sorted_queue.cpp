@@ -393,5 +393,33 @@ TEST(sorted_queue, latest) {
     CHECK(queue.latest() == p4);
 }
 
+TEST(sorted_queue, reset) {
+    SortedQueue queue(0);
+
+    PacketPtr p1 = new_packet(1);
+    PacketPtr p2 = new_packet(2);
+
+    queue.write(p2);
+    queue.write(p1);
+
+    LONGS_EQUAL(2, queue.size());
+    CHECK(queue.latest() == p2);
+
+    queue.reset();
+
+    LONGS_EQUAL(0, queue.size());
+    CHECK(!queue.head());
+    CHECK(!queue.tail());
+    CHECK(!queue.latest());
+
+    LONGS_EQUAL(1, p1->getref());
+    LONGS_EQUAL(1, p2->getref());
+
+    queue.write(p1);
+
+    LONGS_EQUAL(1, queue.size());
+    CHECK(queue.read() == p1);
+}
+
 } // namespace packet
 } // namespace roc
@@ -14,6 +14,7 @@
 #include "roc_audio/iframe_encoder.h"
 #include "roc_core/buffer_pool.h"
 #include "roc_core/noncopyable.h"
+#include "roc_core/time.h"
 #include "roc_core/unique_ptr.h"
 #include "roc_packet/icomposer.h"
 #include "roc_packet/iwriter.h"
@@ -48,7 +49,8 @@ public:
         , timestamp_(0)
         , pt_(pt)
         , offset_(0)
-        , corrupt_(false) {
+        , corrupt_(false)
+        , receive_timestamp_(0) {
     }
 
     void write_packets(size_t num_packets,
@@ -98,6 +100,10 @@ public:
         corrupt_ = corrupt;
     }
 
+    void set_receive_timestamp(core::nanoseconds_t receive_timestamp) {
+        receive_timestamp_ = receive_timestamp;
+    }
+
 private:
     enum { MaxSamples = 4096 };
 
@@ -110,6 +116,7 @@ private:
 
         pp->udp()->src_addr = src_addr_;
         pp->udp()->dst_addr = dst_addr_;
+        pp->udp()->receive_timestamp = receive_timestamp_;
 
         pp->set_data(new_buffer_(samples_per_packet, channels));
 
@@ -181,6 +188,8 @@ private:
     uint8_t offset_;
 
     bool corrupt_;
+
+    core::nanoseconds_t receive_timestamp_;
 };
 
 } // namespace pipeline
@@ -11,8 +11,10 @@
 #include "roc_audio/pcm_funcs.h"
 #include "roc_core/buffer_pool.h"
 #include "roc_core/heap_allocator.h"
+#include "roc_core/thread.h"
 #include "roc_fec/codec_map.h"
 #include "roc_packet/packet_pool.h"
+#include "roc_packet/queue.h"
 #include "roc_pipeline/receiver.h"
 #include "roc_rtp/composer.h"
 #include "roc_rtp/format_map.h"
@@ -56,6 +58,24 @@ fec::CodecMap codec_map;
 rtp::FormatMap format_map;
 rtp::Composer rtp_composer(NULL);
 
+class WriterThread : public core::Thread {
+public:
+    WriterThread(PacketWriter& writer, size_t num_packets)
+        : writer_(writer)
+        , num_packets_(num_packets) {
+    }
+
+private:
+    virtual void run() {
+        for (size_t np = 0; np < num_packets_; np++) {
+            writer_.write_packets(1, SamplesPerPacket, ChMask);
+        }
+    }
+
+    PacketWriter& writer_;
+    size_t num_packets_;
+};
+
 } // namespace
 
 TEST_GROUP(receiver) {
@@ -142,6 +162,45 @@ TEST(receiver, no_ports) {
     }
 }
 
+TEST(receiver, many_ports) {
+    enum { NumPorts = 40, FirstPort = 100 };
+
+    // sessions are created when packets are written
+    config.common.route_on_write = true;
+
+    Receiver receiver(config, codec_map, format_map, packet_pool, byte_buffer_pool,
+                      sample_buffer_pool, allocator);
+
+    CHECK(receiver.valid());
+
+    for (size_t np = 0; np < NumPorts; np++) {
+        PortConfig port;
+        port.address = new_address(FirstPort + (int)np);
+        port.protocol = Proto_RTP;
+
+        CHECK(receiver.add_port(port));
+        CHECK(!receiver.add_port(port));
+    }
+
+    for (size_t np = 0; np < NumPorts; np++) {
+        PacketWriter packet_writer(allocator, receiver, rtp_composer, format_map,
+                                   packet_pool, byte_buffer_pool, PayloadType,
+                                   new_address(FirstPort + NumPorts + (int)np),
+                                   new_address(FirstPort + (int)np));
+
+        packet_writer.write_packets(1, SamplesPerPacket, ChMask);
+
+        UNSIGNED_LONGS_EQUAL(np + 1, receiver.num_sessions());
+    }
+
+    PacketWriter packet_writer(allocator, receiver, rtp_composer, format_map, packet_pool,
+                               byte_buffer_pool, PayloadType, src1, port1.address);
+
+    packet_writer.write_packets(1, SamplesPerPacket, ChMask);
+
+    UNSIGNED_LONGS_EQUAL(NumPorts, receiver.num_sessions());
+}
+
 TEST(receiver, one_session) {
     Receiver receiver(config, codec_map, format_map, packet_pool, byte_buffer_pool,
                       sample_buffer_pool, allocator);
@@ -310,6 +369,432 @@ TEST(receiver, initial_trim) {
     }
 }
 
+TEST(receiver, max_queued_packets) {
+    enum { MaxQueued = Latency / SamplesPerPacket };
+
+    config.common.max_queued_packets = MaxQueued;
+
+    Receiver receiver(config, codec_map, format_map, packet_pool, byte_buffer_pool,
+                      sample_buffer_pool, allocator);
+
+    CHECK(receiver.valid());
+    CHECK(receiver.add_port(port1));
+
+    FrameReader frame_reader(receiver, sample_buffer_pool);
+
+    PacketWriter packet_writer(allocator, receiver, rtp_composer, format_map, packet_pool,
+                               byte_buffer_pool, PayloadType, src1, port1.address);
+
+    packet_writer.write_packets(MaxQueued * 3, SamplesPerPacket, ChMask);
+
+    UNSIGNED_LONGS_EQUAL(MaxQueued * 2, receiver.stats().num_ingress_dropped);
+
+    for (size_t np = 0; np < MaxQueued; np++) {
+        for (size_t nf = 0; nf < FramesPerPacket; nf++) {
+            frame_reader.read_samples(SamplesPerFrame * NumCh, 1);
+
+            UNSIGNED_LONGS_EQUAL(1, receiver.num_sessions());
+        }
+    }
+
+    UNSIGNED_LONGS_EQUAL(MaxQueued * 2, receiver.stats().num_ingress_dropped);
+    UNSIGNED_LONGS_EQUAL(0, receiver.stats().num_repair_shed);
+    UNSIGNED_LONGS_EQUAL(0, receiver.stats().num_session_dropped);
+}
+
+TEST(receiver, session_jitter) {
+    Receiver receiver(config, codec_map, format_map, packet_pool, byte_buffer_pool,
+                      sample_buffer_pool, allocator);
+
+    CHECK(receiver.valid());
+    CHECK(receiver.add_port(port1));
+
+    PacketWriter packet_writer(allocator, receiver, rtp_composer, format_map, packet_pool,
+                               byte_buffer_pool, PayloadType, src1, port1.address);
+
+    core::Slice<audio::sample_t> samples(
+        new (sample_buffer_pool) core::Buffer<audio::sample_t>(sample_buffer_pool));
+
+    CHECK(samples);
+    samples.resize(SamplesPerFrame * NumCh);
+
+    const core::nanoseconds_t packet_duration =
+        packet::timestamp_to_ns(SamplesPerPacket, SampleRate);
+
+    const core::nanoseconds_t delay = 16 * core::Millisecond;
+
+    core::nanoseconds_t receive_timestamp = core::Second;
+
+    // packets without arrival timestamps are not measured
+    packet_writer.write_packets(1, SamplesPerPacket, ChMask);
+    {
+        audio::Frame frame(samples.data(), samples.size());
+        receiver.read(frame);
+    }
+
+    LONGS_EQUAL(0, receiver.stats().max_session_jitter);
+
+    // packets arrive exactly according to their timestamps
+    for (size_t np = 0; np < Latency / SamplesPerPacket; np++) {
+        packet_writer.set_receive_timestamp(receive_timestamp);
+        packet_writer.write_packets(1, SamplesPerPacket, ChMask);
+        receive_timestamp += packet_duration;
+    }
+    {
+        audio::Frame frame(samples.data(), samples.size());
+        receiver.read(frame);
+    }
+
+    UNSIGNED_LONGS_EQUAL(1, receiver.num_sessions());
+    LONGS_EQUAL(0, receiver.stats().max_session_jitter);
+
+    // one packet is delayed
+    packet_writer.set_receive_timestamp(receive_timestamp + delay);
+    packet_writer.write_packets(1, SamplesPerPacket, ChMask);
+    {
+        audio::Frame frame(samples.data(), samples.size());
+        receiver.read(frame);
+    }
+
+    LONGS_EQUAL(delay / 16, receiver.stats().max_session_jitter);
+}
+
+TEST(receiver, route_on_write) {
+    config.common.route_on_write = true;
+
+    Receiver receiver(config, codec_map, format_map, packet_pool, byte_buffer_pool,
+                      sample_buffer_pool, allocator);
+
+    CHECK(receiver.valid());
+    CHECK(receiver.add_port(port1));
+
+    FrameReader frame_reader(receiver, sample_buffer_pool);
+
+    PacketWriter packet_writer(allocator, receiver, rtp_composer, format_map, packet_pool,
+                               byte_buffer_pool, PayloadType, src1, port1.address);
+
+    CHECK(receiver.state() == sndio::ISource::Inactive);
+    UNSIGNED_LONGS_EQUAL(0, receiver.num_sessions());
+
+    packet_writer.write_packets(Latency / SamplesPerPacket, SamplesPerPacket, ChMask);
+
+    CHECK(receiver.state() == sndio::ISource::Active);
+    UNSIGNED_LONGS_EQUAL(1, receiver.num_sessions());
+
+    for (size_t np = 0; np < ManyPackets; np++) {
+        for (size_t nf = 0; nf < FramesPerPacket; nf++) {
+            frame_reader.read_samples(SamplesPerFrame * NumCh, 1);
+
+            UNSIGNED_LONGS_EQUAL(1, receiver.num_sessions());
+        }
+
+        packet_writer.write_packets(1, SamplesPerPacket, ChMask);
+    }
+}
+
+TEST(receiver, route_on_write_max_queued_packets) {
+    enum { MaxQueued = Latency / SamplesPerPacket };
+
+    config.common.route_on_write = true;
+    config.common.max_queued_packets = MaxQueued;
+
+    Receiver receiver(config, codec_map, format_map, packet_pool, byte_buffer_pool,
+                      sample_buffer_pool, allocator);
+
+    CHECK(receiver.valid());
+    CHECK(receiver.add_port(port1));
+
+    FrameReader frame_reader(receiver, sample_buffer_pool);
+
+    PacketWriter packet_writer(allocator, receiver, rtp_composer, format_map, packet_pool,
+                               byte_buffer_pool, PayloadType, src1, port1.address);
+
+    packet_writer.write_packets(MaxQueued * 3, SamplesPerPacket, ChMask);
+
+    UNSIGNED_LONGS_EQUAL(MaxQueued * 2, receiver.stats().num_ingress_dropped);
+
+    for (size_t np = 0; np < MaxQueued; np++) {
+        for (size_t nf = 0; nf < FramesPerPacket; nf++) {
+            frame_reader.read_samples(SamplesPerFrame * NumCh, 1);
+
+            UNSIGNED_LONGS_EQUAL(1, receiver.num_sessions());
+        }
+    }
+
+    UNSIGNED_LONGS_EQUAL(MaxQueued * 2, receiver.stats().num_ingress_dropped);
+}
+
+TEST(receiver, route_on_write_concurrent_writers) {
+    config.common.route_on_write = true;
+
+    // writers build new sessions without the lock instead of reusing idle ones
+    config.common.session_pool_size = 0;
+
+    Receiver receiver(config, codec_map, format_map, packet_pool, byte_buffer_pool,
+                      sample_buffer_pool, allocator);
+
+    CHECK(receiver.valid());
+    CHECK(receiver.add_port(port1));
+
+    FrameReader frame_reader(receiver, sample_buffer_pool);
+
+    PacketWriter packet_writer1(allocator, receiver, rtp_composer, format_map,
+                                packet_pool, byte_buffer_pool, PayloadType, src1,
+                                port1.address);
+
+    PacketWriter packet_writer2(allocator, receiver, rtp_composer, format_map,
+                                packet_pool, byte_buffer_pool, PayloadType, src2,
+                                port1.address);
+
+    WriterThread writer_thread1(packet_writer1, Latency / SamplesPerPacket);
+    WriterThread writer_thread2(packet_writer2, Latency / SamplesPerPacket);
+
+    CHECK(writer_thread1.start());
+    CHECK(writer_thread2.start());
+
+    writer_thread1.join();
+    writer_thread2.join();
+
+    CHECK(receiver.state() == sndio::ISource::Active);
+    UNSIGNED_LONGS_EQUAL(2, receiver.num_sessions());
+
+    for (size_t np = 0; np < ManyPackets; np++) {
+        for (size_t nf = 0; nf < FramesPerPacket; nf++) {
+            frame_reader.read_samples(SamplesPerFrame * NumCh, 2);
+
+            UNSIGNED_LONGS_EQUAL(2, receiver.num_sessions());
+        }
+
+        packet_writer1.write_packets(1, SamplesPerPacket, ChMask);
+        packet_writer2.write_packets(1, SamplesPerPacket, ChMask);
+    }
+
+    UNSIGNED_LONGS_EQUAL(0, receiver.stats().num_session_dropped);
+}
+
+TEST(receiver, write_many) {
+    enum { MaxQueued = Latency / SamplesPerPacket, NumPackets = MaxQueued * 3 };
+
+    config.common.max_queued_packets = MaxQueued;
+
+    Receiver receiver(config, codec_map, format_map, packet_pool, byte_buffer_pool,
+                      sample_buffer_pool, allocator);
+
+    CHECK(receiver.valid());
+    CHECK(receiver.add_port(port1));
+
+    FrameReader frame_reader(receiver, sample_buffer_pool);
+
+    packet::Queue queue;
+
+    PacketWriter packet_writer(allocator, queue, rtp_composer, format_map, packet_pool,
+                               byte_buffer_pool, PayloadType, src1, port1.address);
+
+    packet_writer.write_packets(NumPackets, SamplesPerPacket, ChMask);
+
+    packet::PacketPtr packets[NumPackets];
+    UNSIGNED_LONGS_EQUAL(NumPackets, queue.read_many(packets, NumPackets));
+
+    receiver.write_many(packets, NumPackets);
+
+    UNSIGNED_LONGS_EQUAL(MaxQueued * 2, receiver.stats().num_ingress_dropped);
+
+    for (size_t np = 0; np < MaxQueued; np++) {
+        for (size_t nf = 0; nf < FramesPerPacket; nf++) {
+            frame_reader.read_samples(SamplesPerFrame * NumCh, 1);
+
+            UNSIGNED_LONGS_EQUAL(1, receiver.num_sessions());
+        }
+    }
+}
+
+TEST(receiver, session_pool) {
+    Receiver receiver(config, codec_map, format_map, packet_pool, byte_buffer_pool,
+                      sample_buffer_pool, allocator);
+
+    CHECK(receiver.valid());
+
+    UNSIGNED_LONGS_EQUAL(0, receiver.num_idle_sessions());
+
+    CHECK(receiver.add_port(port1));
+
+    const size_t pool_size = config.common.session_pool_size;
+
+    CHECK(pool_size != 0);
+    UNSIGNED_LONGS_EQUAL(pool_size, receiver.num_idle_sessions());
+
+    FrameReader frame_reader(receiver, sample_buffer_pool);
+
+    PacketWriter packet_writer(allocator, receiver, rtp_composer, format_map, packet_pool,
+                               byte_buffer_pool, PayloadType, src1, port1.address);
+
+    packet_writer.write_packets(Latency / SamplesPerPacket, SamplesPerPacket, ChMask);
+
+    for (size_t np = 0; np < Latency / SamplesPerPacket; np++) {
+        for (size_t nf = 0; nf < FramesPerPacket; nf++) {
+            frame_reader.read_samples(SamplesPerFrame * NumCh, 1);
+        }
+
+        UNSIGNED_LONGS_EQUAL(1, receiver.num_sessions());
+        UNSIGNED_LONGS_EQUAL(pool_size - 1, receiver.num_idle_sessions());
+    }
+
+    while (receiver.num_sessions() != 0) {
+        frame_reader.skip_zeros(SamplesPerFrame * NumCh);
+    }
+
+    UNSIGNED_LONGS_EQUAL(pool_size, receiver.num_idle_sessions());
+}
+
+TEST(receiver, session_pool_same_fec_scheme) {
+    Receiver receiver(config, codec_map, format_map, packet_pool, byte_buffer_pool,
+                      sample_buffer_pool, allocator);
+
+    CHECK(receiver.valid());
+
+    const size_t pool_size = config.common.session_pool_size;
+
+    CHECK(receiver.add_port(port1));
+    UNSIGNED_LONGS_EQUAL(pool_size, receiver.num_idle_sessions());
+
+    CHECK(receiver.add_port(port2));
+    UNSIGNED_LONGS_EQUAL(pool_size, receiver.num_idle_sessions());
+}
+
+#ifdef ROC_TARGET_OPENFEC
+TEST(receiver, session_pool_per_fec_scheme) {
+    Receiver receiver(config, codec_map, format_map, packet_pool, byte_buffer_pool,
+                      sample_buffer_pool, allocator);
+
+    CHECK(receiver.valid());
+
+    const size_t pool_size = config.common.session_pool_size;
+
+    CHECK(receiver.add_port(port1));
+    UNSIGNED_LONGS_EQUAL(pool_size, receiver.num_idle_sessions());
+
+    PortConfig fec_port;
+    fec_port.address = new_address(5);
+    fec_port.protocol = Proto_RTP_RSm8_Source;
+
+    CHECK(receiver.add_port(fec_port));
+    UNSIGNED_LONGS_EQUAL(pool_size * 2, receiver.num_idle_sessions());
+
+    FrameReader frame_reader(receiver, sample_buffer_pool);
+
+    PacketWriter packet_writer(allocator, receiver, rtp_composer, format_map, packet_pool,
+                               byte_buffer_pool, PayloadType, src1, port1.address);
+
+    packet_writer.write_packets(Latency / SamplesPerPacket, SamplesPerPacket, ChMask);
+
+    for (size_t np = 0; np < Latency / SamplesPerPacket; np++) {
+        for (size_t nf = 0; nf < FramesPerPacket; nf++) {
+            frame_reader.read_samples(SamplesPerFrame * NumCh, 1);
+        }
+
+        UNSIGNED_LONGS_EQUAL(1, receiver.num_sessions());
+        UNSIGNED_LONGS_EQUAL(pool_size * 2 - 1, receiver.num_idle_sessions());
+    }
+
+    while (receiver.num_sessions() != 0) {
+        frame_reader.skip_zeros(SamplesPerFrame * NumCh);
+    }
+
+    UNSIGNED_LONGS_EQUAL(pool_size * 2, receiver.num_idle_sessions());
+}
+#endif //! ROC_TARGET_OPENFEC
+
+TEST(receiver, session_pool_disabled) {
+    config.common.session_pool_size = 0;
+
+    Receiver receiver(config, codec_map, format_map, packet_pool, byte_buffer_pool,
+                      sample_buffer_pool, allocator);
+
+    CHECK(receiver.valid());
+    CHECK(receiver.add_port(port1));
+
+    UNSIGNED_LONGS_EQUAL(0, receiver.num_idle_sessions());
+
+    FrameReader frame_reader(receiver, sample_buffer_pool);
+
+    PacketWriter packet_writer(allocator, receiver, rtp_composer, format_map, packet_pool,
+                               byte_buffer_pool, PayloadType, src1, port1.address);
+
+    packet_writer.write_packets(Latency / SamplesPerPacket, SamplesPerPacket, ChMask);
+
+    for (size_t np = 0; np < Latency / SamplesPerPacket; np++) {
+        for (size_t nf = 0; nf < FramesPerPacket; nf++) {
+            frame_reader.read_samples(SamplesPerFrame * NumCh, 1);
+        }
+
+        UNSIGNED_LONGS_EQUAL(1, receiver.num_sessions());
+    }
+
+    while (receiver.num_sessions() != 0) {
+        frame_reader.skip_zeros(SamplesPerFrame * NumCh);
+    }
+
+    UNSIGNED_LONGS_EQUAL(0, receiver.num_idle_sessions());
+}
+
+TEST(receiver, session_reuse) {
+    config.common.session_pool_size = 1;
+
+    Receiver receiver(config, codec_map, format_map, packet_pool, byte_buffer_pool,
+                      sample_buffer_pool, allocator);
+
+    CHECK(receiver.valid());
+    CHECK(receiver.add_port(port1));
+
+    FrameReader frame_reader(receiver, sample_buffer_pool);
+
+    PacketWriter packet_writer1(allocator, receiver, rtp_composer, format_map,
+                                packet_pool, byte_buffer_pool, PayloadType, src1,
+                                port1.address);
+
+    packet_writer1.set_source(11);
+    packet_writer1.write_packets(Latency / SamplesPerPacket, SamplesPerPacket, ChMask);
+
+    for (size_t np = 0; np < Latency / SamplesPerPacket; np++) {
+        for (size_t nf = 0; nf < FramesPerPacket; nf++) {
+            frame_reader.read_samples(SamplesPerFrame * NumCh, 1);
+        }
+
+        UNSIGNED_LONGS_EQUAL(1, receiver.num_sessions());
+        UNSIGNED_LONGS_EQUAL(0, receiver.num_idle_sessions());
+    }
+
+    while (receiver.num_sessions() != 0) {
+        frame_reader.skip_zeros(SamplesPerFrame * NumCh);
+    }
+
+    UNSIGNED_LONGS_EQUAL(1, receiver.num_idle_sessions());
+
+    PacketWriter packet_writer2(allocator, receiver, rtp_composer, format_map,
+                                packet_pool, byte_buffer_pool, PayloadType, src2,
+                                port1.address);
+
+    packet_writer2.set_source(22);
+    packet_writer2.set_seqnum(5000);
+    packet_writer2.set_timestamp(700000);
+    packet_writer2.set_offset(77);
+
+    packet_writer2.write_packets(Latency / SamplesPerPacket, SamplesPerPacket, ChMask);
+
+    frame_reader.set_offset(77);
+
+    for (size_t np = 0; np < ManyPackets; np++) {
+        for (size_t nf = 0; nf < FramesPerPacket; nf++) {
+            frame_reader.read_samples(SamplesPerFrame * NumCh, 1);
+
+            UNSIGNED_LONGS_EQUAL(1, receiver.num_sessions());
+            UNSIGNED_LONGS_EQUAL(0, receiver.num_idle_sessions());
+        }
+
+        packet_writer2.write_packets(1, SamplesPerPacket, ChMask);
+    }
+}
+
 TEST(receiver, two_sessions_synchronous) {
     Receiver receiver(config, codec_map, format_map, packet_pool, byte_buffer_pool,
                       sample_buffer_pool, allocator);
@@ -344,6 +829,39 @@ TEST(receiver, two_sessions_synchronous) {
     }
 }
 
+TEST(receiver, many_sessions) {
+    enum { NumSessions = 40, FirstPort = 100 };
+
+    // sessions are created when packets are written
+    config.common.route_on_write = true;
+
+    Receiver receiver(config, codec_map, format_map, packet_pool, byte_buffer_pool,
+                      sample_buffer_pool, allocator);
+
+    CHECK(receiver.valid());
+    CHECK(receiver.add_port(port1));
+
+    for (size_t ns = 0; ns < NumSessions; ns++) {
+        PacketWriter packet_writer(allocator, receiver, rtp_composer, format_map,
+                                   packet_pool, byte_buffer_pool, PayloadType,
+                                   new_address(FirstPort + (int)ns), port1.address);
+
+        packet_writer.write_packets(1, SamplesPerPacket, ChMask);
+
+        UNSIGNED_LONGS_EQUAL(ns + 1, receiver.num_sessions());
+    }
+
+    for (size_t ns = 0; ns < NumSessions; ns++) {
+        PacketWriter packet_writer(allocator, receiver, rtp_composer, format_map,
+                                   packet_pool, byte_buffer_pool, PayloadType,
+                                   new_address(FirstPort + (int)ns), port1.address);
+
+        packet_writer.write_packets(1, SamplesPerPacket, ChMask);
+
+        UNSIGNED_LONGS_EQUAL(NumSessions, receiver.num_sessions());
+    }
+}
+
 TEST(receiver, two_sessions_overlapping) {
     Receiver receiver(config, codec_map, format_map, packet_pool, byte_buffer_pool,
                       sample_buffer_pool, allocator);
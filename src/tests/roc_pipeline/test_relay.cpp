@@ -0,0 +1,412 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/buffer_pool.h"
+#include "roc_core/heap_allocator.h"
+#include "roc_packet/packet_pool.h"
+#include "roc_packet/queue.h"
+#include "roc_pipeline/relay.h"
+#include "roc_rtp/composer.h"
+#include "roc_rtp/format_map.h"
+
+#include "test_packet_writer.h"
+
+namespace roc {
+namespace pipeline {
+
+namespace {
+
+const rtp::PayloadType PayloadType = rtp::PayloadType_L16_Stereo;
+
+enum {
+    MaxBufSize = 500,
+
+    ChMask = 0x3,
+    SamplesPerPacket = 100,
+
+    NumPackets = 10,
+    NumDestinations = 3,
+
+    MaxSnJump = 50
+};
+
+core::HeapAllocator allocator;
+core::BufferPool<uint8_t> byte_buffer_pool(allocator, MaxBufSize, true);
+packet::PacketPool packet_pool(allocator, true);
+
+rtp::FormatMap format_map;
+rtp::Composer rtp_composer(NULL);
+
+class CountingQueue : public packet::Queue {
+public:
+    CountingQueue()
+        : num_batches_(0) {
+    }
+
+    size_t num_batches() const {
+        return num_batches_;
+    }
+
+    virtual void write_many(const packet::PacketPtr* packets, size_t n_packets) {
+        num_batches_++;
+        packet::Queue::write_many(packets, n_packets);
+    }
+
+private:
+    size_t num_batches_;
+};
+
+void write_packets(Relay& relay, packet::Queue& input, packet::Queue& written) {
+    while (packet::PacketPtr pp = input.read()) {
+        written.write(pp);
+        relay.write(pp);
+    }
+}
+
+void check_forwarded(packet::Queue& written,
+                     packet::Queue& output,
+                     const packet::Address& dst_addr) {
+    UNSIGNED_LONGS_EQUAL(written.size(), output.size());
+
+    packet::Queue tmp;
+
+    while (packet::PacketPtr wp = written.read()) {
+        packet::PacketPtr op = output.read();
+        CHECK(op);
+
+        CHECK(op != wp);
+        CHECK(op->udp());
+        CHECK(op->udp()->dst_addr == dst_addr);
+        CHECK(op->flags() & packet::Packet::FlagComposed);
+
+        // forwarded packet shares the buffer of the received packet
+        CHECK(op->data().data() == wp->data().data());
+        UNSIGNED_LONGS_EQUAL(wp->data().size(), op->data().size());
+
+        tmp.write(wp);
+    }
+
+    while (packet::PacketPtr wp = tmp.read()) {
+        written.write(wp);
+    }
+}
+
+} // namespace
+
+TEST_GROUP(relay) {
+    RelayConfig config;
+
+    packet::Address src1;
+    packet::Address src2;
+
+    PortConfig port1;
+    PortConfig port2;
+
+    packet::Address dst[NumDestinations];
+
+    void setup() {
+        config.rtp_validator.max_sn_jump = MaxSnJump;
+
+        src1 = new_address(1);
+        src2 = new_address(2);
+
+        port1.address = new_address(3);
+        port1.protocol = Proto_RTP;
+
+        port2.address = new_address(4);
+        port2.protocol = Proto_RTP;
+
+        for (size_t n = 0; n < NumDestinations; n++) {
+            dst[n] = new_address(10 + (int)n);
+        }
+    }
+};
+
+TEST(relay, no_ports) {
+    Relay relay(config, format_map, packet_pool, allocator);
+
+    packet::Queue input;
+    packet::Queue written;
+
+    PacketWriter packet_writer(allocator, input, rtp_composer, format_map, packet_pool,
+                               byte_buffer_pool, PayloadType, src1, port1.address);
+
+    packet_writer.write_packets(NumPackets, SamplesPerPacket, ChMask);
+    write_packets(relay, input, written);
+
+    UNSIGNED_LONGS_EQUAL(0, relay.num_streams());
+
+    UNSIGNED_LONGS_EQUAL(NumPackets, relay.stats().num_received);
+    UNSIGNED_LONGS_EQUAL(0, relay.stats().num_forwarded);
+    UNSIGNED_LONGS_EQUAL(NumPackets, relay.stats().num_dropped);
+}
+
+TEST(relay, duplicate_port) {
+    Relay relay(config, format_map, packet_pool, allocator);
+
+    CHECK(relay.add_port(port1));
+    CHECK(!relay.add_port(port1));
+
+    packet::Queue output;
+    CHECK(!relay.add_destination(port2.address, dst[0], output));
+}
+
+TEST(relay, one_destination) {
+    Relay relay(config, format_map, packet_pool, allocator);
+
+    CHECK(relay.add_port(port1));
+
+    packet::Queue output;
+    CHECK(relay.add_destination(port1.address, dst[0], output));
+
+    packet::Queue input;
+    packet::Queue written;
+
+    PacketWriter packet_writer(allocator, input, rtp_composer, format_map, packet_pool,
+                               byte_buffer_pool, PayloadType, src1, port1.address);
+
+    packet_writer.write_packets(NumPackets, SamplesPerPacket, ChMask);
+    write_packets(relay, input, written);
+
+    UNSIGNED_LONGS_EQUAL(1, relay.num_streams());
+
+    check_forwarded(written, output, dst[0]);
+
+    UNSIGNED_LONGS_EQUAL(NumPackets, relay.stats().num_received);
+    UNSIGNED_LONGS_EQUAL(NumPackets, relay.stats().num_forwarded);
+    UNSIGNED_LONGS_EQUAL(0, relay.stats().num_dropped);
+}
+
+TEST(relay, many_destinations) {
+    Relay relay(config, format_map, packet_pool, allocator);
+
+    CHECK(relay.add_port(port1));
+
+    packet::Queue output[NumDestinations];
+    for (size_t n = 0; n < NumDestinations; n++) {
+        CHECK(relay.add_destination(port1.address, dst[n], output[n]));
+    }
+
+    packet::Queue input;
+    packet::Queue written;
+
+    PacketWriter packet_writer(allocator, input, rtp_composer, format_map, packet_pool,
+                               byte_buffer_pool, PayloadType, src1, port1.address);
+
+    packet_writer.write_packets(NumPackets, SamplesPerPacket, ChMask);
+    write_packets(relay, input, written);
+
+    for (size_t n = 0; n < NumDestinations; n++) {
+        check_forwarded(written, output[n], dst[n]);
+    }
+
+    UNSIGNED_LONGS_EQUAL(NumPackets, relay.stats().num_received);
+    UNSIGNED_LONGS_EQUAL(NumPackets * NumDestinations, relay.stats().num_forwarded);
+    UNSIGNED_LONGS_EQUAL(0, relay.stats().num_dropped);
+}
+
+TEST(relay, many_destinations_batch) {
+    Relay relay(config, format_map, packet_pool, allocator);
+
+    CHECK(relay.add_port(port1));
+
+    CountingQueue output[NumDestinations];
+    for (size_t n = 0; n < NumDestinations; n++) {
+        CHECK(relay.add_destination(port1.address, dst[n], output[n]));
+    }
+
+    packet::Queue input;
+    packet::Queue written;
+
+    PacketWriter packet_writer(allocator, input, rtp_composer, format_map, packet_pool,
+                               byte_buffer_pool, PayloadType, src1, port1.address);
+
+    packet_writer.write_packets(NumPackets, SamplesPerPacket, ChMask);
+
+    packet::PacketPtr packets[NumPackets];
+    for (size_t n = 0; n < NumPackets; n++) {
+        packets[n] = input.read();
+        CHECK(packets[n]);
+        written.write(packets[n]);
+    }
+
+    relay.write_many(packets, NumPackets);
+
+    for (size_t n = 0; n < NumDestinations; n++) {
+        // every destination gets the whole batch at once
+        UNSIGNED_LONGS_EQUAL(1, output[n].num_batches());
+        check_forwarded(written, output[n], dst[n]);
+    }
+
+    UNSIGNED_LONGS_EQUAL(NumPackets, relay.stats().num_received);
+    UNSIGNED_LONGS_EQUAL(NumPackets * NumDestinations, relay.stats().num_forwarded);
+    UNSIGNED_LONGS_EQUAL(0, relay.stats().num_dropped);
+}
+
+TEST(relay, two_ports) {
+    Relay relay(config, format_map, packet_pool, allocator);
+
+    CHECK(relay.add_port(port1));
+    CHECK(relay.add_port(port2));
+
+    packet::Queue output1;
+    CHECK(relay.add_destination(port1.address, dst[0], output1));
+
+    packet::Queue output2;
+    CHECK(relay.add_destination(port2.address, dst[1], output2));
+
+    packet::Queue input;
+    packet::Queue written1;
+    packet::Queue written2;
+
+    PacketWriter packet_writer1(allocator, input, rtp_composer, format_map, packet_pool,
+                                byte_buffer_pool, PayloadType, src1, port1.address);
+
+    PacketWriter packet_writer2(allocator, input, rtp_composer, format_map, packet_pool,
+                                byte_buffer_pool, PayloadType, src2, port2.address);
+
+    packet_writer1.write_packets(NumPackets, SamplesPerPacket, ChMask);
+    write_packets(relay, input, written1);
+
+    packet_writer2.write_packets(NumPackets, SamplesPerPacket, ChMask);
+    write_packets(relay, input, written2);
+
+    UNSIGNED_LONGS_EQUAL(2, relay.num_streams());
+
+    check_forwarded(written1, output1, dst[0]);
+    check_forwarded(written2, output2, dst[1]);
+}
+
+TEST(relay, duplicate_packets) {
+    Relay relay(config, format_map, packet_pool, allocator);
+
+    CHECK(relay.add_port(port1));
+
+    packet::Queue output;
+    CHECK(relay.add_destination(port1.address, dst[0], output));
+
+    packet::Queue input;
+    packet::Queue written;
+    packet::Queue ignored;
+
+    PacketWriter packet_writer(allocator, input, rtp_composer, format_map, packet_pool,
+                               byte_buffer_pool, PayloadType, src1, port1.address);
+
+    packet_writer.write_packets(NumPackets, SamplesPerPacket, ChMask);
+    write_packets(relay, input, written);
+
+    packet_writer.set_seqnum(packet::seqnum_t(packet_writer.seqnum() - 1));
+    packet_writer.write_packets(1, SamplesPerPacket, ChMask);
+    write_packets(relay, input, ignored);
+
+    check_forwarded(written, output, dst[0]);
+
+    UNSIGNED_LONGS_EQUAL(NumPackets + 1, relay.stats().num_received);
+    UNSIGNED_LONGS_EQUAL(NumPackets, relay.stats().num_forwarded);
+    UNSIGNED_LONGS_EQUAL(1, relay.stats().num_dropped);
+}
+
+TEST(relay, duplicate_reordered_packets) {
+    Relay relay(config, format_map, packet_pool, allocator);
+
+    CHECK(relay.add_port(port1));
+
+    packet::Queue output;
+    CHECK(relay.add_destination(port1.address, dst[0], output));
+
+    packet::Queue input;
+    packet::Queue written;
+    packet::Queue ignored;
+
+    PacketWriter packet_writer(allocator, input, rtp_composer, format_map, packet_pool,
+                               byte_buffer_pool, PayloadType, src1, port1.address);
+
+    const packet::seqnum_t first_seqnum = packet_writer.seqnum();
+
+    // skip one packet, it arrives after the next ones
+    packet_writer.set_seqnum(packet::seqnum_t(first_seqnum + 1));
+    packet_writer.write_packets(NumPackets, SamplesPerPacket, ChMask);
+    write_packets(relay, input, written);
+
+    packet_writer.set_seqnum(first_seqnum);
+    packet_writer.write_packets(1, SamplesPerPacket, ChMask);
+    write_packets(relay, input, written);
+
+    // all packets are duplicates now, including older ones
+    packet_writer.set_seqnum(first_seqnum);
+    packet_writer.write_packets(NumPackets + 1, SamplesPerPacket, ChMask);
+    write_packets(relay, input, ignored);
+
+    check_forwarded(written, output, dst[0]);
+
+    UNSIGNED_LONGS_EQUAL(NumPackets * 2 + 2, relay.stats().num_received);
+    UNSIGNED_LONGS_EQUAL(NumPackets + 1, relay.stats().num_forwarded);
+    UNSIGNED_LONGS_EQUAL(NumPackets + 1, relay.stats().num_dropped);
+}
+
+TEST(relay, seqnum_jump) {
+    Relay relay(config, format_map, packet_pool, allocator);
+
+    CHECK(relay.add_port(port1));
+
+    packet::Queue output;
+    CHECK(relay.add_destination(port1.address, dst[0], output));
+
+    packet::Queue input;
+    packet::Queue written;
+    packet::Queue ignored;
+
+    PacketWriter packet_writer(allocator, input, rtp_composer, format_map, packet_pool,
+                               byte_buffer_pool, PayloadType, src1, port1.address);
+
+    packet_writer.write_packets(NumPackets, SamplesPerPacket, ChMask);
+    write_packets(relay, input, written);
+
+    packet_writer.set_seqnum(packet::seqnum_t(packet_writer.seqnum() + MaxSnJump));
+    packet_writer.write_packets(NumPackets, SamplesPerPacket, ChMask);
+    write_packets(relay, input, ignored);
+
+    check_forwarded(written, output, dst[0]);
+
+    UNSIGNED_LONGS_EQUAL(NumPackets, relay.stats().num_dropped);
+}
+
+TEST(relay, source_change) {
+    Relay relay(config, format_map, packet_pool, allocator);
+
+    CHECK(relay.add_port(port1));
+
+    packet::Queue output;
+    CHECK(relay.add_destination(port1.address, dst[0], output));
+
+    packet::Queue input;
+    packet::Queue written;
+
+    PacketWriter packet_writer(allocator, input, rtp_composer, format_map, packet_pool,
+                               byte_buffer_pool, PayloadType, src1, port1.address);
+
+    packet_writer.write_packets(NumPackets, SamplesPerPacket, ChMask);
+    write_packets(relay, input, written);
+
+    // a new stream from the same address may start from any seqnum
+    packet_writer.set_source(1);
+    packet_writer.set_seqnum(packet::seqnum_t(packet_writer.seqnum() + MaxSnJump * 2));
+    packet_writer.write_packets(NumPackets, SamplesPerPacket, ChMask);
+    write_packets(relay, input, written);
+
+    UNSIGNED_LONGS_EQUAL(1, relay.num_streams());
+
+    check_forwarded(written, output, dst[0]);
+
+    UNSIGNED_LONGS_EQUAL(0, relay.stats().num_dropped);
+}
+
+} // namespace pipeline
+} // namespace roc
@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/heap_allocator.h"
+#include "roc_packet/packet_pool.h"
+#include "roc_packet/queue.h"
+#include "roc_rtp/jitter_meter.h"
+
+namespace roc {
+namespace rtp {
+
+namespace {
+
+enum { Src1 = 55, Src2 = 77, SampleRate = 10000, PacketSamples = 100 };
+
+const core::nanoseconds_t PacketDuration = PacketSamples * core::Second / SampleRate;
+
+const core::nanoseconds_t BaseTime = 1000 * core::Second;
+
+core::HeapAllocator allocator;
+packet::PacketPool pool(allocator, true);
+
+packet::PacketPtr new_packet(packet::source_t src,
+                             packet::timestamp_t ts,
+                             core::nanoseconds_t arrival) {
+    packet::PacketPtr packet = new (pool) packet::Packet(pool);
+    CHECK(packet);
+
+    packet->add_flags(packet::Packet::FlagUDP | packet::Packet::FlagRTP);
+    packet->rtp()->source = src;
+    packet->rtp()->timestamp = ts;
+    packet->udp()->receive_timestamp = arrival;
+
+    return packet;
+}
+
+} // namespace
+
+TEST_GROUP(jitter_meter) {};
+
+TEST(jitter_meter, pass_through) {
+    packet::Queue queue;
+    JitterMeter meter(queue, SampleRate);
+
+    packet::PacketPtr p1 = new_packet(Src1, 0, BaseTime);
+    packet::PacketPtr p2 = new_packet(Src1, PacketSamples, 0);
+    packet::PacketPtr p3 = new_packet(Src1, PacketSamples * 2, BaseTime);
+
+    packet::PacketPtr packets[] = { p2, p3 };
+
+    meter.write(p1);
+    meter.write_many(packets, 2);
+
+    CHECK(queue.read() == p1);
+    CHECK(queue.read() == p2);
+    CHECK(queue.read() == p3);
+    CHECK(!queue.read());
+}
+
+TEST(jitter_meter, no_jitter) {
+    packet::Queue queue;
+    JitterMeter meter(queue, SampleRate);
+
+    for (size_t n = 0; n < 100; n++) {
+        meter.write(new_packet(Src1, packet::timestamp_t(n * PacketSamples),
+                               BaseTime + core::nanoseconds_t(n) * PacketDuration));
+    }
+
+    LONGS_EQUAL(0, meter.jitter());
+}
+
+TEST(jitter_meter, constant_delay) {
+    packet::Queue queue;
+    JitterMeter meter(queue, SampleRate);
+
+    // delay is large but constant, so there is no jitter
+    for (size_t n = 0; n < 100; n++) {
+        meter.write(new_packet(Src1, packet::timestamp_t(n * PacketSamples),
+                               BaseTime + core::Second
+                                   + core::nanoseconds_t(n) * PacketDuration));
+    }
+
+    LONGS_EQUAL(0, meter.jitter());
+}
+
+TEST(jitter_meter, alternating_delay) {
+    packet::Queue queue;
+    JitterMeter meter(queue, SampleRate);
+
+    const core::nanoseconds_t Delay = core::Millisecond;
+
+    // every transit time differs from the previous one by Delay, so the
+    // estimation converges to Delay
+    for (size_t n = 0; n < 1000; n++) {
+        meter.write(new_packet(Src1, packet::timestamp_t(n * PacketSamples),
+                               BaseTime + core::nanoseconds_t(n) * PacketDuration
+                                   + (n % 2 == 0 ? 0 : Delay)));
+    }
+
+    CHECK(meter.jitter() > Delay * 99 / 100);
+    CHECK(meter.jitter() <= Delay);
+}
+
+TEST(jitter_meter, first_step) {
+    packet::Queue queue;
+    JitterMeter meter(queue, SampleRate);
+
+    const core::nanoseconds_t Delay = 16 * core::Millisecond;
+
+    meter.write(new_packet(Src1, 0, BaseTime));
+    LONGS_EQUAL(0, meter.jitter());
+
+    meter.write(new_packet(Src1, PacketSamples, BaseTime + PacketDuration + Delay));
+    LONGS_EQUAL(Delay / 16, meter.jitter());
+}
+
+TEST(jitter_meter, no_timestamp) {
+    packet::Queue queue;
+    JitterMeter meter(queue, SampleRate);
+
+    meter.write(new_packet(Src1, 0, BaseTime));
+    meter.write(new_packet(Src1, PacketSamples, 0));
+    meter.write(new_packet(Src1, PacketSamples * 2, 0));
+
+    LONGS_EQUAL(0, meter.jitter());
+
+    meter.write(new_packet(Src1, PacketSamples * 3, BaseTime + PacketDuration * 3));
+
+    LONGS_EQUAL(0, meter.jitter());
+}
+
+TEST(jitter_meter, source_change) {
+    packet::Queue queue;
+    JitterMeter meter(queue, SampleRate);
+
+    meter.write(new_packet(Src1, 0, BaseTime));
+    meter.write(new_packet(Src2, 12345, BaseTime + PacketDuration * 10));
+
+    LONGS_EQUAL(0, meter.jitter());
+
+    meter.write(
+        new_packet(Src2, 12345 + PacketSamples, BaseTime + PacketDuration * 11));
+
+    LONGS_EQUAL(0, meter.jitter());
+}
+
+TEST(jitter_meter, reset) {
+    packet::Queue queue;
+    JitterMeter meter(queue, SampleRate);
+
+    const core::nanoseconds_t Delay = 16 * core::Millisecond;
+
+    meter.write(new_packet(Src1, 0, BaseTime));
+    meter.write(new_packet(Src1, PacketSamples, BaseTime + PacketDuration + Delay));
+
+    CHECK(meter.jitter() != 0);
+
+    meter.reset();
+
+    LONGS_EQUAL(0, meter.jitter());
+
+    meter.write(new_packet(Src1, PacketSamples * 2, BaseTime + Delay * 10));
+
+    LONGS_EQUAL(0, meter.jitter());
+}
+
+} // namespace rtp
+} // namespace roc
@@ -295,5 +295,33 @@ TEST(validator, timestamp_late) {
     CHECK(!queue.read());
 }
 
+TEST(validator, read_many) {
+    packet::Queue queue;
+    Validator validator(queue, config, SampleRate);
+
+    packet::PacketPtr p1 = new_packet(Pt1, Src1, 1, 1);
+    packet::PacketPtr p2 = new_packet(Pt2, Src1, 2, 2);
+    packet::PacketPtr p3 = new_packet(Pt1, Src1, 3, 3);
+    packet::PacketPtr p4 = new_packet(Pt1, Src2, 4, 4);
+    packet::PacketPtr p5 = new_packet(Pt1, Src1, 5, 5);
+
+    queue.write(p1);
+    queue.write(p2);
+    queue.write(p3);
+    queue.write(p4);
+    queue.write(p5);
+
+    packet::PacketPtr packets[5];
+    UNSIGNED_LONGS_EQUAL(3, validator.read_many(packets, 5));
+
+    CHECK(packets[0] == p1);
+    CHECK(packets[1] == p3);
+    CHECK(packets[2] == p5);
+    CHECK(!packets[3]);
+    CHECK(!packets[4]);
+
+    UNSIGNED_LONGS_EQUAL(0, validator.read_many(packets, 5));
+}
+
 } // namespace rtp
 } // namespace roc
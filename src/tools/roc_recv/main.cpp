@@ -14,6 +14,7 @@
 #include "roc_core/scoped_destructor.h"
 #include "roc_core/unique_ptr.h"
 #include "roc_netio/transceiver.h"
+#include "roc_packet/jitter_queue.h"
 #include "roc_pipeline/parse_port.h"
 #include "roc_pipeline/receiver.h"
 #include "roc_sndio/backend_dispatcher.h"
@@ -58,6 +59,26 @@ int main(int argc, char** argv) {
         config.common.internal_frame_size = (size_t)args.frame_size_arg;
     }
 
+    netio::TransceiverConfig trx_config;
+
+    if (args.net_threads_given) {
+        if (args.net_threads_arg <= 0) {
+            roc_log(LogError, "invalid --net-threads: should be > 0");
+            return 1;
+        }
+        trx_config.num_loops = (size_t)args.net_threads_arg;
+    }
+
+    if (args.net_shards_given) {
+        if (args.net_shards_arg <= 0) {
+            roc_log(LogError, "invalid --net-shards: should be > 0");
+            return 1;
+        }
+        trx_config.num_receiver_shards = (size_t)args.net_shards_arg;
+    }
+
+    trx_config.receive_timestamps = args.net_timestamps_flag;
+
     sndio::BackendDispatcher::instance().set_frame_size(
         config.common.internal_frame_size);
 
@@ -182,10 +203,39 @@ int main(int argc, char** argv) {
 
     config.common.poisoning = args.poisoning_flag;
     config.common.beeping = args.beeping_flag;
+    config.common.route_on_write = args.net_routing_flag;
+
+    if (args.queue_limit_given) {
+        if (args.queue_limit_arg < 0) {
+            roc_log(LogError, "invalid --queue-limit: should be >= 0");
+            return 1;
+        }
+        config.common.max_queued_packets = (size_t)args.queue_limit_arg;
+    }
+
+    if (args.jitter_queue_given) {
+        if (args.jitter_queue_arg <= 0
+            || !packet::JitterQueue::valid_capacity((size_t)args.jitter_queue_arg)) {
+            roc_log(LogError, "invalid --jitter-queue: should be a power of two"
+                              " not greater than %lu",
+                    (unsigned long)packet::JitterQueue::MaxCapacity);
+            return 1;
+        }
+        config.default_session.jitter_queue_size = (size_t)args.jitter_queue_arg;
+    }
+
+    if (args.repair_queue_given) {
+        if (args.repair_queue_arg < 0) {
+            roc_log(LogError, "invalid --repair-queue: should be >= 0");
+            return 1;
+        }
+        config.default_session.repair_queue_size = (size_t)args.repair_queue_arg;
+    }
 
     core::HeapAllocator allocator;
-    core::BufferPool<uint8_t> byte_buffer_pool(allocator, max_packet_size,
-                                               args.poisoning_flag);
+    core::BufferPool<uint8_t> byte_buffer_pool(
+        allocator, max_packet_size + netio::Transceiver::buffer_overhead(),
+        args.poisoning_flag);
     core::BufferPool<audio::sample_t> sample_buffer_pool(
         allocator, config.common.internal_frame_size, args.poisoning_flag);
     packet::PacketPool packet_pool(allocator, args.poisoning_flag);
@@ -228,7 +278,8 @@ int main(int argc, char** argv) {
         return 1;
     }
 
-    netio::Transceiver trx(packet_pool, byte_buffer_pool, allocator);
+    netio::Transceiver trx(trx_config, packet_pool, byte_buffer_pool, allocator,
+                           &sample_buffer_pool);
     if (!trx.valid()) {
         roc_log(LogError, "can't create network transceiver");
         return 1;
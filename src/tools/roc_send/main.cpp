@@ -189,7 +189,11 @@ int main(int argc, char** argv) {
     fec::CodecMap codec_map;
     rtp::FormatMap format_map;
 
-    netio::Transceiver trx(packet_pool, byte_buffer_pool, allocator);
+    netio::TransceiverConfig trx_config;
+    trx_config.direct_send = args.direct_send_flag;
+
+    netio::Transceiver trx(trx_config, packet_pool, byte_buffer_pool, allocator,
+                           &sample_buffer_pool);
     if (!trx.valid()) {
         roc_log(LogError, "can't create network transceiver");
         return 1;